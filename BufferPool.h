@@ -0,0 +1,84 @@
+/**
+ * @file BufferPool.h
+ * @author Jan Wielgus
+ * @brief Fixed-block memory pool for AutoDataBuffer.
+ * @date 2026-10-19
+ */
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include "DataBuffer.h"
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Allocator of BlocksAmount blocks of BlockSize bytes each
+     * (storage is inside this object, allocation and deallocation take constant time).
+     * Bigger requests and requests made when all blocks are used
+     * are allocated by new[] (see getHeapAllocationsAmount()).
+     * Not thread-safe, use one pool per thread.
+     * @tparam BlockSize Size of one block in bytes (max size of pooled buffer).
+     * @tparam BlocksAmount Amount of blocks.
+     */
+    template <const size_t BlockSize, const size_t BlocksAmount>
+    class BufferPool : public IBufferAllocator
+    {
+        static_assert(BlockSize > 0 && BlocksAmount > 0, "Pool has to have at least one block");
+
+        uint8_t storage[BlocksAmount][BlockSize];
+        uint8_t* freeBlocks[BlocksAmount]; // stack of unused blocks
+        size_t freeBlocksAmount;
+
+        // statistics
+        uint32_t heapAllocations = 0;
+
+    public:
+        BufferPool()
+            : freeBlocksAmount(BlocksAmount)
+        {
+            for (size_t i = 0; i < BlocksAmount; ++i)
+                freeBlocks[i] = storage[BlocksAmount - 1 - i]; // first block is on the top
+        }
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        uint8_t* allocate(size_t size) override
+        {
+            if (size <= BlockSize && freeBlocksAmount > 0)
+                return freeBlocks[--freeBlocksAmount];
+
+            heapAllocations++;
+            return new uint8_t[size];
+        }
+
+        void deallocate(uint8_t* buffer, size_t size) override
+        {
+            (void)size;
+            if (isFromPool(buffer))
+                freeBlocks[freeBlocksAmount++] = buffer;
+            else
+                delete[] buffer;
+        }
+
+        size_t getFreeBlocksAmount() const { return freeBlocksAmount; }
+        uint32_t getHeapAllocationsAmount() const { return heapAllocations; }
+
+
+    private:
+        bool isFromPool(const uint8_t* buffer) const
+        {
+            // compared as integers, pointers to different arrays are not comparable
+            uintptr_t address = (uintptr_t)buffer;
+            uintptr_t begin = (uintptr_t)storage;
+            return address >= begin && address < begin + sizeof(storage);
+        }
+    };
+}
+
+
+#endif
@@ -7,6 +7,8 @@
 #ifndef _DATABUFFER_h
 #define _DATABUFFER_h
 
+#include "PacketCommConfig.h"
+#include <stdint.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -61,17 +63,138 @@ namespace PacketComm
 		}
 	};
 
+	/**
+	 * @brief Frame (data) placed inside a bigger buffer with free space before it (headroom)
+	 * and after it (tailroom). Each layer can add its headers and trailers in place
+	 * (pushFront(), pushBack()) without copying the frame to a bigger buffer.
+	 * This class don't make any allocation, it only points to the storage.
+	 */
+	class FrameBuffer
+	{
+		uint8_t* storage;
+		size_t capacity;
+		size_t begin; // index of the first byte of the frame in the storage
+		size_t size;
+
+	public:
+		/**
+		 * @brief Creates empty frame.
+		 * @param storage Buffer where the frame is placed.
+		 * @param capacity Size of the storage.
+		 * @param headroom Amount of bytes reserved before the frame (at most capacity).
+		 */
+		FrameBuffer(uint8_t* storage, size_t capacity, size_t headroom)
+			: storage(storage), capacity(capacity), begin(headroom <= capacity ? headroom : capacity), size(0)
+		{
+		}
+
+		uint8_t* getData() const { return storage + begin; }
+		size_t getSize() const { return size; }
+		size_t getHeadroom() const { return begin; }
+		size_t getTailroom() const { return capacity - begin - size; }
+
+		/**
+		 * @brief Extend the frame at the beginning (eg. to add a header).
+		 * @param bytes Amount of added bytes.
+		 * @return Pointer to the added bytes (new beginning of the frame)
+		 * or nullptr if there is not enough headroom.
+		 */
+		uint8_t* pushFront(size_t bytes)
+		{
+			if (bytes > begin)
+				return nullptr;
+			begin -= bytes;
+			size += bytes;
+			return storage + begin;
+		}
+
+		/**
+		 * @brief Extend the frame at the end (eg. to add payload or a trailer).
+		 * @param bytes Amount of added bytes.
+		 * @return Pointer to the added bytes or nullptr if there is not enough tailroom.
+		 */
+		uint8_t* pushBack(size_t bytes)
+		{
+			if (bytes > getTailroom())
+				return nullptr;
+			uint8_t* added = storage + begin + size;
+			size += bytes;
+			return added;
+		}
+
+		/**
+		 * @brief Remove bytes from the beginning of the frame (they become headroom).
+		 * @return false if frame is smaller than bytes.
+		 */
+		bool popFront(size_t bytes)
+		{
+			if (bytes > size)
+				return false;
+			begin += bytes;
+			size -= bytes;
+			return true;
+		}
+
+		/**
+		 * @brief Remove bytes from the end of the frame (they become tailroom).
+		 * @return false if frame is smaller than bytes.
+		 */
+		bool popBack(size_t bytes)
+		{
+			if (bytes > size)
+				return false;
+			size -= bytes;
+			return true;
+		}
+
+		/**
+		 * @brief Converts the frame (without headroom and tailroom) to DataBuffer.
+		 */
+		DataBuffer toDataBuffer() const
+		{
+			return DataBuffer(getData(), size);
+		}
+	};
+
+	/**
+	 * @brief Interface of memory allocators that can be used by AutoDataBuffer
+	 * instead of new[] and delete[] (eg. BufferPool).
+	 */
+	class IBufferAllocator
+	{
+	public:
+		virtual ~IBufferAllocator() {}
+
+		/**
+		 * @param size Amount of bytes to allocate (greater than 0).
+		 * @return Pointer to at least size bytes or nullptr if memory is not available.
+		 */
+		virtual uint8_t* allocate(size_t size) = 0;
+
+		/**
+		 * @param buffer Pointer returned by allocate() of this allocator.
+		 * @param size The same size that was passed to allocate().
+		 */
+		virtual void deallocate(uint8_t* buffer, size_t size) = 0;
+	};
+
 	/**
 	 * @brief This class is DataBuffer with built-in dynamic memory allocation.
 	 * Allocated memory size can be changed later (using ensureAllocatedSize() or
 	 * setAllocatedSize() methods). size variable store used size of the buffer
 	 * (real size if inside AllocatedSize variable). This enables zero cost buffer size changing.
 	 * Remember to set size variable (size is 0 by default)!
+	 * Buffers up to PACKETCOMM_INLINE_BUFFER_SIZE bytes are stored inside the object,
+	 * bigger ones are allocated by the allocator (new[] if not set).
 	 * Can be used as DataBuffer by using toDataBuffer() method.
 	 */
 	class AutoDataBuffer : private DataBuffer
 	{
+		static const size_t InlineSize = PACKETCOMM_INLINE_BUFFER_SIZE;
+
 		size_t allocatedSize = 0; // size of the allocated buffer array
+		IBufferAllocator* allocator; // nullptr - new[] and delete[]
+		uint8_t inlineStorage[InlineSize > 0 ? InlineSize : 1];
 
 	public:
 		using DataBuffer::buffer;
@@ -82,56 +205,51 @@ namespace PacketComm
 		 * @brief Ctor. Creates new buffer with size = 0 and
 		 * AllocatedSize = bytesToAllocate.
 		 * @param bytesToAllocate Size of the allocated memory.
+		 * @param allocator (optional) Allocator used for buffers that don't fit
+		 * the inline storage. Have to outlive this buffer.
 		 */
-		explicit AutoDataBuffer(size_t bytesToAllocate)
-			: AllocatedSize(allocatedSize)
+		explicit AutoDataBuffer(size_t bytesToAllocate, IBufferAllocator* allocator = nullptr)
+			: allocator(allocator), AllocatedSize(allocatedSize)
 		{
-			buffer = new uint8_t[bytesToAllocate];
-			allocatedSize = bytesToAllocate;
+			buffer = allocateStorage(bytesToAllocate);
+			allocatedSize = buffer != nullptr ? bytesToAllocate : 0;
 			size = 0;
 		}
 
 		/**
-		 * @brief Copy ctor. Allocate buffer of the same size as other and copy
-		 * only data indicated by size.
+		 * @brief Copy ctor. Allocate buffer of the size of used part of other
+		 * (with the same allocator) and copy only data indicated by size.
 		 * @param other Reference to AutoDataBuffer to be copied.
 		 */
 		AutoDataBuffer(const AutoDataBuffer& other)
-			: AllocatedSize(allocatedSize)
+			: DataBuffer(), allocator(other.allocator), AllocatedSize(allocatedSize)
 		{
-			buffer = new uint8_t[other.allocatedSize];
-			allocatedSize = other.allocatedSize;
-
-			for (size_t i = 0; i < other.size; i++) // copy only used part
-				buffer[i] = other.buffer[i];
+			buffer = allocateStorage(other.size);
+			allocatedSize = buffer != nullptr ? other.size : 0;
+			size = allocatedSize;
 
-			size = other.size;
+			if (size > 0)
+				memcpy(buffer, other.buffer, size); // copy only used part
 		}
 
 		/**
 		 * @brief Moving ctor.
 		 */
 		AutoDataBuffer(AutoDataBuffer&& toMove) noexcept
-			: AllocatedSize(allocatedSize)
+			: DataBuffer(), allocator(toMove.allocator), AllocatedSize(allocatedSize)
 		{
-			buffer = toMove.buffer;
-			size = toMove.size;
-			allocatedSize = toMove.allocatedSize;
-
-			toMove.buffer = nullptr;
-			toMove.size = 0;
-			toMove.allocatedSize = 0;
+			takeStorage(toMove);
 		}
 
 		~AutoDataBuffer()
 		{
-			delete[] buffer;
+			releaseStorage();
 		}
 
 		/**
-		 * @brief Assignment operator. Deletes current allocated buffer.
-		 * Then allocate buffer of the same size as other and copy only
-		 * data indicated by size.
+		 * @brief Assignment operator. Reuses current buffer if it is big enough
+		 * for used part of other, otherwise allocates buffer of that size.
+		 * Then copy only data indicated by size.
 		 * @param other Reference to AutoData buffer to be assigned.
 		 * @return Refernce to this object.
 		 */
@@ -139,17 +257,16 @@ namespace PacketComm
 		{
 			if (this != &other)
 			{
-				if (allocatedSize != other.allocatedSize)
+				if (allocatedSize < other.size || buffer == nullptr)
 				{
-					delete[] buffer;
-					buffer = new uint8_t[other.allocatedSize];
-					allocatedSize = other.allocatedSize;
+					releaseStorage();
+					buffer = allocateStorage(other.size);
+					allocatedSize = buffer != nullptr ? other.size : 0;
 				}
 
-				for (size_t i = 0; i < other.size; i++)
-					buffer[i] = other.buffer[i];
-
-				size = other.size;
+				size = other.size <= allocatedSize ? other.size : 0;
+				if (size > 0)
+					memcpy(buffer, other.buffer, size);
 			}
 
 			return *this;
@@ -162,15 +279,9 @@ namespace PacketComm
 		{
 			if (this != &toMove)
 			{
-				delete[] buffer;
-
-				buffer = toMove.buffer;
-				size = toMove.size;
-				allocatedSize = toMove.allocatedSize;
-
-				toMove.buffer = nullptr;
-				toMove.size = 0;
-				toMove.allocatedSize = 0;
+				releaseStorage();
+				allocator = toMove.allocator;
+				takeStorage(toMove);
 			}
 
 			return *this;
@@ -181,26 +292,26 @@ namespace PacketComm
 		 * Do not copy old buffer.
 		 * @param newAllocatedSize New size of the allocated memory.
 		 * If 0 then buffer is nullptr.
+		 * @return false if memory could not be allocated (buffer is nullptr then).
 		 */
-		void setAllocatedSize(size_t newAllocatedSize)
+		bool setAllocatedSize(size_t newAllocatedSize)
 		{
-			if (allocatedSize == newAllocatedSize)
-				return;
+			if (allocatedSize == newAllocatedSize && buffer != nullptr)
+				return true;
 
-			delete[] buffer;
+			releaseStorage();
 
-			if (newAllocatedSize == 0)
+			buffer = newAllocatedSize > 0 ? allocateStorage(newAllocatedSize) : nullptr;
+			if (buffer == nullptr)
 			{
-				buffer = nullptr;
 				size = 0;
 				allocatedSize = 0;
+				return newAllocatedSize == 0;
 			}
-			else
-			{
-				buffer = new uint8_t[newAllocatedSize];
-				size = size > newAllocatedSize ? 0 : size;
-				allocatedSize = newAllocatedSize;
-			}
+
+			size = size > newAllocatedSize ? 0 : size;
+			allocatedSize = newAllocatedSize;
+			return true;
 		}
 
 		/**
@@ -209,21 +320,25 @@ namespace PacketComm
 		 * @param minSize Minimum required size of the allocated buffer.
 		 * @param copyData_flag Flag, if true then after allocating new buffer
 		 * old data will be copied. Otherwise data could be lost.
+		 * @return false if memory could not be allocated (old buffer is kept then).
 		 */
-		void ensureAllocatedSize(size_t minSize, bool copyData_flag = true)
+		bool ensureAllocatedSize(size_t minSize, bool copyData_flag = true)
 		{
-			if (allocatedSize >= minSize)
-				return;
+			if (allocatedSize >= minSize && buffer != nullptr)
+				return true;
 
-			uint8_t* newBuffer = new uint8_t[minSize];
+			uint8_t* newBuffer = allocateStorage(minSize);
+			if (newBuffer == nullptr)
+				return false;
 
-			if (copyData_flag)
-				for (size_t i = 0; i < size; i++)
-					newBuffer[i] = buffer[i];
+			if (copyData_flag && size > 0 && newBuffer != buffer)
+				memcpy(newBuffer, buffer, size);
 
-			delete[] buffer;
+			if (newBuffer != buffer)
+				releaseStorage();
 			buffer = newBuffer;
 			allocatedSize = minSize;
+			return true;
 		}
 
 		/**
@@ -233,6 +348,49 @@ namespace PacketComm
 		{
 			return *this;
 		}
+
+
+	private:
+		uint8_t* allocateStorage(size_t bytes)
+		{
+			if (bytes <= InlineSize)
+				return inlineStorage;
+			return allocator != nullptr ? allocator->allocate(bytes) : new uint8_t[bytes];
+		}
+
+		void releaseStorage()
+		{
+			if (buffer == nullptr || buffer == inlineStorage)
+				return;
+
+			if (allocator != nullptr)
+				allocator->deallocate(buffer, allocatedSize);
+			else
+				delete[] buffer;
+			buffer = nullptr;
+		}
+
+		/**
+		 * @brief Take buffer of toMove (this buffer has to be released and
+		 * allocator has to be the same as of toMove).
+		 */
+		void takeStorage(AutoDataBuffer& toMove)
+		{
+			if (toMove.buffer == toMove.inlineStorage)
+			{
+				memcpy(inlineStorage, toMove.inlineStorage, toMove.size);
+				buffer = inlineStorage;
+			}
+			else
+				buffer = toMove.buffer;
+
+			size = toMove.size;
+			allocatedSize = toMove.allocatedSize;
+
+			toMove.buffer = nullptr;
+			toMove.size = 0;
+			toMove.allocatedSize = 0;
+		}
 	};
 }
 
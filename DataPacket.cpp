@@ -38,3 +38,9 @@ void DataPacket::updateDataOnly(const uint8_t* inputBuffer)
 {
     memcpy(payload, inputBuffer, payloadSize);
 }
+
+
+DataBuffer DataPacket::getDataOnlyInPlace() const
+{
+    return DataBuffer(payload, payloadSize);
+}
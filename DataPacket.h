@@ -16,7 +16,7 @@ namespace PacketComm
 {
     class DataPacket : public Packet
     {
-        uint8_t* payload;
+        uint8_t* payload = nullptr;
         size_t payloadSize = 0;
 
     public:
@@ -33,6 +33,7 @@ namespace PacketComm
         size_t getDataOnly(uint8_t* outputBuffer) const override;
         size_t getDataOnlySize() const override;
         void updateDataOnly(const uint8_t* inputBuffer) override;
+        DataBuffer getDataOnlyInPlace() const override;
     };
 }
 
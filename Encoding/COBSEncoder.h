@@ -0,0 +1,82 @@
+/**
+ * @file COBSEncoder.h
+ * @author Jan Wielgus
+ * @brief Incremental COBS encoder. Data can be passed in many parts
+ * (eg. packet ID, payload and checksum) without joining them first.
+ * Output is the same as of COBS::encode() called for joined data.
+ * @date 2026-10-19
+ */
+
+#ifndef COBSENCODER_H
+#define COBSENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace PacketComm
+{
+    class COBSEncoder
+    {
+        uint8_t* destination;
+        size_t writeIndex = 1;
+        size_t codeIndex = 0;
+        uint8_t code = 1;
+
+    public:
+        /**
+         * @param destination Target buffer for the encoded bytes, minimum capacity
+         * is COBS::getEncodedBufferSize() of the total size of all parts.
+         */
+        explicit COBSEncoder(uint8_t* destination)
+            : destination(destination)
+        {
+        }
+
+        /**
+         * @brief Encode next part of the data.
+         */
+        void add(const uint8_t* source, size_t size)
+        {
+            for (size_t readIndex = 0; readIndex < size; ++readIndex)
+            {
+                if (source[readIndex] == 0)
+                {
+                    destination[codeIndex] = code;
+                    code = 1;
+                    codeIndex = writeIndex++;
+                }
+                else
+                {
+                    destination[writeIndex++] = source[readIndex];
+                    code++;
+
+                    if (code == 0xFF)
+                    {
+                        destination[codeIndex] = code;
+                        code = 1;
+                        codeIndex = writeIndex++;
+                    }
+                }
+            }
+        }
+
+        void add(uint8_t byte)
+        {
+            add(&byte, 1);
+        }
+
+        /**
+         * @brief Finish encoding (encoder can't be used after that).
+         * @return The number of bytes in the encoded buffer.
+         */
+        size_t finish()
+        {
+            destination[codeIndex] = code;
+            return writeIndex;
+        }
+    };
+}
+
+
+#endif
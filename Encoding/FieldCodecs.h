@@ -0,0 +1,216 @@
+/**
+ * @file FieldCodecs.h
+ * @author Jan Wielgus
+ * @brief Compact encodings of packet fields for slow links: bit-packed values,
+ * floats quantized to scaled integers and zig-zag varints
+ * (used by packets generated by extras/codegen/packetgen.py).
+ * @date 2026-10-19
+ */
+
+#ifndef FIELDCODECS_H
+#define FIELDCODECS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Values of 1..32 bits packed one after another (LSB first).
+     * Offsets and widths are usually constants, so the compiler can
+     * reduce each call to a few shifts.
+     */
+    class BitPacking
+    {
+    public:
+        static uint32_t getMaxValue(uint8_t bits)
+        {
+            return bits >= 32 ? 0xFFFFFFFF : ((uint32_t)1 << bits) - 1;
+        }
+
+        /**
+         * @brief Write bits lowest bits of value at bitOffset (other bits of the buffer are kept,
+         * so zero the buffer first to not send uninitialized padding bits).
+         */
+        static void write(uint8_t* buffer, size_t bitOffset, uint32_t value, uint8_t bits)
+        {
+            buffer += bitOffset >> 3;
+            uint8_t shift = bitOffset & 7;
+
+            while (bits > 0)
+            {
+                uint8_t amount = 8 - shift < bits ? 8 - shift : bits;
+                uint8_t mask = (uint8_t)(((1u << amount) - 1) << shift);
+                *buffer = (uint8_t)((*buffer & ~mask) | ((value << shift) & mask));
+
+                value >>= amount;
+                bits -= amount;
+                shift = 0;
+                buffer++;
+            }
+        }
+
+        static uint32_t read(const uint8_t* buffer, size_t bitOffset, uint8_t bits)
+        {
+            buffer += bitOffset >> 3;
+            uint8_t shift = bitOffset & 7;
+            uint32_t value = 0;
+            uint8_t position = 0;
+
+            while (position < bits)
+            {
+                uint8_t amount = 8 - shift < bits - position ? 8 - shift : bits - position;
+                value |= (uint32_t)((*buffer >> shift) & ((1u << amount) - 1)) << position;
+
+                position += amount;
+                shift = 0;
+                buffer++;
+            }
+
+            return value;
+        }
+
+        /**
+         * @brief Unsigned value saturated to bits width.
+         */
+        static void writeUnsigned(uint8_t* buffer, size_t bitOffset, uint32_t value, uint8_t bits)
+        {
+            uint32_t maxValue = getMaxValue(bits);
+            write(buffer, bitOffset, value > maxValue ? maxValue : value, bits);
+        }
+
+        /**
+         * @brief Signed value saturated to bits width (two's complement).
+         */
+        static void writeSigned(uint8_t* buffer, size_t bitOffset, int32_t value, uint8_t bits)
+        {
+            int32_t maxValue = (int32_t)(getMaxValue(bits - 1));
+            int32_t minValue = -maxValue - 1;
+            value = value > maxValue ? maxValue : (value < minValue ? minValue : value);
+            write(buffer, bitOffset, (uint32_t)value, bits);
+        }
+
+        static int32_t readSigned(const uint8_t* buffer, size_t bitOffset, uint8_t bits)
+        {
+            uint32_t value = read(buffer, bitOffset, bits);
+            uint32_t signBit = (uint32_t)1 << (bits - 1);
+            return (int32_t)((value ^ signBit) - signBit); // sign extension
+        }
+    };
+
+
+    /**
+     * @brief Float in range [min, max] stored as an unsigned integer of bits width
+     * (resolution is (max - min) / (2^bits - 1)). Values out of range are saturated.
+     */
+    class Quantization
+    {
+    public:
+        static uint32_t encode(float value, float min, float max, uint8_t bits)
+        {
+            uint32_t maxCode = BitPacking::getMaxValue(bits);
+            if (!(value > min)) // also NaN
+                return 0;
+            if (value >= max)
+                return maxCode;
+
+            return (uint32_t)((value - min) * (maxCode / (max - min)) + 0.5f);
+        }
+
+        static float decode(uint32_t code, float min, float max, uint8_t bits)
+        {
+            return min + code * ((max - min) / BitPacking::getMaxValue(bits));
+        }
+    };
+
+
+    /**
+     * @brief Maps signed integers to unsigned ones with small absolute values
+     * to small numbers (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...), so they have short varints.
+     */
+    class ZigZag
+    {
+    public:
+        static uint32_t encode(int32_t value)
+        {
+            return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+        }
+
+        static int32_t decode(uint32_t value)
+        {
+            return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+        }
+    };
+
+
+    /**
+     * @brief Unsigned integer in 1..5 bytes, 7 bits in each byte (LSB first),
+     * the highest bit is set if more bytes follow.
+     */
+    class Varint
+    {
+    public:
+        static const size_t MaxSize = 5;
+
+        static size_t getSize(uint32_t value)
+        {
+            size_t size = 1;
+            while (value >= 0x80)
+            {
+                value >>= 7;
+                size++;
+            }
+            return size;
+        }
+
+        /**
+         * @return Amount of written bytes.
+         */
+        static size_t write(uint8_t* buffer, uint32_t value)
+        {
+            size_t size = 0;
+            while (value >= 0x80)
+            {
+                buffer[size++] = (uint8_t)(value | 0x80);
+                value >>= 7;
+            }
+            buffer[size++] = (uint8_t)value;
+            return size;
+        }
+
+        /**
+         * @brief Read varint that was checked by getEncodedSize().
+         * @return Amount of read bytes.
+         */
+        static size_t read(const uint8_t* buffer, uint32_t& value)
+        {
+            value = 0;
+            size_t size = 0;
+            uint8_t byte;
+            do
+            {
+                byte = buffer[size];
+                value |= (uint32_t)(byte & 0x7F) << (7 * size);
+                size++;
+            } while ((byte & 0x80) && size < MaxSize);
+            return size;
+        }
+
+        /**
+         * @param buffer Buffer that starts with the varint.
+         * @param available Amount of bytes in the buffer.
+         * @return Size of the varint or 0 if it is not complete or too long.
+         */
+        static size_t getEncodedSize(const uint8_t* buffer, size_t available)
+        {
+            for (size_t size = 0; size < available && size < MaxSize; ++size)
+                if ((buffer[size] & 0x80) == 0)
+                    return size + 1;
+            return 0;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file LZ4.h
+ * @author Jan Wielgus
+ * @brief LZ4 block format compression with a small fixed work memory
+ * (hash table inside LZ4Compressor) and decompression without work memory
+ * (used by CompressionComm).
+ * @date 2026-10-19
+ */
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief LZ4 block format: sequences of literals and matches
+     * (token, literals, 2-byte offset, match length). Blocks are compatible
+     * with other LZ4 implementations (LZ4_decompress_safe()).
+     */
+    class LZ4
+    {
+    public:
+        static const size_t MaxInputSize = 0xFFFF; // positions are 16-bit
+        static const size_t MinMatch = 4;
+        static const size_t LastLiterals = 5; // last bytes of the block are always literals
+        static const size_t MatchStartLimit = 12; // last match starts at least this amount of bytes before the end
+
+        /**
+         * @return Max size of compressed block of data of size bytes (incompressible data).
+         */
+        static size_t getMaxCompressedSize(size_t size)
+        {
+            return size + size / 255 + 16;
+        }
+
+        /**
+         * @brief Decompress the block (invalid blocks are detected, no reads
+         * and writes out of buffers).
+         * @param input Compressed block.
+         * @param size Size of the compressed block.
+         * @param output Buffer for decompressed data.
+         * @param capacity Size of the output buffer.
+         * @return Size of decompressed data or 0 if the block is invalid or doesn't fit.
+         */
+        static size_t decompress(const uint8_t* input, size_t size, uint8_t* output, size_t capacity)
+        {
+            size_t in = 0;
+            size_t out = 0;
+
+            while (in < size)
+            {
+                uint8_t token = input[in++];
+
+                size_t literalLength = token >> 4;
+                if (literalLength == 15 && !readLength(input, size, in, literalLength))
+                    return 0;
+                if (literalLength > size - in || literalLength > capacity - out)
+                    return 0;
+
+                memcpy(output + out, input + in, literalLength);
+                in += literalLength;
+                out += literalLength;
+
+                if (in == size)
+                    break; // last sequence has only literals
+
+                if (size - in < 2)
+                    return 0;
+                size_t offset = input[in] | (size_t)input[in + 1] << 8;
+                in += 2;
+                if (offset == 0 || offset > out)
+                    return 0;
+
+                size_t matchLength = token & 15;
+                if (matchLength == 15 && !readLength(input, size, in, matchLength))
+                    return 0;
+                matchLength += MinMatch;
+                if (matchLength > capacity - out)
+                    return 0;
+
+                if (offset >= matchLength)
+                    memcpy(output + out, output + out - offset, matchLength);
+                else
+                {
+                    // overlapping match repeats the last offset bytes
+                    for (size_t i = 0; i < matchLength; ++i)
+                        output[out + i] = output[out + i - offset];
+                }
+                out += matchLength;
+            }
+
+            return out;
+        }
+
+
+    private:
+        static bool readLength(const uint8_t* input, size_t size, size_t& in, size_t& length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (in >= size)
+                    return false;
+                byte = input[in++];
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+    };
+
+
+
+    /**
+     * @brief LZ4 compressor (greedy matching, like LZ4 fast mode).
+     * Work memory is the hash table of 2^HashBits positions (2 bytes each).
+     * @tparam HashBits More bits find more matches, but the table is cleared
+     * before each block (eg. 8 bits - 512 B for MCUs, 12 bits - 8 KB).
+     */
+    template <const uint8_t HashBits = 10>
+    class LZ4Compressor
+    {
+        static_assert(HashBits >= 4 && HashBits <= 16, "HashBits has to be in range 4..16");
+
+        uint16_t hashTable[1 << HashBits];
+
+    public:
+        /**
+         * @brief Compress the block.
+         * @param input Data to compress (up to LZ4::MaxInputSize bytes).
+         * @param size Size of the data.
+         * @param output Buffer for the compressed block.
+         * @param capacity Size of the output buffer. Compression stops when the block
+         * doesn't fit (eg. capacity of size - 1 bytes to accept only blocks that are smaller).
+         * @return Size of the compressed block or 0 if it doesn't fit the output buffer.
+         */
+        size_t compress(const uint8_t* input, size_t size, uint8_t* output, size_t capacity)
+        {
+            if (size > LZ4::MaxInputSize)
+                return 0;
+
+            memset(hashTable, 0, sizeof(hashTable));
+
+            size_t out = 0;
+            size_t anchor = 0; // first byte that is not compressed yet
+            size_t position = 0;
+
+            while (position + LZ4::MatchStartLimit <= size)
+            {
+                uint32_t sequence = read32(input + position);
+                uint32_t hash = getHash(sequence);
+                size_t candidate = hashTable[hash];
+                hashTable[hash] = (uint16_t)position;
+
+                if (candidate >= position || read32(input + candidate) != sequence)
+                {
+                    position += 1 + ((position - anchor) >> 6); // faster through incompressible data
+                    continue;
+                }
+
+                // extend the match in both directions
+                while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1])
+                {
+                    position--;
+                    candidate--;
+                }
+
+                size_t matchLength = LZ4::MinMatch;
+                size_t matchEndLimit = size - LZ4::LastLiterals;
+                while (position + matchLength < matchEndLimit && input[position + matchLength] == input[candidate + matchLength])
+                    matchLength++;
+
+                if (!writeSequence(input + anchor, position - anchor, position - candidate, matchLength, output, capacity, out))
+                    return 0;
+
+                position += matchLength;
+                anchor = position;
+            }
+
+            // last literals
+            if (!writeSequence(input + anchor, size - anchor, 0, 0, output, capacity, out))
+                return 0;
+            return out;
+        }
+
+
+    private:
+        static uint32_t read32(const uint8_t* buffer)
+        {
+            uint32_t value;
+            memcpy(&value, buffer, sizeof(value));
+            return value;
+        }
+
+        static uint32_t getHash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HashBits);
+        }
+
+        /**
+         * @brief Write literals and the match (matchLength 0 - only literals).
+         * @return false if it doesn't fit the output buffer.
+         */
+        static bool writeSequence(const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength,
+                                  uint8_t* output, size_t capacity, size_t& out)
+        {
+            size_t extraMatchLength = matchLength > 0 ? matchLength - LZ4::MinMatch : 0;
+            size_t requiredSize = 1 + literalLength + literalLength / 255 + 1
+                + (matchLength > 0 ? 2 + extraMatchLength / 255 + 1 : 0);
+            if (requiredSize > capacity - out)
+                return false;
+
+            uint8_t& token = output[out++];
+            token = (uint8_t)((literalLength < 15 ? literalLength : 15) << 4);
+            if (literalLength >= 15)
+                writeLength(literalLength - 15, output, out);
+
+            if (literalLength > 0) // literals can be nullptr
+                memcpy(output + out, literals, literalLength);
+            out += literalLength;
+
+            if (matchLength == 0)
+                return true;
+
+            output[out++] = (uint8_t)offset;
+            output[out++] = (uint8_t)(offset >> 8);
+
+            token |= extraMatchLength < 15 ? extraMatchLength : 15;
+            if (extraMatchLength >= 15)
+                writeLength(extraMatchLength - 15, output, out);
+            return true;
+        }
+
+        static void writeLength(size_t length, uint8_t* output, size_t& out)
+        {
+            while (length >= 255)
+            {
+                output[out++] = 255;
+                length -= 255;
+            }
+            output[out++] = (uint8_t)length;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file LittleEndian.h
+ * @author Jan Wielgus
+ * @brief Little-endian reading and writing of packet fields, independent of
+ * the platform endianness and struct layout (used by packets generated
+ * by extras/codegen/packetgen.py).
+ * @date 2026-10-19
+ */
+
+#ifndef LITTLEENDIAN_H
+#define LITTLEENDIAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+
+namespace PacketComm
+{
+    class LittleEndian
+    {
+    public:
+        static_assert(sizeof(float) == 4, "float fields require 32-bit IEEE 754 float");
+
+        static void writeUInt8(uint8_t* buffer, uint8_t value)
+        {
+            buffer[0] = value;
+        }
+
+        static void writeUInt16(uint8_t* buffer, uint16_t value)
+        {
+            buffer[0] = (uint8_t)value;
+            buffer[1] = (uint8_t)(value >> 8);
+        }
+
+        static void writeUInt32(uint8_t* buffer, uint32_t value)
+        {
+            buffer[0] = (uint8_t)value;
+            buffer[1] = (uint8_t)(value >> 8);
+            buffer[2] = (uint8_t)(value >> 16);
+            buffer[3] = (uint8_t)(value >> 24);
+        }
+
+        static void writeUInt64(uint8_t* buffer, uint64_t value)
+        {
+            writeUInt32(buffer, (uint32_t)value);
+            writeUInt32(buffer + 4, (uint32_t)(value >> 32));
+        }
+
+        static void writeInt8(uint8_t* buffer, int8_t value) { writeUInt8(buffer, (uint8_t)value); }
+        static void writeInt16(uint8_t* buffer, int16_t value) { writeUInt16(buffer, (uint16_t)value); }
+        static void writeInt32(uint8_t* buffer, int32_t value) { writeUInt32(buffer, (uint32_t)value); }
+        static void writeInt64(uint8_t* buffer, int64_t value) { writeUInt64(buffer, (uint64_t)value); }
+        static void writeBool(uint8_t* buffer, bool value) { writeUInt8(buffer, value ? 1 : 0); }
+
+        static void writeFloat(uint8_t* buffer, float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            writeUInt32(buffer, bits);
+        }
+
+
+        static uint8_t readUInt8(const uint8_t* buffer)
+        {
+            return buffer[0];
+        }
+
+        static uint16_t readUInt16(const uint8_t* buffer)
+        {
+            return (uint16_t)(buffer[0] | (uint16_t)buffer[1] << 8);
+        }
+
+        static uint32_t readUInt32(const uint8_t* buffer)
+        {
+            return (uint32_t)buffer[0] | (uint32_t)buffer[1] << 8 | (uint32_t)buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+        }
+
+        static uint64_t readUInt64(const uint8_t* buffer)
+        {
+            return (uint64_t)readUInt32(buffer) | (uint64_t)readUInt32(buffer + 4) << 32;
+        }
+
+        static int8_t readInt8(const uint8_t* buffer) { return (int8_t)readUInt8(buffer); }
+        static int16_t readInt16(const uint8_t* buffer) { return (int16_t)readUInt16(buffer); }
+        static int32_t readInt32(const uint8_t* buffer) { return (int32_t)readUInt32(buffer); }
+        static int64_t readInt64(const uint8_t* buffer) { return (int64_t)readUInt64(buffer); }
+        static bool readBool(const uint8_t* buffer) { return readUInt8(buffer) != 0; }
+
+        static float readFloat(const uint8_t* buffer)
+        {
+            uint32_t bits = readUInt32(buffer);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+}
+
+
+#endif
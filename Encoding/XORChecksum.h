@@ -0,0 +1,55 @@
+/**
+ * @file XORChecksum.h
+ * @author Jan Wielgus
+ * @brief One byte checksum that is added at the end
+ * of each frame by StreamComm (before encoding).
+ * @date 2026-10-19
+ */
+
+#ifndef XORCHECKSUM_H
+#define XORCHECKSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace PacketComm
+{
+    class XORChecksum
+    {
+    public:
+        /**
+         * @brief Calculate the checksum for passed data buffer.
+         * @param buffer pointer to the array with data (only data).
+         * @param size size of the array with data (at least 1).
+         * @return checksum for the passed data buffer.
+         */
+        static uint8_t calculate(const uint8_t* buffer, size_t size)
+        {
+            uint8_t checksum = buffer[0];
+            for (size_t i = 1; i < size; i++)
+                checksum ^= buffer[i]; // xor'owanie kolejnych bajtow
+
+            return checksum;
+        }
+
+        /**
+         * @brief Check if passed buffer checksum is correct.
+         * @param buffer pointer to the array of data (only data).
+         * @param size size of the array with data (amount of bytes).
+         * @param expectedChecksum checksum that that array should have.
+         * @return true if array has the same checksum as checksum in parameter,
+         * false otherwise.
+         */
+        static bool check(const uint8_t* buffer, size_t size, uint8_t expectedChecksum)
+        {
+            if (size == 0)
+                return false;
+
+            return calculate(buffer, size) == expectedChecksum;
+        }
+    };
+}
+
+
+#endif
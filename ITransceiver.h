@@ -10,7 +10,12 @@
 #ifndef ITRANSCEIVER_H
 #define ITRANSCEIVER_H
 
+#include "PacketCommConfig.h"
 #include "DataBuffer.h"
+#include "SharedFrame.h"
+#if PACKETCOMM_LATENCY_TRACING
+    #include "LatencyTracer.h"
+#endif
 
 
 namespace PacketComm
@@ -55,6 +60,145 @@ namespace PacketComm
         {
             return send(buffer.buffer, buffer.size);
         }
+
+        /**
+         * @brief Send the frame. Transmitters can use its headroom and tailroom
+         * to add their headers and trailers in place (frame is restored before returning).
+         * By default calls send(buffer, size).
+         * @param frame Frame to send.
+         * @return true if data were sent, false otherewise.
+         */
+        virtual bool sendFrame(FrameBuffer& frame)
+        {
+            return send(frame.getData(), frame.getSize());
+        }
+
+        /**
+         * @brief Send the frame that is sent also by other transmitters (see PacketBroadcaster).
+         * Transmitters can reuse the frame encoded by another one with the same framing
+         * (SharedFrame::getEncoded()) or keep the frame until it is sent (SharedFrame::retain()).
+         * By default calls sendFrame().
+         * @param frame Shared frame to send.
+         * @return true if data were sent, false otherewise.
+         */
+        virtual bool sendShared(SharedFrame& frame)
+        {
+            return sendFrame(frame.getFrame());
+        }
+
+        /**
+         * @return Framing of sent frames (NONE if frames are not encoded or the framing
+         * is not shared with other transceivers). See sendWithTrailer().
+         */
+        virtual SharedFrame::Encoding getFraming() const
+        {
+            return SharedFrame::Encoding::NONE;
+        }
+
+        /**
+         * @brief Optional forwarding of the verified frame received by a receiver with
+         * the same framing (IReceiver::getReceivedFraming() == getFraming()).
+         * Trailer of the frame (eg. checksum) placed right after it is sent as it is,
+         * so it is not calculated again (see PacketRouter).
+         * @param buffer Frame followed by its trailer.
+         * @param size Size of the frame (without trailer).
+         * @return true if data were sent, false otherewise (always if not supported).
+         */
+        virtual bool sendWithTrailer(const uint8_t* buffer, size_t size)
+        {
+            (void)buffer;
+            (void)size;
+            return false;
+        }
+
+        /**
+         * @brief Optional vectored sending. Frame is made of parts (eg. packet ID
+         * and payload) that are sent one after another, so they don't have to be
+         * copied to one buffer first. Check isSendPartsSupported() before.
+         * @param parts Array of parts of the frame.
+         * @param count Amount of parts.
+         * @return true if data were sent, false otherewise (always if not supported).
+         */
+        virtual bool sendParts(const DataBuffer* parts, size_t count)
+        {
+            (void)parts;
+            (void)count;
+            return false;
+        }
+
+        /**
+         * @return true if sendParts() is implemented by this transmitter.
+         */
+        virtual bool isSendPartsSupported() const
+        {
+            return false;
+        }
+
+        /**
+         * @brief Optional zero-copy sending. Returns buffer placed directly in the
+         * transmitter output (eg. shared memory), where the caller can write
+         * the frame and then send it using commitSendBuffer().
+         * @param size Size of the frame that will be written.
+         * @return Buffer of at least size bytes or empty buffer if zero-copy sending
+         * is not supported or there is no space now (use send() then).
+         */
+        virtual DataBuffer reserveSendBuffer(size_t size)
+        {
+            (void)size;
+            return DataBuffer();
+        }
+
+        /**
+         * @brief Send the frame written to the buffer returned by the last reserveSendBuffer() call.
+         * @param size Amount of bytes written (at most size passed to reserveSendBuffer()).
+         * @return true if data were sent, false otherewise.
+         */
+        virtual bool commitSendBuffer(size_t size)
+        {
+            (void)size;
+            return false;
+        }
+
+        /**
+         * @brief Result of sending by PacketCommunication (see PacketCommunication::getLastSendStatus()).
+         */
+        enum class SendStatus : uint8_t
+        {
+            SENT,        // whole frame was written
+            QUEUED,      // frame (or its rest) waits in the send queue, sent by next poll() calls
+            WOULD_BLOCK, // frame was not sent, there is no space in the output now (try again later)
+            FAILED       // frame was not sent because of any other reason
+        };
+
+        /**
+         * @brief Non-blocking transmitters check if the frame can be sent now
+         * (written or queued) without blocking. Blocking transmitters always return true.
+         * @param size Size of the frame.
+         */
+        virtual bool canSend(size_t size)
+        {
+            (void)size;
+            return true;
+        }
+
+        /**
+         * @return Amount of bytes of sent frames that were queued and wait for poll().
+         */
+        virtual size_t getPendingSendSize() const
+        {
+            return 0;
+        }
+
+        /**
+         * @brief Continue writing of queued frames (as much as can be written
+         * without blocking). Non-blocking transmitters need it to be called
+         * often, eg. in each loop.
+         * @return true if nothing is left in the send queue.
+         */
+        virtual bool poll()
+        {
+            return true;
+        }
     };
 
 
@@ -82,6 +226,44 @@ namespace PacketComm
          * @return DataBuffer with received data or empty buffer if no data was received.
          */
         virtual const DataBuffer getReceived() = 0;
+
+        /**
+         * @brief Receive several frames at once. Returned buffers stay valid
+         * until the next receiveBatch() or receive() call.
+         * By default receives only one frame (by receive() and getReceived()).
+         * @param out Array for the received frames.
+         * @param max Size of the out array.
+         * @return Amount of received frames (0 if there is no data).
+         */
+        virtual size_t receiveBatch(DataBuffer* out, size_t max)
+        {
+            if (max == 0 || !receive())
+                return 0;
+
+            out[0] = getReceived();
+            return 1;
+        }
+
+        /**
+         * @brief Called by packet communication before it dispatches the frame of the last
+         * receiveBatch() with this index (eg. LinuxUDPComm sends replies from callbacks
+         * to the sender of that frame). Does nothing by default.
+         * @param index Index of the frame in the out array of receiveBatch().
+         */
+        virtual void selectBatchFrame(size_t index)
+        {
+            (void)index;
+        }
+
+        /**
+         * @return Framing of received frames. If it is not NONE, each received frame
+         * is followed in memory by its verified trailer (eg. checksum),
+         * see ITransmitter::sendWithTrailer().
+         */
+        virtual SharedFrame::Encoding getReceivedFraming() const
+        {
+            return SharedFrame::Encoding::NONE;
+        }
     };
 
 
@@ -96,6 +278,19 @@ namespace PacketComm
     {
     public:
         virtual ~ITransceiver() {}
+
+#if PACKETCOMM_LATENCY_TRACING
+        /**
+         * @brief Set tracer that will be notified when frames are started,
+         * completed, encoded and written. Implementations that don't
+         * support tracing can ignore it.
+         * @param tracer Pointer to the tracer or nullptr to disable tracing.
+         */
+        virtual void setLatencyTracer(LatencyTracer* tracer)
+        {
+            (void)tracer;
+        }
+#endif
     };
 }
 
@@ -0,0 +1,270 @@
+/**
+ * @file LatencyTracer.cpp
+ * @author Jan Wielgus
+ * @date 2026-10-19
+ */
+
+#include "LatencyTracer.h"
+#include <Arduino.h>
+
+using namespace PacketComm;
+
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+
+void LatencyHistogram::add(uint32_t interval_us)
+{
+    CountType& bucket = buckets[getBucketIndex(interval_us)];
+    if (bucket != (CountType)-1) // saturate
+        bucket++;
+
+    if (interval_us > max_us)
+        max_us = interval_us;
+}
+
+
+void LatencyHistogram::reset()
+{
+    for (uint8_t i = 0; i < BucketsAmount; ++i)
+        buckets[i] = 0;
+    max_us = 0;
+}
+
+
+LatencyHistogram::CountType LatencyHistogram::getBucketCount(uint8_t bucket) const
+{
+    return bucket < BucketsAmount ? buckets[bucket] : 0;
+}
+
+
+uint32_t LatencyHistogram::getBucketUpperBound_us(uint8_t bucket)
+{
+    if (bucket >= BucketsAmount - 1)
+        return (uint32_t)-1;
+    return (uint32_t)1 << bucket;
+}
+
+
+uint32_t LatencyHistogram::getTotalCount() const
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < BucketsAmount; ++i)
+        total += buckets[i];
+    return total;
+}
+
+
+uint32_t LatencyHistogram::getMax_us() const
+{
+    return max_us;
+}
+
+
+uint32_t LatencyHistogram::getPercentileUpperBound_us(uint8_t percent) const
+{
+    uint32_t total = getTotalCount();
+    if (total == 0)
+        return 0;
+
+    uint32_t threshold = ((uint64_t)total * (percent > 100 ? 100 : percent) + 99) / 100;
+    uint32_t accumulated = 0;
+    for (uint8_t i = 0; i < BucketsAmount; ++i)
+    {
+        accumulated += buckets[i];
+        if (accumulated >= threshold && accumulated > 0)
+            return getBucketUpperBound_us(i);
+    }
+
+    return getBucketUpperBound_us(BucketsAmount - 1);
+}
+
+
+uint8_t LatencyHistogram::getBucketIndex(uint32_t interval_us)
+{
+    uint8_t index = 0;
+    while (interval_us != 0 && index < BucketsAmount - 1)
+    {
+        interval_us >>= 1;
+        index++;
+    }
+    return index;
+}
+
+
+
+void LatencyTracer::markFrameStart()
+{
+    markFrameStart(now_us());
+}
+
+
+void LatencyTracer::markFrameStart(uint32_t time_us)
+{
+    frameStart_us = time_us;
+    marks |= FRAME_START;
+}
+
+
+void LatencyTracer::markFrameComplete(const DataBuffer& frame)
+{
+    CompletedFrame& completed = completedFrames[nextCompletedFrame];
+    nextCompletedFrame = (nextCompletedFrame + 1) % PACKETCOMM_RECEIVE_BATCH_SIZE;
+
+    completed.begin = frame.buffer;
+    completed.end = frame.buffer + frame.size;
+    completed.start_us = frameStart_us;
+    completed.complete_us = now_us();
+    completed.started_flag = (marks & FRAME_START) != 0;
+
+    marks &= ~FRAME_START; // next frame has to be started again
+}
+
+
+void LatencyTracer::beginReceiveBatch()
+{
+    for (size_t i = 0; i < PACKETCOMM_RECEIVE_BATCH_SIZE; ++i)
+        completedFrames[i].begin = nullptr;
+    nextCompletedFrame = 0;
+}
+
+
+void LatencyTracer::commitReceive(Packet::PacketIDType packetID, const DataBuffer& frame)
+{
+    uint32_t dispatch_us = now_us();
+    CompletedFrame* completed = findCompletedFrame(frame.buffer);
+    if (completed == nullptr)
+        return;
+
+    Entry* entry = getEntry(packetID);
+    if (entry != nullptr)
+    {
+        if (completed->started_flag)
+        {
+            entry->histograms[(uint8_t)Stage::RECEIVE_FRAMING].add(completed->complete_us - completed->start_us);
+            entry->histograms[(uint8_t)Stage::RECEIVE_TOTAL].add(dispatch_us - completed->start_us);
+        }
+        entry->histograms[(uint8_t)Stage::RECEIVE_DISPATCH].add(dispatch_us - completed->complete_us);
+    }
+
+    completed->begin = nullptr;
+}
+
+
+void LatencyTracer::markSendStart()
+{
+    sendStart_us = now_us();
+    marks = (marks | SEND_START) & ~(SEND_ENCODED | SEND_WRITTEN);
+}
+
+
+void LatencyTracer::markSendEncoded()
+{
+    sendEncoded_us = now_us();
+    marks |= SEND_ENCODED;
+}
+
+
+void LatencyTracer::markSendWritten()
+{
+    sendWritten_us = now_us();
+    marks |= SEND_WRITTEN;
+}
+
+
+void LatencyTracer::commitSend(Packet::PacketIDType packetID)
+{
+    Entry* entry = getEntry(packetID);
+
+    if (entry != nullptr)
+    {
+        if ((marks & SEND_START) && (marks & SEND_ENCODED))
+            entry->histograms[(uint8_t)Stage::SEND_ENCODE].add(sendEncoded_us - sendStart_us);
+        if ((marks & SEND_ENCODED) && (marks & SEND_WRITTEN))
+            entry->histograms[(uint8_t)Stage::SEND_WRITE].add(sendWritten_us - sendEncoded_us);
+    }
+
+    marks &= ~(SEND_START | SEND_ENCODED | SEND_WRITTEN);
+}
+
+
+const LatencyHistogram* LatencyTracer::getHistogram(Packet::PacketIDType packetID, Stage stage) const
+{
+    for (size_t i = 0; i < entriesUsed; ++i)
+        if (entries[i].packetID == packetID)
+            return &entries[i].histograms[(uint8_t)stage];
+
+    return nullptr;
+}
+
+
+size_t LatencyTracer::getTrackedIDsAmount() const
+{
+    return entriesUsed;
+}
+
+
+Packet::PacketIDType LatencyTracer::getTrackedID(size_t index) const
+{
+    return entries[index].packetID;
+}
+
+
+uint32_t LatencyTracer::getUntrackedCount() const
+{
+    return untrackedCount;
+}
+
+
+void LatencyTracer::reset()
+{
+    for (size_t i = 0; i < entriesUsed; ++i)
+        for (uint8_t s = 0; s < StagesAmount; ++s)
+            entries[i].histograms[s].reset();
+
+    entriesUsed = 0;
+    untrackedCount = 0;
+    marks = 0;
+    beginReceiveBatch();
+}
+
+
+LatencyTracer::Entry* LatencyTracer::getEntry(Packet::PacketIDType packetID)
+{
+    for (size_t i = 0; i < entriesUsed; ++i)
+        if (entries[i].packetID == packetID)
+            return &entries[i];
+
+    if (entriesUsed < PACKETCOMM_LATENCY_TRACKED_IDS)
+    {
+        Entry* entry = &entries[entriesUsed++];
+        entry->packetID = packetID;
+        return entry;
+    }
+
+    untrackedCount++;
+    return nullptr;
+}
+
+
+LatencyTracer::CompletedFrame* LatencyTracer::findCompletedFrame(const uint8_t* buffer)
+{
+    // wrappers can return only a part of the frame (eg. without their header)
+    uintptr_t address = (uintptr_t)buffer;
+    for (size_t i = 0; i < PACKETCOMM_RECEIVE_BATCH_SIZE; ++i)
+    {
+        CompletedFrame& completed = completedFrames[i];
+        if (completed.begin != nullptr && address >= (uintptr_t)completed.begin && address < (uintptr_t)completed.end)
+            return &completed;
+    }
+    return nullptr;
+}
+
+
+uint32_t LatencyTracer::now_us()
+{
+    return micros();
+}
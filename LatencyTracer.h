@@ -0,0 +1,253 @@
+/**
+ * @file LatencyTracer.h
+ * @author Jan Wielgus
+ * @brief Collects latency of received and sent frames
+ * in per-ID histograms with fixed log-scale buckets.
+ * @date 2026-10-19
+ */
+
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include "PacketCommConfig.h"
+#include "Packet.h"
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Histogram of time intervals with log2 buckets.
+     * Bucket 0 counts intervals equal to 0us, bucket i (i > 0) counts intervals
+     * in range [2^(i-1), 2^i) us. The last bucket counts also all longer intervals.
+     * Counters saturate instead of overflowing.
+     */
+    class LatencyHistogram
+    {
+    public:
+        typedef uint16_t CountType;
+        static const uint8_t BucketsAmount = 24; // last bucket starts at ~4.2s
+
+    private:
+        CountType buckets[BucketsAmount];
+        uint32_t max_us;
+
+    public:
+        LatencyHistogram();
+
+        /**
+         * @brief Add one interval to the histogram.
+         * @param interval_us Interval in microseconds.
+         */
+        void add(uint32_t interval_us);
+
+        /**
+         * @brief Clear all buckets.
+         */
+        void reset();
+
+        /**
+         * @param bucket Index of the bucket [0, BucketsAmount).
+         * @return Amount of intervals counted in the bucket.
+         */
+        CountType getBucketCount(uint8_t bucket) const;
+
+        /**
+         * @param bucket Index of the bucket [0, BucketsAmount).
+         * @return Exclusive upper bound of the bucket in microseconds
+         * (lower bound is upper bound of the previous bucket).
+         */
+        static uint32_t getBucketUpperBound_us(uint8_t bucket);
+
+        /**
+         * @return Amount of all intervals added since the last reset.
+         */
+        uint32_t getTotalCount() const;
+
+        /**
+         * @return The longest interval added since the last reset.
+         */
+        uint32_t getMax_us() const;
+
+        /**
+         * @brief Finds approximate percentile of the intervals.
+         * @param percent [0, 100].
+         * @return Upper bound of the bucket that contains the percentile
+         * or 0 if histogram is empty.
+         */
+        uint32_t getPercentileUpperBound_us(uint8_t percent) const;
+
+        /**
+         * @param interval_us Interval in microseconds.
+         * @return Index of the bucket that would count this interval.
+         */
+        static uint8_t getBucketIndex(uint32_t interval_us);
+    };
+
+
+
+    /**
+     * @brief Timestamps frames at several points on the receive and send path
+     * and feeds intervals between them into per-ID histograms.
+     * Low-level comm marks when the first byte of a frame arrived, when
+     * the frame was completed and when it was encoded/written.
+     * PacketCommunication marks the send start and commits timestamps
+     * (with packet ID) right before the receive callback is executed
+     * and after low-level comm returned from sending.
+     * Timestamps of completed frames are kept for each frame of the received
+     * batch (up to PACKETCOMM_RECEIVE_BATCH_SIZE) and found by the frame memory.
+     * Memory is reserved statically for PACKETCOMM_LATENCY_TRACKED_IDS IDs.
+     * Hooks are compiled only if PACKETCOMM_LATENCY_TRACING is enabled.
+     */
+    class LatencyTracer
+    {
+    public:
+        enum class Stage : uint8_t
+        {
+            RECEIVE_FRAMING,   // first byte of the frame -> frame completed
+            RECEIVE_DISPATCH,  // frame completed -> receive callback dispatch
+            RECEIVE_TOTAL,     // first byte of the frame -> receive callback dispatch
+            SEND_ENCODE,       // PacketCommunication::send() call -> frame encoded
+            SEND_WRITE,        // frame encoded -> frame written to the low-level comm
+        };
+        static const uint8_t StagesAmount = 5;
+
+    private:
+        struct Entry
+        {
+            Packet::PacketIDType packetID;
+            LatencyHistogram histograms[StagesAmount];
+        };
+
+        struct CompletedFrame
+        {
+            const uint8_t* begin = nullptr; // nullptr - not used
+            const uint8_t* end = nullptr;
+            uint32_t start_us = 0;
+            uint32_t complete_us = 0;
+            bool started_flag = false; // start of the frame was marked
+        };
+
+        enum MarkFlag : uint8_t
+        {
+            FRAME_START = 1 << 0,
+            SEND_START = 1 << 1,
+            SEND_ENCODED = 1 << 2,
+            SEND_WRITTEN = 1 << 3,
+        };
+
+        Entry entries[PACKETCOMM_LATENCY_TRACKED_IDS];
+        size_t entriesUsed = 0;
+        uint32_t untrackedCount = 0;
+
+        uint8_t marks = 0;
+        uint32_t frameStart_us = 0;
+        CompletedFrame completedFrames[PACKETCOMM_RECEIVE_BATCH_SIZE];
+        size_t nextCompletedFrame = 0; // the oldest one is replaced when all are used
+        uint32_t sendStart_us = 0;
+        uint32_t sendEncoded_us = 0;
+        uint32_t sendWritten_us = 0;
+
+
+    public:
+        LatencyTracer() = default;
+
+        LatencyTracer(const LatencyTracer&) = delete;
+        LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+        /**
+         * @brief Mark that the first byte of a new frame was read.
+         */
+        void markFrameStart();
+
+        /**
+         * @brief Mark that the first byte of a new frame was read at time_us
+         * (eg. frame that starts in the middle of bytes read at once).
+         * @param time_us Time from micros().
+         */
+        void markFrameStart(uint32_t time_us);
+
+        /**
+         * @brief Mark that a valid frame was completed (decoded and verified).
+         * Its timestamps are kept until commitReceive() of this frame
+         * or the next beginReceiveBatch().
+         * @param frame Completed frame (as returned by the low-level comm).
+         */
+        void markFrameComplete(const DataBuffer& frame);
+
+        /**
+         * @brief Forget timestamps of frames completed before (eg. frames that
+         * were not dispatched). Call before receiving the next batch of frames.
+         */
+        void beginReceiveBatch();
+
+        /**
+         * @brief Record receive intervals of the frame. Call right before the receive
+         * callback is executed. Frames that were not marked as completed (eg. frames
+         * changed by CompressionComm) have no receive intervals.
+         * @param packetID ID of the received packet.
+         * @param frame Received frame (or its part, eg. without the header of BondedComm).
+         */
+        void commitReceive(Packet::PacketIDType packetID, const DataBuffer& frame);
+
+        /**
+         * @brief Mark that sending of a new packet has started.
+         */
+        void markSendStart();
+
+        /**
+         * @brief Mark that the frame to send was encoded.
+         */
+        void markSendEncoded();
+
+        /**
+         * @brief Mark that the encoded frame was written.
+         */
+        void markSendWritten();
+
+        /**
+         * @brief Record send intervals of the last sent frame.
+         * @param packetID ID of the sent packet.
+         */
+        void commitSend(Packet::PacketIDType packetID);
+
+        /**
+         * @param packetID ID of the packet.
+         * @param stage Stage of the frame path.
+         * @return Pointer to the histogram or nullptr if this ID is not tracked.
+         */
+        const LatencyHistogram* getHistogram(Packet::PacketIDType packetID, Stage stage) const;
+
+        /**
+         * @return Amount of IDs that have their histograms.
+         */
+        size_t getTrackedIDsAmount() const;
+
+        /**
+         * @param index [0, getTrackedIDsAmount()).
+         * @return Packet ID tracked under this index.
+         */
+        Packet::PacketIDType getTrackedID(size_t index) const;
+
+        /**
+         * @return Amount of commits of packets that could not be tracked
+         * (all PACKETCOMM_LATENCY_TRACKED_IDS entries were used).
+         */
+        uint32_t getUntrackedCount() const;
+
+        /**
+         * @brief Remove all tracked IDs and their histograms.
+         */
+        void reset();
+
+
+    private:
+        Entry* getEntry(Packet::PacketIDType packetID);
+        CompletedFrame* findCompletedFrame(const uint8_t* buffer);
+        static uint32_t now_us();
+    };
+}
+
+
+#endif
@@ -0,0 +1,595 @@
+/**
+ * @file AsyncPacketCommunication.h
+ * @author Jan Wielgus
+ * @brief C++20 coroutine interface of the PacketCommunication:
+ * co_await comm.next(&packet), co_await comm.sendAsync(&packet), co_await comm.sleep(us).
+ * Coroutines are resumed from poll() (the receive loop), without threads
+ * and without heap allocations other than the coroutine frames.
+ * Host only, requires C++20.
+ * @date 2026-10-19
+ */
+
+#ifndef ASYNCPACKETCOMMUNICATION_H
+#define ASYNCPACKETCOMMUNICATION_H
+
+#if !defined(__cpp_impl_coroutine) || __cplusplus < 202002L
+#error "AsyncPacketCommunication.h requires C++20 coroutines (compile with -std=c++20)"
+#endif
+
+#include "PacketCommunication.h"
+#include "Packet.h"
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <unordered_map>
+#include <utility>
+
+
+namespace PacketComm
+{
+    namespace AsyncDetail
+    {
+        struct PromiseBase
+        {
+            std::coroutine_handle<> continuation; // coroutine that awaits this task
+            bool detached = false;                // task object was destroyed before completion
+
+            std::suspend_never initial_suspend() noexcept { return {}; }
+
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept { return false; }
+
+                template <class Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    PromiseBase& promise = handle.promise();
+                    if (promise.continuation)
+                        return promise.continuation;
+                    if (promise.detached)
+                        handle.destroy();
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        template <class T>
+        struct PromiseValue
+        {
+            T value{};
+            void return_value(T result) { value = std::move(result); }
+            T take() { return std::move(value); }
+        };
+
+        template <>
+        struct PromiseValue<void>
+        {
+            void return_void() {}
+            void take() {}
+        };
+    }
+
+
+
+    /**
+     * @brief Coroutine started immediately after the call. Can be awaited by
+     * another coroutine (co_await task) or just kept (or dropped) by the caller.
+     * If the task object is destroyed before completion, coroutine keeps running
+     * and its frame is freed when it finishes.
+     * @tparam T Type of the co_returned value.
+     */
+    template <class T = void>
+    class AsyncTask
+    {
+    public:
+        struct promise_type : AsyncDetail::PromiseBase, AsyncDetail::PromiseValue<T>
+        {
+            AsyncTask get_return_object()
+            {
+                return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit AsyncTask(std::coroutine_handle<promise_type> handle)
+            : handle(handle)
+        {
+        }
+
+    public:
+        AsyncTask() = default;
+
+        AsyncTask(AsyncTask&& other) noexcept
+            : handle(std::exchange(other.handle, nullptr))
+        {
+        }
+
+        AsyncTask& operator=(AsyncTask&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        AsyncTask(const AsyncTask&) = delete;
+        AsyncTask& operator=(const AsyncTask&) = delete;
+
+        ~AsyncTask()
+        {
+            release();
+        }
+
+        /**
+         * @return true if coroutine has finished (or task is empty).
+         */
+        bool isDone() const
+        {
+            return !handle || handle.done();
+        }
+
+        /**
+         * @brief Destroy suspended coroutine (its pending awaits are cancelled).
+         * Must not be called when the task is awaited by another coroutine.
+         */
+        void cancel()
+        {
+            if (handle)
+                handle.destroy();
+            handle = nullptr;
+        }
+
+        bool await_ready() const noexcept
+        {
+            return isDone();
+        }
+
+        void await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle.promise().continuation = awaiting;
+        }
+
+        T await_resume()
+        {
+            return handle.promise().take();
+        }
+
+    private:
+        void release()
+        {
+            if (!handle)
+                return;
+            if (handle.done())
+                handle.destroy();
+            else
+                handle.promise().detached = true;
+            handle = nullptr;
+        }
+    };
+
+
+
+    /**
+     * @brief PacketCommunication which packets can be awaited by coroutines.
+     * All awaits are resumed from poll(), which has to be called in the receive loop
+     * (instead of receive()). Awaits of one comm instance have to be used from one thread.
+     */
+    class AsyncPacketCommunication : public PacketCommunication
+    {
+    public:
+        static const uint32_t NoTimeout = 0;
+
+    private:
+        struct Waiter;
+
+        /**
+         * @brief Intrusive list of waiters (nodes are stored in the awaiters).
+         */
+        struct WaiterList
+        {
+            Waiter* head = nullptr;
+            Waiter* tail = nullptr;
+
+            void pushBack(Waiter* waiter);
+            void remove(Waiter* waiter);
+            Waiter* popFront();
+        };
+
+        struct Waiter
+        {
+            std::coroutine_handle<> handle;
+            const Packet* packet = nullptr; // packet to send (pending sends)
+            bool pending = false;
+            bool result = false;
+
+            // packet waiting list or pending sends list
+            WaiterList* list = nullptr;
+            Waiter* previous = nullptr;
+            Waiter* next = nullptr;
+
+            // timeout
+            WaiterList* timerSlot = nullptr;
+            Waiter* timerPrevious = nullptr;
+            Waiter* timerNext = nullptr;
+            uint64_t deadlineTick = 0;
+        };
+
+        static const size_t WheelSlots = 256;
+        const uint32_t TickResolution_us;
+        WaiterList timerWheel[WheelSlots];
+        uint64_t currentTick;
+        std::chrono::steady_clock::time_point startTime;
+
+        std::unordered_map<Packet::PacketIDType, WaiterList> packetWaiters; // one node per packet ID
+        WaiterList pendingSends;
+        size_t pendingAwaits = 0;
+
+
+    public:
+        /**
+         * @param lowLevelComm Pointer to the low level communication instance.
+         * @param timeoutResolution_us Resolution of timeouts (they can be late at most by this time).
+         */
+        explicit AsyncPacketCommunication(ITransceiver* lowLevelComm, uint32_t timeoutResolution_us = 1000)
+            : PacketCommunication(lowLevelComm),
+              TickResolution_us(timeoutResolution_us > 0 ? timeoutResolution_us : 1),
+              currentTick(0),
+              startTime(std::chrono::steady_clock::now())
+        {
+        }
+
+
+        class ReceiveAwaiter
+        {
+            AsyncPacketCommunication& comm;
+            const Packet* const packet;
+            const uint32_t timeout_us;
+            Waiter waiter;
+
+        public:
+            ReceiveAwaiter(AsyncPacketCommunication& comm, const Packet* packet, uint32_t timeout_us)
+                : comm(comm), packet(packet), timeout_us(timeout_us)
+            {
+            }
+
+            ReceiveAwaiter(const ReceiveAwaiter&) = delete;
+            ReceiveAwaiter& operator=(const ReceiveAwaiter&) = delete;
+
+            ~ReceiveAwaiter() { comm.cancel(waiter); }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                comm.suspend(waiter, handle);
+                comm.packetWaiters[packet->getID()].pushBack(&waiter);
+                if (timeout_us != NoTimeout)
+                    comm.addTimeout(waiter, timeout_us);
+            }
+
+            bool await_resume() const noexcept { return waiter.result; }
+        };
+
+        class SendAwaiter
+        {
+            AsyncPacketCommunication& comm;
+            const uint32_t timeout_us;
+            Waiter waiter;
+
+        public:
+            SendAwaiter(AsyncPacketCommunication& comm, const Packet* packet, uint32_t timeout_us)
+                : comm(comm), timeout_us(timeout_us)
+            {
+                waiter.packet = packet;
+            }
+
+            SendAwaiter(const SendAwaiter&) = delete;
+            SendAwaiter& operator=(const SendAwaiter&) = delete;
+
+            ~SendAwaiter() { comm.cancel(waiter); }
+
+            bool await_ready()
+            {
+                // Keep order of sends: don't pass the packets that wait already
+                if (comm.pendingSends.head != nullptr)
+                    return false;
+
+                waiter.result = comm.send(waiter.packet);
+                return waiter.result || comm.getLastSendStatus() != SendStatus::WOULD_BLOCK; // failed for good
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                comm.suspend(waiter, handle);
+                comm.pendingSends.pushBack(&waiter);
+                if (timeout_us != NoTimeout)
+                    comm.addTimeout(waiter, timeout_us);
+            }
+
+            bool await_resume() const noexcept { return waiter.result; }
+        };
+
+        class SleepAwaiter
+        {
+            AsyncPacketCommunication& comm;
+            const uint32_t time_us;
+            Waiter waiter;
+
+        public:
+            SleepAwaiter(AsyncPacketCommunication& comm, uint32_t time_us)
+                : comm(comm), time_us(time_us)
+            {
+            }
+
+            SleepAwaiter(const SleepAwaiter&) = delete;
+            SleepAwaiter& operator=(const SleepAwaiter&) = delete;
+
+            ~SleepAwaiter() { comm.cancel(waiter); }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                comm.suspend(waiter, handle);
+                comm.addTimeout(waiter, time_us > 0 ? time_us : 1);
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+
+        /**
+         * @brief Await the next reception of the packet (packet has to be registered).
+         * Packet is already updated when coroutine is resumed.
+         * @param packet Registered receive packet.
+         * @param timeout_us Max waiting time (NoTimeout - no limit).
+         * @return (co_await result) true if packet was received, false on timeout.
+         */
+        ReceiveAwaiter next(const Packet* packet, uint32_t timeout_us = NoTimeout)
+        {
+            return ReceiveAwaiter(*this, packet, timeout_us);
+        }
+
+        /**
+         * @brief Send the packet. If transceiver doesn't accept it now (WOULD_BLOCK, eg. its buffer is full),
+         * sending is retried in poll() until success or timeout. Packets are sent in order of awaits.
+         * @param packet Packet to send (must not be changed until sent).
+         * @param timeout_us Max waiting time (NoTimeout - no limit).
+         * @return (co_await result) true if packet was sent, false on timeout
+         * or if sending failed for other reason (see getLastSendStatus()).
+         */
+        SendAwaiter sendAsync(const Packet* packet, uint32_t timeout_us = NoTimeout)
+        {
+            return SendAwaiter(*this, packet, timeout_us);
+        }
+
+        /**
+         * @brief Resume coroutine after the time.
+         */
+        SleepAwaiter sleep(uint32_t time_us)
+        {
+            return SleepAwaiter(*this, time_us);
+        }
+
+        /**
+         * @brief Receive all available data (resumes coroutines awaiting received packets),
+         * retry pending sends and resume coroutines which awaits have timed out.
+         * Must not be called from coroutines resumed by this comm.
+         */
+        void poll()
+        {
+            receive();
+            retryPendingSends();
+            processTimeouts();
+        }
+
+        /**
+         * @return Amount of awaits that are not finished yet.
+         */
+        size_t getPendingAwaitsAmount() const
+        {
+            return pendingAwaits;
+        }
+
+
+    protected:
+        void onPacketReceived(Packet* receivedPacket) override
+        {
+            auto found = packetWaiters.find(receivedPacket->getID());
+            if (found == packetWaiters.end() || found->second.head == nullptr)
+                return;
+
+            // Waiters resumed now are moved to the local list, because resumed coroutines
+            // can await this packet again (and should get its next reception).
+            WaiterList ready;
+            Waiter* waiter;
+            while ((waiter = found->second.popFront()) != nullptr)
+                ready.pushBack(waiter);
+
+            resumeAll(ready, true);
+        }
+
+
+    private:
+        void suspend(Waiter& waiter, std::coroutine_handle<> handle)
+        {
+            waiter.handle = handle;
+            waiter.pending = true;
+            pendingAwaits++;
+        }
+
+        void retryPendingSends()
+        {
+            while (pendingSends.head != nullptr)
+            {
+                Waiter* waiter = pendingSends.head;
+                bool result = send(waiter->packet);
+                if (!result && getLastSendStatus() == SendStatus::WOULD_BLOCK)
+                    return; // transceiver is still busy
+
+                // sent or failed for good (eg. too big), next packets don't wait for it
+                pendingSends.popFront();
+                WaiterList ready;
+                ready.pushBack(waiter);
+                resumeAll(ready, result);
+            }
+        }
+
+        void processTimeouts()
+        {
+            uint64_t nowTick = getTime_us() / TickResolution_us;
+            if (nowTick <= currentTick)
+                return;
+
+            // all slots are checked at most once
+            uint64_t firstTick = nowTick - currentTick > WheelSlots ? nowTick - WheelSlots + 1 : currentTick + 1;
+            currentTick = nowTick;
+
+            WaiterList ready;
+            for (uint64_t tick = firstTick; tick <= nowTick; ++tick)
+            {
+                WaiterList& slot = timerWheel[tick % WheelSlots];
+                Waiter* waiter = slot.head;
+                while (waiter != nullptr)
+                {
+                    Waiter* nextWaiter = waiter->timerNext;
+                    if (waiter->deadlineTick <= nowTick)
+                    {
+                        removeTimeout(*waiter);
+                        if (waiter->list != nullptr)
+                            waiter->list->remove(waiter);
+                        ready.pushBack(waiter);
+                    }
+                    waiter = nextWaiter;
+                }
+            }
+
+            resumeAll(ready, false);
+        }
+
+        /**
+         * @param result Value returned by co_await of resumed waiters.
+         */
+        void resumeAll(WaiterList& ready, bool result)
+        {
+            Waiter* waiter;
+            while ((waiter = ready.popFront()) != nullptr)
+            {
+                removeTimeout(*waiter);
+                waiter->pending = false;
+                waiter->result = result;
+                pendingAwaits--;
+                waiter->handle.resume(); // waiter can be destroyed here
+            }
+        }
+
+        void addTimeout(Waiter& waiter, uint32_t timeout_us)
+        {
+            // Deadline is rounded up, so timeout never fires too early
+            uint64_t deadlineTick = (getTime_us() + timeout_us + TickResolution_us - 1) / TickResolution_us;
+            if (deadlineTick <= currentTick)
+                deadlineTick = currentTick + 1;
+
+            waiter.deadlineTick = deadlineTick;
+            WaiterList& slot = timerWheel[deadlineTick % WheelSlots];
+            waiter.timerSlot = &slot;
+            waiter.timerPrevious = slot.tail;
+            waiter.timerNext = nullptr;
+            if (slot.tail != nullptr)
+                slot.tail->timerNext = &waiter;
+            else
+                slot.head = &waiter;
+            slot.tail = &waiter;
+        }
+
+        void removeTimeout(Waiter& waiter)
+        {
+            WaiterList* slot = waiter.timerSlot;
+            if (slot == nullptr)
+                return;
+
+            if (waiter.timerPrevious != nullptr)
+                waiter.timerPrevious->timerNext = waiter.timerNext;
+            else
+                slot->head = waiter.timerNext;
+            if (waiter.timerNext != nullptr)
+                waiter.timerNext->timerPrevious = waiter.timerPrevious;
+            else
+                slot->tail = waiter.timerPrevious;
+
+            waiter.timerSlot = nullptr;
+            waiter.timerPrevious = waiter.timerNext = nullptr;
+        }
+
+        /**
+         * @brief Remove waiter of the destroyed awaiter (eg. cancelled coroutine).
+         */
+        void cancel(Waiter& waiter)
+        {
+            if (!waiter.pending)
+                return;
+
+            if (waiter.list != nullptr)
+                waiter.list->remove(&waiter);
+            removeTimeout(waiter);
+            waiter.pending = false;
+            pendingAwaits--;
+        }
+
+        uint64_t getTime_us() const
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+        }
+    };
+
+
+
+    inline void AsyncPacketCommunication::WaiterList::pushBack(Waiter* waiter)
+    {
+        waiter->list = this;
+        waiter->previous = tail;
+        waiter->next = nullptr;
+        if (tail != nullptr)
+            tail->next = waiter;
+        else
+            head = waiter;
+        tail = waiter;
+    }
+
+
+    inline void AsyncPacketCommunication::WaiterList::remove(Waiter* waiter)
+    {
+        if (waiter->previous != nullptr)
+            waiter->previous->next = waiter->next;
+        else
+            head = waiter->next;
+        if (waiter->next != nullptr)
+            waiter->next->previous = waiter->previous;
+        else
+            tail = waiter->previous;
+
+        waiter->list = nullptr;
+        waiter->previous = waiter->next = nullptr;
+    }
+
+
+    inline AsyncPacketCommunication::Waiter* AsyncPacketCommunication::WaiterList::popFront()
+    {
+        Waiter* waiter = head;
+        if (waiter != nullptr)
+            remove(waiter);
+        return waiter;
+    }
+}
+
+
+#endif
@@ -0,0 +1,450 @@
+/**
+ * @file BondedComm.h
+ * @author Jan Wielgus
+ * @brief Transceiver that bonds several transceivers (eg. serial radio and WiFi)
+ * into one link. Important packets are sent by all links, other frames are
+ * striped across links according to their capacity and connection stability.
+ * Duplicated frames are dropped on receive.
+ * @date 2026-10-19
+ */
+
+#ifndef BONDEDCOMM_H
+#define BONDEDCOMM_H
+
+#include "PacketCommConfig.h"
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "DataBuffer.h"
+#include "Encoding/LittleEndian.h"
+#include <Arduino.h>
+#include <EVAFilter.h>
+#include <GrowingArray.h>
+#include <string.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Each frame gets a sequence number (HeaderSize bytes before the frame, little-endian),
+     * so both sides have to use BondedComm. Received frames that were already
+     * received by another link are dropped. Sequence numbers are shared by all links,
+     * so a frame of a slow link can arrive many frames later than frames of a fast link.
+     * Frames that are more than ReorderWindow behind the newest one can't be checked
+     * and are dropped too (counted by getTooOldAmount()).
+     *
+     * Connection stability of each link is measured like in PacketCommunication
+     * (from frames received by the link in each receive pass), so failover needs
+     * traffic in both directions. Links with stability below the failover threshold
+     * are not used, unless all links are below it (eg. nothing was received yet).
+     * @tparam MaxLinks Max amount of bonded links.
+     * @tparam ReorderWindow Amount of recent sequence numbers remembered (multiple of 32,
+     * ReorderWindow / 8 bytes of RAM). Should be bigger than the amount of frames sent
+     * by faster links during the latency of the slowest link.
+     */
+    template <const size_t MaxLinks = 4, const size_t ReorderWindow = 256>
+    class BondedComm : public ITransceiver
+    {
+    public:
+        typedef uint8_t Percentage;
+        typedef uint16_t SequenceType;
+        static const size_t HeaderSize = sizeof(SequenceType);
+        static_assert(HeaderSize == 2, "sequence is written by LittleEndian::writeUInt16()");
+
+    private:
+        static const SequenceType RestartDistance = 1024; // frames farther from the newest one mean that the other side was restarted
+        static const size_t WindowWords = ReorderWindow / 32;
+        static_assert(ReorderWindow > 0 && ReorderWindow % 32 == 0 && ReorderWindow < RestartDistance,
+            "ReorderWindow has to be a multiple of 32 smaller than 1024");
+
+        struct Link
+        {
+            ITransceiver* transceiver = nullptr;
+            float capacity = 0; // eg. bytes per second (only relation between links matters)
+            FL::EVAFilter stabilityFilter;
+            float virtualTime = 0; // weighted amount of sent data (striping)
+            bool receivedInPass_flag = false;
+
+            // statistics
+            uint32_t sentFrames = 0;
+            uint32_t receivedFrames = 0;
+        };
+
+        Link links[MaxLinks];
+        size_t linksAmount = 0;
+        SimpleDataStructures::GrowingArray<Packet::PacketIDType> redundantPacketIDs;
+        Percentage failoverThreshold = 50;
+
+        // sending
+        SequenceType nextSequence = 0;
+        AutoDataBuffer sendingBuffer;
+
+        // receiving
+        size_t receiveLinkIndex = 0; // links are received in turns
+        SequenceType highestSequence = 0;
+        uint32_t receivedWindow[WindowWords] = {}; // bit (sequence % ReorderWindow) - frame was received
+        bool anyReceived_flag = false;
+        DataBuffer currentReceived;
+
+        // statistics
+        uint32_t duplicates = 0;
+        uint32_t tooOldFrames = 0;
+
+
+    public:
+        BondedComm()
+            : sendingBuffer(0)
+        {
+        }
+
+        BondedComm(const BondedComm&) = delete;
+        BondedComm& operator=(const BondedComm&) = delete;
+
+        /**
+         * @brief Add transceiver to the bond.
+         * @param transceiver Low level comm of this link.
+         * @param capacity Capacity of the link (eg. bytes per second). Striped frames
+         * are divided proportionally to capacity * connection stability of each link.
+         * @return false if there are already MaxLinks links or capacity is not positive.
+         */
+        bool addLink(ITransceiver* transceiver, float capacity)
+        {
+            if (linksAmount >= MaxLinks || transceiver == nullptr || capacity <= 0)
+                return false;
+
+            links[linksAmount].transceiver = transceiver;
+            links[linksAmount].capacity = capacity;
+            linksAmount++;
+            return true;
+        }
+
+        size_t getLinksAmount() const
+        {
+            return linksAmount;
+        }
+
+        /**
+         * @brief Packets with this ID will be sent by all working links
+         * (lower latency and loss for the cost of bandwidth).
+         */
+        bool addRedundantPacket(Packet::PacketIDType packetID)
+        {
+            if (isRedundant(packetID))
+                return false;
+            return redundantPacketIDs.add(packetID);
+        }
+
+        /**
+         * @param threshold Links with lower connection stability are not used
+         * (if any link has at least this stability).
+         */
+        void setFailoverThreshold(Percentage threshold)
+        {
+            failoverThreshold = constrain(threshold, 1, 100);
+        }
+
+        /**
+         * @brief Same as PacketCommunication::setConnStabilitySmoothness(), for all links.
+         */
+        void setLinkStabilitySmoothness(float smoothness)
+        {
+            smoothness = constrain(smoothness, 0.0f, 0.995f);
+            for (size_t i = 0; i < linksAmount; ++i)
+                links[i].stabilityFilter.setFilterBeta(smoothness);
+        }
+
+        Percentage getLinkStability(size_t link) const
+        {
+            return link < linksAmount ? uint8_t(links[link].stabilityFilter.getFilteredValue() + 0.5f) : 0;
+        }
+
+        uint32_t getLinkSentFramesAmount(size_t link) const { return link < linksAmount ? links[link].sentFrames : 0; }
+        uint32_t getLinkReceivedFramesAmount(size_t link) const { return link < linksAmount ? links[link].receivedFrames : 0; }
+        uint32_t getDuplicatesAmount() const { return duplicates; }
+        uint32_t getTooOldAmount() const { return tooOldFrames; }
+
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (buffer == nullptr || size == 0)
+                return false;
+
+            if (!sendingBuffer.ensureAllocatedSize(HeaderSize + size + PACKETCOMM_FRAME_TAILROOM, false))
+                return false;
+
+            FrameBuffer frame(sendingBuffer.buffer, sendingBuffer.AllocatedSize, HeaderSize);
+            memcpy(frame.pushBack(size), buffer, size);
+            return sendFrame(frame);
+        }
+
+        bool sendFrame(FrameBuffer& frame) override
+        {
+            if (linksAmount == 0 || frame.getSize() == 0)
+                return false;
+
+            uint8_t* header = frame.pushFront(HeaderSize);
+            if (header == nullptr)
+                return send(frame.getData(), frame.getSize()); // copied to the buffer with headroom
+
+            SequenceType sequence = nextSequence++;
+            LittleEndian::writeUInt16(header, sequence); // the same on all platforms
+
+            Packet::Header packetHeader;
+            bool result;
+            if (Packet::readHeader(DataBuffer(header + HeaderSize, frame.getSize() - HeaderSize), packetHeader) && isRedundant(packetHeader.id))
+                result = sendRedundant(frame);
+            else
+                result = sendStriped(frame);
+
+            frame.popFront(HeaderSize);
+            return result;
+        }
+
+        /**
+         * @brief Receive next frame from any link (links are received in turns).
+         * Frames already received by another link are skipped.
+         */
+        bool receive() override
+        {
+            size_t emptyLinks = 0;
+            while (emptyLinks < linksAmount)
+            {
+                Link& link = links[receiveLinkIndex];
+                if (!link.transceiver->receive())
+                {
+                    receiveLinkIndex = (receiveLinkIndex + 1) % linksAmount;
+                    emptyLinks++;
+                    continue;
+                }
+
+                DataBuffer frame = link.transceiver->getReceived();
+                if (frame.size <= HeaderSize)
+                    continue; // invalid frame
+
+                link.receivedFrames++;
+                link.receivedInPass_flag = true;
+
+                SequenceType sequence = LittleEndian::readUInt16(frame.buffer);
+                if (!acceptSequence(sequence))
+                    continue;
+
+                currentReceived = DataBuffer(frame.buffer + HeaderSize, frame.size - HeaderSize);
+                receiveLinkIndex = (receiveLinkIndex + 1) % linksAmount;
+                return true;
+            }
+
+            // All links were read out, this receive pass ends
+            updateLinksStability();
+            currentReceived = DataBuffer();
+            return false;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return currentReceived;
+        }
+
+        /**
+         * @return true if any used link can send the frame now (striped frames
+         * are sent by the next link when the chosen one fails).
+         */
+        bool canSend(size_t size) override
+        {
+            bool anyLinkStable = isAnyLinkStable();
+            for (size_t i = 0; i < linksAmount; ++i)
+                if (isLinkUsed(i, anyLinkStable) && links[i].transceiver->canSend(HeaderSize + size))
+                    return true;
+            return false;
+        }
+
+        size_t getPendingSendSize() const override
+        {
+            size_t pending = 0;
+            for (size_t i = 0; i < linksAmount; ++i)
+                pending += links[i].transceiver->getPendingSendSize();
+            return pending;
+        }
+
+        bool poll() override
+        {
+            bool result = true;
+            for (size_t i = 0; i < linksAmount; ++i)
+                if (!links[i].transceiver->poll())
+                    result = false;
+            return result;
+        }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer) override
+        {
+            for (size_t i = 0; i < linksAmount; ++i)
+                links[i].transceiver->setLatencyTracer(tracer);
+        }
+#endif
+
+
+    private:
+        bool isRedundant(Packet::PacketIDType packetID) const
+        {
+            for (size_t i = 0; i < redundantPacketIDs.size(); ++i)
+                if (redundantPacketIDs[i] == packetID)
+                    return true;
+            return false;
+        }
+
+        /**
+         * @return true if any link has stability above the failover threshold
+         * (then only such links are used).
+         */
+        bool isAnyLinkStable() const
+        {
+            for (size_t i = 0; i < linksAmount; ++i)
+                if (getLinkStability(i) >= failoverThreshold)
+                    return true;
+            return false;
+        }
+
+        bool isLinkUsed(size_t link, bool anyLinkStable) const
+        {
+            return !anyLinkStable || getLinkStability(link) >= failoverThreshold;
+        }
+
+        bool sendRedundant(FrameBuffer& frame)
+        {
+            bool anyLinkStable = isAnyLinkStable();
+            bool result = false;
+
+            for (size_t i = 0; i < linksAmount; ++i)
+            {
+                if (isLinkUsed(i, anyLinkStable) && links[i].transceiver->sendFrame(frame))
+                {
+                    links[i].sentFrames++;
+                    result = true;
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief Send the frame by the link that sent the least data relative to its weight
+         * (weighted fair queuing). If sending fails, next link is tried.
+         */
+        bool sendStriped(FrameBuffer& frame)
+        {
+            bool anyLinkStable = isAnyLinkStable();
+            bool tried[MaxLinks] = {};
+
+            for (size_t attempt = 0; attempt < linksAmount; ++attempt)
+            {
+                Link* chosen = nullptr;
+                for (size_t i = 0; i < linksAmount; ++i)
+                {
+                    if (!tried[i] && isLinkUsed(i, anyLinkStable) && (chosen == nullptr || links[i].virtualTime < chosen->virtualTime))
+                        chosen = &links[i];
+                }
+
+                if (chosen == nullptr)
+                    return false;
+                tried[chosen - links] = true;
+
+                // Keep virtual times small, links that were not used start from the current time
+                float now = chosen->virtualTime;
+                for (size_t i = 0; i < linksAmount; ++i)
+                    links[i].virtualTime = links[i].virtualTime > now ? links[i].virtualTime - now : 0;
+
+                float weight = chosen->capacity;
+                if (anyLinkStable)
+                    weight *= getLinkStability(chosen - links) / 100.f;
+                chosen->virtualTime += frame.getSize() / weight;
+
+                if (chosen->transceiver->sendFrame(frame))
+                {
+                    chosen->sentFrames++;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Check the sequence number in the window of recently received frames
+         * (and add it to the window).
+         * @return false if the frame is a duplicate or too old to check (statistics are updated).
+         */
+        bool acceptSequence(SequenceType sequence)
+        {
+            SequenceType ahead = sequence - highestSequence;
+            SequenceType behind = highestSequence - sequence;
+
+            if (!anyReceived_flag || (ahead >= RestartDistance && behind >= RestartDistance))
+            {
+                // first frame or frame far from the newest one (the other side was restarted)
+                anyReceived_flag = true;
+                memset(receivedWindow, 0, sizeof(receivedWindow));
+                markReceived(sequence);
+                highestSequence = sequence;
+                return true;
+            }
+
+            if (ahead != 0 && ahead < RestartDistance)
+            {
+                // newer frame, sequences that left the window are forgotten
+                if (ahead >= ReorderWindow)
+                    memset(receivedWindow, 0, sizeof(receivedWindow));
+                else
+                    for (SequenceType i = 1; i <= ahead; ++i)
+                        clearReceived(highestSequence + i);
+
+                markReceived(sequence);
+                highestSequence = sequence;
+                return true;
+            }
+
+            if (behind >= ReorderWindow)
+            {
+                tooOldFrames++;
+                return false;
+            }
+
+            if (isReceived(sequence))
+            {
+                duplicates++;
+                return false;
+            }
+
+            markReceived(sequence);
+            return true;
+        }
+
+        bool isReceived(SequenceType sequence) const
+        {
+            size_t bit = sequence % ReorderWindow;
+            return (receivedWindow[bit / 32] >> (bit % 32)) & 1;
+        }
+
+        void markReceived(SequenceType sequence)
+        {
+            size_t bit = sequence % ReorderWindow;
+            receivedWindow[bit / 32] |= (uint32_t)1 << (bit % 32);
+        }
+
+        void clearReceived(SequenceType sequence)
+        {
+            size_t bit = sequence % ReorderWindow;
+            receivedWindow[bit / 32] &= ~((uint32_t)1 << (bit % 32));
+        }
+
+        void updateLinksStability()
+        {
+            for (size_t i = 0; i < linksAmount; ++i)
+            {
+                links[i].stabilityFilter.update(links[i].receivedInPass_flag ? 100 : 0);
+                links[i].receivedInPass_flag = false;
+            }
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,283 @@
+/**
+ * @file CaptureComm.h
+ * @author Jan Wielgus
+ * @brief Capture taps that record traffic to the trace file (TraceFile.h):
+ * CaptureComm records decoded frames of any transceiver,
+ * CaptureStream records raw bytes of the stream (eg. under StreamComm).
+ * Traffic is passed through unchanged. Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef CAPTURECOMM_H
+#define CAPTURECOMM_H
+
+#include "ITransceiver.h"
+#include "TraceFile.h"
+#include "DataBuffer.h"
+#include <Arduino.h>
+#include <string.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Transceiver that wraps another one and records all sent
+     * (FRAME_SENT) and received (FRAME_RECEIVED) frames.
+     */
+    class CaptureComm : public ITransceiver
+    {
+        ITransceiver* const Transceiver;
+        TraceWriter* const Writer;
+        const uint8_t Channel;
+        DataBuffer reservedBuffer;
+
+    public:
+        /**
+         * @param transceiver Captured transceiver.
+         * @param writer Opened trace file.
+         * @param channel Channel of records (to distinguish many taps in one file).
+         */
+        CaptureComm(ITransceiver* transceiver, TraceWriter* writer, uint8_t channel = 0)
+            : Transceiver(transceiver),
+              Writer(writer),
+              Channel(channel)
+        {
+        }
+
+        CaptureComm(const CaptureComm&) = delete;
+        CaptureComm& operator=(const CaptureComm&) = delete;
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (!Transceiver->send(buffer, size))
+                return false;
+
+            Writer->append(TraceRecordType::FRAME_SENT, Channel, buffer, size);
+            return true;
+        }
+
+        bool sendFrame(FrameBuffer& frame) override
+        {
+            if (!Transceiver->sendFrame(frame))
+                return false;
+
+            Writer->append(TraceRecordType::FRAME_SENT, Channel, frame.getData(), frame.getSize());
+            return true;
+        }
+
+        bool sendShared(SharedFrame& frame) override
+        {
+            if (!Transceiver->sendShared(frame))
+                return false;
+
+            DataBuffer data = frame.getData();
+            Writer->append(TraceRecordType::FRAME_SENT, Channel, data.buffer, data.size);
+            return true;
+        }
+
+        bool sendWithTrailer(const uint8_t* buffer, size_t size) override
+        {
+            if (!Transceiver->sendWithTrailer(buffer, size))
+                return false;
+
+            Writer->append(TraceRecordType::FRAME_SENT, Channel, buffer, size);
+            return true;
+        }
+
+        bool sendParts(const DataBuffer* parts, size_t count) override
+        {
+            if (!Transceiver->sendParts(parts, count))
+                return false;
+
+            Writer->append(TraceRecordType::FRAME_SENT, Channel, parts, count);
+            return true;
+        }
+
+        bool isSendPartsSupported() const override { return Transceiver->isSendPartsSupported(); }
+        SharedFrame::Encoding getFraming() const override { return Transceiver->getFraming(); }
+        SharedFrame::Encoding getReceivedFraming() const override { return Transceiver->getReceivedFraming(); }
+        bool canSend(size_t size) override { return Transceiver->canSend(size); }
+        size_t getPendingSendSize() const override { return Transceiver->getPendingSendSize(); }
+        bool poll() override { return Transceiver->poll(); }
+
+        DataBuffer reserveSendBuffer(size_t size) override
+        {
+            reservedBuffer = Transceiver->reserveSendBuffer(size);
+            return reservedBuffer;
+        }
+
+        bool commitSendBuffer(size_t size) override
+        {
+            // recorded before, the buffer can be reused after commit
+            if (reservedBuffer.buffer == nullptr || size > reservedBuffer.size)
+                return Transceiver->commitSendBuffer(size);
+
+            DataBuffer frame(reservedBuffer.buffer, size);
+            reservedBuffer = DataBuffer();
+            if (!Transceiver->commitSendBuffer(size))
+                return false;
+
+            Writer->append(TraceRecordType::FRAME_SENT, Channel, frame.buffer, frame.size);
+            return true;
+        }
+
+        bool receive() override
+        {
+            if (!Transceiver->receive())
+                return false;
+
+            DataBuffer frame = Transceiver->getReceived();
+            Writer->append(TraceRecordType::FRAME_RECEIVED, Channel, frame.buffer, frame.size);
+            return true;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return Transceiver->getReceived();
+        }
+
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            size_t count = Transceiver->receiveBatch(out, max);
+            for (size_t i = 0; i < count; ++i)
+                Writer->append(TraceRecordType::FRAME_RECEIVED, Channel, out[i].buffer, out[i].size);
+            return count;
+        }
+
+        void selectBatchFrame(size_t index) override
+        {
+            Transceiver->selectBatchFrame(index);
+        }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer) override
+        {
+            Transceiver->setLatencyTracer(tracer);
+        }
+#endif
+    };
+
+
+
+    /**
+     * @brief Stream that wraps another one and records all written (RAW_SENT)
+     * and read (RAW_RECEIVED) bytes, exactly as they were on the wire.
+     * Consecutive small writes (eg. byte by byte) are coalesced into one record,
+     * which is appended before the next read or flush() (or when the bytes don't fit),
+     * so its timestamp is the time of that call.
+     */
+    class CaptureStream : public Stream
+    {
+        static const size_t CoalesceSize = 64;
+
+        Stream* const Wrapped;
+        TraceWriter* const Writer;
+        const uint8_t Channel;
+
+        uint8_t writtenBytes[CoalesceSize]; // written bytes not recorded yet
+        size_t writtenAmount = 0;
+
+    public:
+        /**
+         * @param stream Captured stream.
+         * @param writer Opened trace file.
+         * @param channel Channel of records (to distinguish many taps in one file).
+         */
+        CaptureStream(Stream* stream, TraceWriter* writer, uint8_t channel = 0)
+            : Wrapped(stream),
+              Writer(writer),
+              Channel(channel)
+        {
+        }
+
+        CaptureStream(const CaptureStream&) = delete;
+        CaptureStream& operator=(const CaptureStream&) = delete;
+
+        ~CaptureStream()
+        {
+            recordWritten();
+        }
+
+        size_t write(uint8_t data) override
+        {
+            size_t written = Wrapped->write(data);
+            if (written > 0)
+                coalesceWritten(&data, 1);
+            return written;
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            size_t written = Wrapped->write(buffer, size);
+            if (written > 0)
+                coalesceWritten(buffer, written);
+            return written;
+        }
+
+        int availableForWrite() override { return Wrapped->availableForWrite(); }
+
+        void flush() override
+        {
+            recordWritten();
+            Wrapped->flush();
+        }
+
+        int available() override
+        {
+            recordWritten();
+            return Wrapped->available();
+        }
+
+        int peek() override { return Wrapped->peek(); }
+
+        int read() override
+        {
+            recordWritten();
+            int data = Wrapped->read();
+            if (data >= 0)
+            {
+                uint8_t byte = (uint8_t)data;
+                Writer->append(TraceRecordType::RAW_RECEIVED, Channel, &byte, 1);
+            }
+            return data;
+        }
+
+        size_t readBytes(uint8_t* buffer, size_t length) override
+        {
+            recordWritten();
+            size_t count = Wrapped->readBytes(buffer, length);
+            if (count > 0)
+                Writer->append(TraceRecordType::RAW_RECEIVED, Channel, buffer, count);
+            return count;
+        }
+
+
+    private:
+        void coalesceWritten(const uint8_t* buffer, size_t size)
+        {
+            if (writtenAmount + size > CoalesceSize)
+                recordWritten();
+
+            if (size > CoalesceSize)
+            {
+                Writer->append(TraceRecordType::RAW_SENT, Channel, buffer, size);
+                return;
+            }
+
+            memcpy(writtenBytes + writtenAmount, buffer, size);
+            writtenAmount += size;
+        }
+
+        void recordWritten()
+        {
+            if (writtenAmount == 0)
+                return;
+
+            Writer->append(TraceRecordType::RAW_SENT, Channel, writtenBytes, writtenAmount);
+            writtenAmount = 0;
+        }
+    };
+}
+
+
+#endif
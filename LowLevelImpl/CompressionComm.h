@@ -0,0 +1,264 @@
+/**
+ * @file CompressionComm.h
+ * @author Jan Wielgus
+ * @brief Transceiver that compresses data of chosen packets (LZ4) before
+ * sending them by another transceiver and decompresses them on receive.
+ * @date 2026-10-19
+ */
+
+#ifndef COMPRESSIONCOMM_H
+#define COMPRESSIONCOMM_H
+
+#include "PacketCommConfig.h"
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "DataBuffer.h"
+#include "Encoding/LZ4.h"
+#include <GrowingArray.h>
+#include <string.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Data of chosen packets (eg. big configuration or map packets) is compressed
+     * only when the frame gets smaller, other frames are sent without changes (no overhead).
+     * Compressed frames have the CompressedFlag bit set in the packet ID, so both sides have
+     * to use CompressionComm and IDs of compressed packets can't have this bit set.
+     *
+     * RAM used by the object is about 2 * 2^HashBits bytes (hash table of the compressor, 512 B
+     * by default). Buffers are allocated when needed: one for the biggest compressed frame sent
+     * and one of MaxDataSize + header for each compressed frame in the received batch
+     * (up to PACKETCOMM_RECEIVE_BATCH_SIZE).
+     * @tparam MaxDataSize Max size of data of received compressed packets (after decompression).
+     * @tparam HashBits Work memory of the compressor (see LZ4Compressor). More bits compress
+     * slightly better, 10 (2 KB) is worth it only on devices with plenty of RAM.
+     */
+    template <const size_t MaxDataSize = 4096, const uint8_t HashBits = 8>
+    class CompressionComm : public ITransceiver
+    {
+    public:
+        static const Packet::PacketIDType CompressedFlag = (Packet::PacketIDType)1 << (sizeof(Packet::PacketIDType) * 8 - 1);
+
+    private:
+        struct ReceivingBuffer
+        {
+            AutoDataBuffer storage;
+            ReceivingBuffer() : storage(0) {}
+        };
+
+        ITransceiver* const Transceiver;
+        LZ4Compressor<HashBits> compressor;
+        SimpleDataStructures::GrowingArray<Packet::PacketIDType> compressedPacketIDs;
+        size_t minDataSize = 64; // smaller data rarely gets smaller
+        AutoDataBuffer sendingBuffer;
+        ReceivingBuffer receivingBuffers[PACKETCOMM_RECEIVE_BATCH_SIZE];
+        DataBuffer currentReceived;
+
+        // statistics
+        uint32_t compressedFrames = 0;
+        uint32_t incompressibleFrames = 0; // frames of chosen packets sent without compression
+        uint32_t savedBytes = 0;
+        uint32_t invalidFrames = 0; // received compressed frames that couldn't be decompressed
+
+    public:
+        /**
+         * @param transceiver Low level comm used to send and receive frames.
+         */
+        explicit CompressionComm(ITransceiver* transceiver)
+            : Transceiver(transceiver),
+              sendingBuffer(0)
+        {
+        }
+
+        CompressionComm(const CompressionComm&) = delete;
+        CompressionComm& operator=(const CompressionComm&) = delete;
+
+        /**
+         * @brief Data of packets with this ID will be compressed (if it gets smaller).
+         * @return false if the ID was already added or has the CompressedFlag bit set.
+         */
+        bool addCompressedPacket(Packet::PacketIDType packetID)
+        {
+            if ((packetID & CompressedFlag) != 0 || isCompressed(packetID))
+                return false;
+            return compressedPacketIDs.add(packetID);
+        }
+
+        /**
+         * @brief Packets with less data are not compressed.
+         */
+        void setMinDataSize(size_t size)
+        {
+            minDataSize = size;
+        }
+
+        uint32_t getCompressedFramesAmount() const { return compressedFrames; }
+        uint32_t getIncompressibleFramesAmount() const { return incompressibleFrames; }
+        uint32_t getSavedBytesAmount() const { return savedBytes; }
+        uint32_t getInvalidFramesAmount() const { return invalidFrames; }
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (buffer == nullptr || size == 0)
+                return false;
+
+            FrameBuffer compressed(nullptr, 0, 0);
+            if (compress(buffer, size, compressed))
+                return Transceiver->sendFrame(compressed);
+            return Transceiver->send(buffer, size);
+        }
+
+        bool sendFrame(FrameBuffer& frame) override
+        {
+            if (frame.getSize() == 0)
+                return false;
+
+            FrameBuffer compressed(nullptr, 0, 0);
+            if (compress(frame.getData(), frame.getSize(), compressed))
+                return Transceiver->sendFrame(compressed);
+            return Transceiver->sendFrame(frame);
+        }
+
+        bool receive() override
+        {
+            while (Transceiver->receive())
+            {
+                DataBuffer frame = Transceiver->getReceived();
+                if (decompress(frame, receivingBuffers[0].storage))
+                {
+                    currentReceived = frame;
+                    return true;
+                }
+            }
+
+            currentReceived = DataBuffer();
+            return false;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return currentReceived;
+        }
+
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            if (max > PACKETCOMM_RECEIVE_BATCH_SIZE)
+                max = PACKETCOMM_RECEIVE_BATCH_SIZE; // one receiving buffer for each frame
+
+            size_t received;
+            while ((received = Transceiver->receiveBatch(out, max)) > 0)
+            {
+                // frames that couldn't be decompressed are removed from the batch
+                size_t valid = 0;
+                for (size_t i = 0; i < received; ++i)
+                    if (decompress(out[i], receivingBuffers[valid].storage))
+                        out[valid++] = out[i];
+
+                if (valid > 0)
+                    return valid;
+            }
+
+            return 0;
+        }
+
+        bool canSend(size_t size) override { return Transceiver->canSend(size); } // compressed frames are smaller
+        size_t getPendingSendSize() const override { return Transceiver->getPendingSendSize(); }
+        bool poll() override { return Transceiver->poll(); }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer) override
+        {
+            Transceiver->setLatencyTracer(tracer);
+        }
+#endif
+
+
+    private:
+        bool isCompressed(Packet::PacketIDType packetID) const
+        {
+            for (size_t i = 0; i < compressedPacketIDs.size(); ++i)
+                if (compressedPacketIDs[i] == packetID)
+                    return true;
+            return false;
+        }
+
+        /**
+         * @brief Compress the frame to the sendingBuffer (data is placed after the headroom
+         * and MaxHeaderSize bytes, the header right before the data).
+         * @param compressed Output compressed frame.
+         * @return false if the frame should be sent without compression.
+         */
+        bool compress(const uint8_t* buffer, size_t size, FrameBuffer& compressed)
+        {
+            Packet::Header header;
+            if (!Packet::readHeader(DataBuffer(const_cast<uint8_t*>(buffer), size), header)
+                || header.dataSize == 0 || header.dataSize < minDataSize || !isCompressed(header.id))
+                return false;
+
+            if (!sendingBuffer.ensureAllocatedSize(PACKETCOMM_FRAME_HEADROOM + Packet::MaxHeaderSize + header.dataSize + PACKETCOMM_FRAME_TAILROOM, false))
+                return false;
+
+            uint8_t* data = sendingBuffer.buffer + PACKETCOMM_FRAME_HEADROOM + Packet::MaxHeaderSize;
+            size_t dataSize = compressor.compress(buffer + header.size, header.dataSize, data, header.dataSize - 1);
+
+            uint8_t headerBuffer[Packet::MaxHeaderSize];
+            header.id |= CompressedFlag;
+            header.dataSize = dataSize;
+            size_t headerSize = Packet::writeHeader(headerBuffer, header);
+
+            if (dataSize == 0 || headerSize + dataSize >= size)
+            {
+                incompressibleFrames++;
+                return false;
+            }
+
+            compressed = FrameBuffer(sendingBuffer.buffer, sendingBuffer.AllocatedSize, data - headerSize - sendingBuffer.buffer);
+            memcpy(compressed.pushBack(headerSize + dataSize), headerBuffer, headerSize);
+
+            compressedFrames++;
+            savedBytes += size - headerSize - dataSize;
+            return true;
+        }
+
+        /**
+         * @brief Decompress the frame (if it is compressed) to the storage.
+         * @param frame Received frame, changed to the decompressed frame.
+         * @return false if the frame is invalid and should be dropped.
+         */
+        bool decompress(DataBuffer& frame, AutoDataBuffer& storage)
+        {
+            Packet::Header header;
+            if (!Packet::readHeader(frame, header) || (header.id & CompressedFlag) == 0)
+                return true; // not compressed
+
+            header.id &= ~CompressedFlag;
+            if (!isCompressed(header.id))
+                return true; // ID with the highest bit set that is not compressed
+
+            if (!storage.ensureAllocatedSize(Packet::MaxHeaderSize + MaxDataSize, false))
+            {
+                invalidFrames++;
+                return false;
+            }
+
+            uint8_t* data = storage.buffer + Packet::MaxHeaderSize;
+            header.dataSize = LZ4::decompress(frame.buffer + header.size, header.dataSize, data, MaxDataSize);
+            if (header.dataSize == 0)
+            {
+                invalidFrames++;
+                return false;
+            }
+
+            uint8_t headerBuffer[Packet::MaxHeaderSize];
+            size_t headerSize = Packet::writeHeader(headerBuffer, header);
+            memcpy(data - headerSize, headerBuffer, headerSize);
+
+            frame = DataBuffer(data - headerSize, headerSize + header.dataSize);
+            return true;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file ConcurrentDataPacket.h
+ * @author Jan Wielgus
+ * @brief Data packet which payload can be written by one thread
+ * and read by other threads at the same time without torn values (seqlock).
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef CONCURRENTDATAPACKET_H
+#define CONCURRENTDATAPACKET_H
+
+#include "Packet.h"
+#include <string.h>
+#include <atomic>
+#include <memory>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Data packet with its own payload storage protected by a seqlock.
+     * There can be only one writer thread at a time: the I/O thread for received
+     * packets (payload is updated during receiving) or the application thread
+     * for packets that are sent. Any amount of threads can read the payload,
+     * readers never block the writer.
+     */
+    class ConcurrentDataPacket : public Packet
+    {
+        typedef uint64_t Word;
+
+        const size_t PayloadSize;
+        const size_t WordsAmount;
+        std::unique_ptr<std::atomic<Word>[]> words;
+        std::atomic<uint32_t> sequence; // odd while payload is written
+
+    public:
+        /**
+         * @param packetID Unique ID of the packet.
+         * @param payloadSize Size of the payload in bytes.
+         * @param onReceiveCallback (optional) pointer to void function
+         * that will be called (in the I/O thread) each time after receiving this packet.
+         */
+        ConcurrentDataPacket(PacketIDType packetID, size_t payloadSize, Callback onReceiveCallback = nullptr)
+            : Packet(packetID, Type::DATA, onReceiveCallback),
+              PayloadSize(payloadSize),
+              WordsAmount((payloadSize + sizeof(Word) - 1) / sizeof(Word)),
+              words(new std::atomic<Word>[WordsAmount > 0 ? WordsAmount : 1]),
+              sequence(0)
+        {
+            for (size_t i = 0; i < WordsAmount; ++i)
+                words[i].store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Copy consistent payload (never mixed with the concurrent update).
+         * @param output Buffer of at least getPayloadSize() bytes.
+         * @return Version of the copied payload (see getVersion()).
+         */
+        uint32_t read(uint8_t* output) const
+        {
+            while (true)
+            {
+                uint32_t before = sequence.load(std::memory_order_acquire);
+                if (before & 1)
+                    continue; // write in progress
+
+                copyFromWords(output);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                    return before / 2;
+            }
+        }
+
+        /**
+         * @brief Read payload as a value (eg. struct with the same layout as the sent one).
+         * @return Payload or value initialized T if payload size is not sizeof(T).
+         */
+        template <class T>
+        T read() const
+        {
+            T value = T();
+            if (PayloadSize != sizeof(T))
+                return value;
+
+            uint8_t buffer[sizeof(T)];
+            read(buffer);
+            memcpy(&value, buffer, sizeof(T));
+            return value;
+        }
+
+        /**
+         * @brief Set new payload (only one writer thread at a time).
+         * @param input Buffer of at least getPayloadSize() bytes.
+         */
+        void write(const uint8_t* input)
+        {
+            uint32_t current = sequence.load(std::memory_order_relaxed);
+            sequence.store(current + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            copyToWords(input);
+
+            sequence.store(current + 2, std::memory_order_release);
+        }
+
+        /**
+         * @return Incremented after each payload update (can be used to check
+         * if new data were received since the last read()).
+         */
+        uint32_t getVersion() const
+        {
+            return sequence.load(std::memory_order_acquire) / 2;
+        }
+
+        size_t getPayloadSize() const
+        {
+            return PayloadSize;
+        }
+
+    protected:
+        size_t getDataOnly(uint8_t* outputBuffer) const override
+        {
+            read(outputBuffer);
+            return PayloadSize;
+        }
+
+        size_t getDataOnlySize() const override
+        {
+            return PayloadSize;
+        }
+
+        void updateDataOnly(const uint8_t* inputBuffer) override
+        {
+            write(inputBuffer);
+        }
+
+    private:
+        void copyFromWords(uint8_t* output) const
+        {
+            size_t fullWords = PayloadSize / sizeof(Word);
+            for (size_t i = 0; i < fullWords; ++i)
+            {
+                Word word = words[i].load(std::memory_order_relaxed);
+                memcpy(output + i * sizeof(Word), &word, sizeof(Word));
+            }
+
+            size_t rest = PayloadSize - fullWords * sizeof(Word);
+            if (rest > 0)
+            {
+                Word word = words[fullWords].load(std::memory_order_relaxed);
+                memcpy(output + fullWords * sizeof(Word), &word, rest);
+            }
+        }
+
+        void copyToWords(const uint8_t* input)
+        {
+            size_t fullWords = PayloadSize / sizeof(Word);
+            for (size_t i = 0; i < fullWords; ++i)
+            {
+                Word word;
+                memcpy(&word, input + i * sizeof(Word), sizeof(Word));
+                words[i].store(word, std::memory_order_relaxed);
+            }
+
+            size_t rest = PayloadSize - fullWords * sizeof(Word);
+            if (rest > 0)
+            {
+                Word word = 0;
+                memcpy(&word, input + fullWords * sizeof(Word), rest);
+                words[fullWords].store(word, std::memory_order_relaxed);
+            }
+        }
+    };
+}
+
+
+#endif
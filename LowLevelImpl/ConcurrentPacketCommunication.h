@@ -0,0 +1,358 @@
+/**
+ * @file ConcurrentPacketCommunication.h
+ * @author Jan Wielgus
+ * @brief PacketCommunication used from the application thread while
+ * receiving, decoding and sending is done by the I/O thread.
+ * Threads exchange frames through lock-free single producer single consumer queues.
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef CONCURRENTPACKETCOMMUNICATION_H
+#define CONCURRENTPACKETCOMMUNICATION_H
+
+#include "PacketCommunication.h"
+#include "LinuxEventLoop.h"
+#include "LockFreeQueues.h"
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <atomic>
+#include <thread>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Packet communication split between two threads:
+     * - application thread: send() (packet is serialized and queued),
+     *   pollReceivedFrames(), getConnectionStability(),
+     * - I/O thread: processIO() (queued frames are sent, received frames
+     *   update registered packets and are published to the application).
+     * Registered packets are updated and their callbacks are executed in the I/O thread,
+     * use ConcurrentDataPacket to read them safely from the application thread.
+     * The I/O thread can be started by startIOThread() or be any user thread
+     * that calls processIO() (eg. when getDoorbellFd() or the transceiver is readable,
+     * and periodically while hasQueuedFrames()).
+     * Packets have to be registered before the I/O thread starts. receive() is done
+     * by processIO(), so it is not available.
+     * @tparam MaxFrameSize Max size of the sent and received frames.
+     */
+    template <const size_t MaxFrameSize>
+    class ConcurrentPacketCommunication : public PacketCommunication
+    {
+        static_assert(MaxFrameSize <= 0xFFFF, "Frame::size is uint16_t");
+
+    public:
+        struct Frame
+        {
+            uint16_t size;
+            uint8_t data[MaxFrameSize];
+        };
+
+    private:
+        /**
+         * @brief Passes transceiver through and publishes received frames.
+         */
+        class ReceiveTap : public ITransceiver
+        {
+            ConcurrentPacketCommunication* const Owner;
+
+        public:
+            ITransceiver* const Transceiver;
+
+            ReceiveTap(ConcurrentPacketCommunication* owner, ITransceiver* transceiver)
+                : Owner(owner),
+                  Transceiver(transceiver)
+            {
+            }
+
+            bool send(const uint8_t* buffer, size_t size) override { return Transceiver->send(buffer, size); }
+            bool send(const AutoDataBuffer& buffer) override { return Transceiver->send(buffer); }
+            bool sendFrame(FrameBuffer& frame) override { return Transceiver->sendFrame(frame); }
+            bool sendParts(const DataBuffer* parts, size_t count) override { return Transceiver->sendParts(parts, count); }
+            bool sendShared(SharedFrame& frame) override { return Transceiver->sendShared(frame); }
+            bool sendWithTrailer(const uint8_t* buffer, size_t size) override { return Transceiver->sendWithTrailer(buffer, size); }
+            SharedFrame::Encoding getFraming() const override { return Transceiver->getFraming(); }
+            SharedFrame::Encoding getReceivedFraming() const override { return Transceiver->getReceivedFraming(); }
+            bool isSendPartsSupported() const override { return Transceiver->isSendPartsSupported(); }
+            DataBuffer reserveSendBuffer(size_t size) override { return Transceiver->reserveSendBuffer(size); }
+            bool commitSendBuffer(size_t size) override { return Transceiver->commitSendBuffer(size); }
+            const DataBuffer getReceived() override { return Transceiver->getReceived(); }
+            bool canSend(size_t size) override { return Transceiver->canSend(size); }
+            size_t getPendingSendSize() const override { return Transceiver->getPendingSendSize(); }
+            bool poll() override { return Transceiver->poll(); }
+
+            bool receive() override
+            {
+                if (!Transceiver->receive())
+                    return false;
+                if (Owner->framePublishing_flag.load(std::memory_order_relaxed))
+                    Owner->publishFrame(Transceiver->getReceived());
+                return true;
+            }
+
+            size_t receiveBatch(DataBuffer* out, size_t max) override
+            {
+                size_t count = Transceiver->receiveBatch(out, max);
+                if (Owner->framePublishing_flag.load(std::memory_order_relaxed))
+                    for (size_t i = 0; i < count; ++i)
+                        Owner->publishFrame(out[i]);
+                return count;
+            }
+
+            void selectBatchFrame(size_t index) override { Transceiver->selectBatchFrame(index); }
+
+#if PACKETCOMM_LATENCY_TRACING
+            void setLatencyTracer(LatencyTracer* tracer) override { Transceiver->setLatencyTracer(tracer); }
+#endif
+        };
+
+        // tap is constructed after the base, but base only stores its address
+        ReceiveTap tap;
+        SPSCQueue<Frame> sendQueue;     // application -> I/O thread
+        SPSCQueue<Frame> receivedQueue; // I/O thread -> application
+        std::atomic<bool> framePublishing_flag;
+
+        int doorbellFd;
+        std::atomic<bool> doorbellPending;
+        std::atomic<Percentage> connectionStability;
+
+        std::thread ioThread;
+        std::atomic<bool> ioRunning;
+
+        // statistics
+        std::atomic<uint32_t> droppedSends;
+        std::atomic<uint32_t> droppedReceivedFrames;
+
+
+    public:
+        /**
+         * @param lowLevelComm Transceiver (used only by the I/O thread).
+         * @param sendQueueCapacity Max amount of frames waiting to be sent.
+         * @param receiveQueueCapacity Max amount of received frames waiting for the application.
+         */
+        explicit ConcurrentPacketCommunication(ITransceiver* lowLevelComm, size_t sendQueueCapacity = 256, size_t receiveQueueCapacity = 256)
+            : PacketCommunication(&tap),
+              tap(this, lowLevelComm),
+              sendQueue(sendQueueCapacity),
+              receivedQueue(receiveQueueCapacity),
+              framePublishing_flag(false),
+              doorbellFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+              doorbellPending(false),
+              connectionStability(0),
+              ioRunning(false),
+              droppedSends(0),
+              droppedReceivedFrames(0)
+        {
+        }
+
+        ~ConcurrentPacketCommunication()
+        {
+            stopIOThread();
+            if (doorbellFd >= 0)
+                ::close(doorbellFd);
+        }
+
+
+        /**
+         * @brief Same as PacketCommunication::registerReceivePacket(), but registered packets
+         * are read by the I/O thread without synchronization, so register them before startIOThread()
+         * (or before another thread starts calling processIO()).
+         * @return false also if the I/O thread started by startIOThread() is running.
+         */
+        bool registerReceivePacket(Packet* receivePacket)
+        {
+            if (ioThread.joinable())
+                return false;
+            return PacketCommunication::registerReceivePacket(receivePacket);
+        }
+
+        /**
+         * @brief Application thread: serialize the packet and queue it for the I/O thread.
+         * @return false if packet is too big or the send queue is full.
+         */
+        bool send(const Packet* packetToSend) override
+        {
+            size_t packetSize = packetToSend->getSize();
+            Frame* frame = packetSize <= MaxFrameSize ? sendQueue.beginPush() : nullptr;
+            if (frame == nullptr)
+            {
+                droppedSends.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            frame->size = (uint16_t)packetSize;
+            packetToSend->getBuffer(frame->data);
+            sendQueue.commitPush();
+
+            // Only the first frame after the I/O thread woke up rings the doorbell
+            if (!doorbellPending.exchange(true, std::memory_order_seq_cst))
+            {
+                uint64_t one = 1;
+                ssize_t ignored = ::write(doorbellFd, &one, sizeof(one));
+                (void)ignored;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Application thread: pass received frames (whole packets, including ID)
+         * to the callback. Frames are published only if enabled by setFramePublishing().
+         * @param callback Function called as callback(const Frame&).
+         * @param maxFrames Max amount of passed frames.
+         * @return Amount of passed frames.
+         */
+        template <class Callback>
+        size_t pollReceivedFrames(Callback&& callback, size_t maxFrames = (size_t)-1)
+        {
+            size_t passed = 0;
+            Frame* frame;
+            while (passed < maxFrames && (frame = receivedQueue.front()) != nullptr)
+            {
+                callback(static_cast<const Frame&>(*frame));
+                receivedQueue.pop();
+                passed++;
+            }
+            return passed;
+        }
+
+        /**
+         * @brief Publish all received frames to the application thread (see pollReceivedFrames()).
+         * Registered packets are updated anyway.
+         */
+        void setFramePublishing(bool enabled)
+        {
+            framePublishing_flag = enabled;
+        }
+
+        /**
+         * @brief Can be called from any thread (value is updated after each processIO()).
+         */
+        Percentage getConnectionStability() override
+        {
+            return connectionStability.load(std::memory_order_relaxed);
+        }
+
+
+        /**
+         * @brief I/O thread: send queued frames and receive all available data.
+         * @return Amount of sent frames.
+         */
+        size_t processIO()
+        {
+            uint64_t counter;
+            ssize_t ignored = ::read(doorbellFd, &counter, sizeof(counter));
+            (void)ignored;
+            doorbellPending.store(false, std::memory_order_seq_cst);
+
+            tap.Transceiver->poll();
+
+            size_t sent = 0;
+            Frame* frame;
+            while ((frame = sendQueue.front()) != nullptr)
+            {
+                if (!tap.Transceiver->canSend(frame->size))
+                    break; // non-blocking transceiver is full, frames wait for the next processIO()
+                if (!tap.Transceiver->send(frame->data, frame->size))
+                    droppedSends.fetch_add(1, std::memory_order_relaxed);
+                sendQueue.pop();
+                sent++;
+            }
+
+            PacketCommunication::receive();
+            connectionStability.store(PacketCommunication::getConnectionStability(), std::memory_order_relaxed);
+            return sent;
+        }
+
+        /**
+         * @brief I/O thread: true if queued frames are waiting, because the transceiver
+         * couldn't take them (the doorbell is not rung again for them, call processIO() later).
+         */
+        bool hasQueuedFrames()
+        {
+            return sendQueue.front() != nullptr;
+        }
+
+        /**
+         * @return eventfd that becomes readable when frames are queued to send
+         * (wait for it in the I/O thread together with the transceiver descriptor).
+         */
+        int getDoorbellFd() const
+        {
+            return doorbellFd;
+        }
+
+        /**
+         * @brief Start own I/O thread that calls processIO() when there are frames
+         * to send or data to receive.
+         * @param transceiverFd Descriptor that is readable when transceiver has data
+         * (see getFileDescriptor() of Linux transceivers) or -1 to check the transceiver
+         * every pollInterval_ms.
+         * @param pollInterval_ms Used if transceiverFd is -1 or frames wait for the transceiver.
+         * @return false if thread is already running.
+         */
+        bool startIOThread(int transceiverFd, int pollInterval_ms = 1)
+        {
+            if (ioThread.joinable() || doorbellFd < 0)
+                return false;
+
+            ioRunning = true;
+            ioThread = std::thread([this, transceiverFd, pollInterval_ms]() {
+                LinuxEventLoop loop;
+                loop.addFileDescriptor(doorbellFd, [this]() { processIO(); });
+                if (transceiverFd >= 0)
+                    loop.addFileDescriptor(transceiverFd, [this]() { processIO(); });
+
+                while (ioRunning.load(std::memory_order_relaxed))
+                {
+                    // Frames that the transceiver couldn't take are retried after pollInterval_ms
+                    bool periodic = transceiverFd < 0 || hasQueuedFrames();
+                    size_t handled = loop.runOnce(periodic ? pollInterval_ms : -1);
+                    if (periodic && handled == 0)
+                        processIO();
+                }
+            });
+            return true;
+        }
+
+        /**
+         * @brief Stop and join the I/O thread started by startIOThread().
+         */
+        void stopIOThread()
+        {
+            if (!ioThread.joinable())
+                return;
+
+            ioRunning = false;
+            uint64_t one = 1;
+            ssize_t ignored = ::write(doorbellFd, &one, sizeof(one));
+            (void)ignored;
+            ioThread.join();
+        }
+
+        uint32_t getDroppedSendsAmount() const { return droppedSends.load(std::memory_order_relaxed); }
+        uint32_t getDroppedReceivedFramesAmount() const { return droppedReceivedFrames.load(std::memory_order_relaxed); }
+
+
+    private:
+        using PacketCommunication::receive; // called only by processIO()
+
+        void publishFrame(const DataBuffer& received)
+        {
+            Frame* frame = received.size <= MaxFrameSize ? receivedQueue.beginPush() : nullptr;
+            if (frame == nullptr)
+            {
+                droppedReceivedFrames.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            frame->size = (uint16_t)received.size;
+            memcpy(frame->data, received.buffer, received.size);
+            receivedQueue.commitPush();
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file HopLimitComm.h
+ * @author Jan Wielgus
+ * @brief Transceiver used by endpoints of the mesh with PacketRouter relays
+ * that use the hop limit. Adds the hop limit byte before each sent frame
+ * and removes it from received frames.
+ * @date 2026-10-19
+ */
+
+#ifndef HOPLIMITCOMM_H
+#define HOPLIMITCOMM_H
+
+#include "PacketCommConfig.h"
+#include "ITransceiver.h"
+#include "PacketRouter.h"
+#include "DataBuffer.h"
+#include <string.h>
+
+
+namespace PacketComm
+{
+    class HopLimitComm : public ITransceiver
+    {
+        ITransceiver* const Transceiver;
+        PacketRouter::HopLimitType hopLimit;
+        AutoDataBuffer sendingBuffer;
+        DataBuffer currentReceived;
+
+    public:
+        /**
+         * @param transceiver Low level comm connected to the mesh.
+         * @param hopLimit Max amount of routers that can forward sent frames.
+         */
+        HopLimitComm(ITransceiver* transceiver, PacketRouter::HopLimitType hopLimit)
+            : Transceiver(transceiver),
+              hopLimit(hopLimit),
+              sendingBuffer(0)
+        {
+        }
+
+        HopLimitComm(const HopLimitComm&) = delete;
+        HopLimitComm& operator=(const HopLimitComm&) = delete;
+
+        void setHopLimit(PacketRouter::HopLimitType hopLimit)
+        {
+            this->hopLimit = hopLimit;
+        }
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (buffer == nullptr || size == 0)
+                return false;
+
+            size_t headerSize = PacketRouter::HopHeaderSize;
+            if (!sendingBuffer.ensureAllocatedSize(headerSize + size + PACKETCOMM_FRAME_TAILROOM, false))
+                return false;
+
+            FrameBuffer frame(sendingBuffer.buffer, sendingBuffer.AllocatedSize, headerSize);
+            memcpy(frame.pushBack(size), buffer, size);
+            return sendFrame(frame);
+        }
+
+        bool sendFrame(FrameBuffer& frame) override
+        {
+            if (frame.getSize() == 0)
+                return false;
+
+            uint8_t* header = frame.pushFront(PacketRouter::HopHeaderSize);
+            if (header == nullptr)
+                return send(frame.getData(), frame.getSize()); // copied to the buffer with headroom
+
+            *header = hopLimit;
+            bool result = Transceiver->sendFrame(frame);
+            frame.popFront(PacketRouter::HopHeaderSize);
+            return result;
+        }
+
+        bool receive() override
+        {
+            while (Transceiver->receive())
+            {
+                DataBuffer frame = Transceiver->getReceived();
+                if (removeHeader(frame))
+                {
+                    currentReceived = frame;
+                    return true;
+                }
+            }
+
+            currentReceived = DataBuffer();
+            return false;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return currentReceived;
+        }
+
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            size_t received;
+            while ((received = Transceiver->receiveBatch(out, max)) > 0)
+            {
+                // frames without the header are removed from the batch
+                size_t valid = 0;
+                for (size_t i = 0; i < received; ++i)
+                    if (removeHeader(out[i]))
+                        out[valid++] = out[i];
+
+                if (valid > 0)
+                    return valid;
+            }
+
+            return 0;
+        }
+
+        bool canSend(size_t size) override { return Transceiver->canSend(PacketRouter::HopHeaderSize + size); }
+        size_t getPendingSendSize() const override { return Transceiver->getPendingSendSize(); }
+        bool poll() override { return Transceiver->poll(); }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer) override
+        {
+            Transceiver->setLatencyTracer(tracer);
+        }
+#endif
+
+
+    private:
+        static bool removeHeader(DataBuffer& frame)
+        {
+            if (frame.size <= PacketRouter::HopHeaderSize)
+                return false;
+
+            frame.buffer += PacketRouter::HopHeaderSize;
+            frame.size -= PacketRouter::HopHeaderSize;
+            return true;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,364 @@
+/**
+ * @file LinuxEventLoop.h
+ * @author Jan Wielgus
+ * @brief Event loop for PacketCommunication instances on Linux.
+ * Waits on file descriptors of the transceivers (serial port, UDP socket,
+ * shared memory doorbell eventfd) using epoll and calls receive() only
+ * when there are data to read. Also drives timers (eg. periodic sends)
+ * with microsecond resolution (timerfd).
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef LINUXEVENTLOOP_H
+#define LINUXEVENTLOOP_H
+
+#include "PacketCommunication.h"
+#include "Packet.h"
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+
+namespace PacketComm
+{
+    class LinuxEventLoop
+    {
+    public:
+        typedef uint32_t TimerID;
+        static const TimerID NoTimer = 0;
+        typedef std::function<void()> Handler;
+
+    private:
+        struct Timer
+        {
+            uint64_t deadline_ns;
+            uint64_t interval_ns; // 0 - single shot
+            Handler callback;
+        };
+
+        int epollFd = -1;
+        int timerFd = -1;
+        bool running = false;
+
+        std::unordered_map<int, Handler> fdHandlers;
+        std::unordered_map<TimerID, Timer> timers;
+        std::multimap<uint64_t, TimerID> timerQueue; // deadline -> timer (may contain removed timers)
+        TimerID lastTimerID = NoTimer;
+        uint64_t armedDeadline_ns = 0;
+
+        std::vector<epoll_event> events;
+
+        // statistics
+        uint32_t wakeups = 0;
+        uint32_t handledEvents = 0;
+        uint32_t firedTimers = 0;
+
+
+    public:
+        /**
+         * @param maxEventsPerWakeup Max amount of ready file descriptors handled after one epoll_wait.
+         */
+        explicit LinuxEventLoop(size_t maxEventsPerWakeup = 64)
+            : events(maxEventsPerWakeup > 0 ? maxEventsPerWakeup : 1)
+        {
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
+            timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+            if (epollFd >= 0 && timerFd >= 0)
+            {
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.fd = timerFd;
+                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event) != 0)
+                    closeDescriptors();
+            }
+        }
+
+        LinuxEventLoop(const LinuxEventLoop&) = delete;
+        LinuxEventLoop& operator=(const LinuxEventLoop&) = delete;
+
+        ~LinuxEventLoop()
+        {
+            closeDescriptors();
+        }
+
+        /**
+         * @return false if epoll or timerfd could not be created.
+         */
+        bool isValid() const
+        {
+            return epollFd >= 0 && timerFd >= 0;
+        }
+
+
+        /**
+         * @brief Call comm->receive() every time there are data to read from the file descriptor.
+         * @param comm Communication instance.
+         * @param fd File descriptor of its transceiver (see getFileDescriptor() of Linux transceivers).
+         * @return false if descriptor is invalid or was already added.
+         */
+        bool addCommunication(PacketCommunication* comm, int fd)
+        {
+            if (comm == nullptr)
+                return false;
+            return addFileDescriptor(fd, [comm]() { comm->receive(); });
+        }
+
+        /**
+         * @brief Call handler every time the file descriptor is readable (level triggered,
+         * so handler should read all available data).
+         * @param oneShot If true, descriptor is disabled after each event
+         * until rearmFileDescriptor() is called (eg. when data are read by another thread).
+         * @return false if descriptor is invalid or was already added.
+         */
+        bool addFileDescriptor(int fd, Handler onReadable, bool oneShot = false)
+        {
+            if (!isValid() || fd < 0 || !onReadable || fdHandlers.count(fd) > 0)
+                return false;
+
+            epoll_event event;
+            event.events = oneShot ? (EPOLLIN | EPOLLONESHOT) : EPOLLIN;
+            event.data.fd = fd;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+                return false;
+
+            fdHandlers[fd] = std::move(onReadable);
+            return true;
+        }
+
+        /**
+         * @brief Enable one shot descriptor again (see addFileDescriptor()).
+         * Can be called from any thread.
+         */
+        bool rearmFileDescriptor(int fd)
+        {
+            epoll_event event;
+            event.events = EPOLLIN | EPOLLONESHOT;
+            event.data.fd = fd;
+            return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == 0;
+        }
+
+        /**
+         * @brief Stop watching the file descriptor (call it before closing the descriptor).
+         * Can be called from handlers.
+         */
+        bool removeFileDescriptor(int fd)
+        {
+            if (fdHandlers.erase(fd) == 0)
+                return false;
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            return true;
+        }
+
+
+        /**
+         * @brief Call callback after interval (and then every interval if repeat is true).
+         * Can be called from handlers.
+         * @param interval_us Time in microseconds.
+         * @return ID of the timer (needed to remove it) or NoTimer if loop is invalid.
+         */
+        TimerID addTimer(uint32_t interval_us, Handler callback, bool repeat = true)
+        {
+            if (!isValid() || !callback)
+                return NoTimer;
+
+            TimerID id = ++lastTimerID;
+            if (id == NoTimer)
+                id = ++lastTimerID;
+
+            uint64_t interval_ns = (uint64_t)interval_us * 1000;
+            Timer timer;
+            timer.deadline_ns = getTime_ns() + interval_ns;
+            timer.interval_ns = repeat ? (interval_ns > 0 ? interval_ns : 1) : 0;
+            timer.callback = std::move(callback);
+
+            timerQueue.emplace(timer.deadline_ns, id);
+            timers[id] = std::move(timer);
+            armTimer();
+            return id;
+        }
+
+        /**
+         * @brief Send packet every interval.
+         * @return ID of the timer or NoTimer.
+         */
+        TimerID scheduleSend(PacketCommunication* comm, const Packet* packet, uint32_t interval_us)
+        {
+            if (comm == nullptr || packet == nullptr)
+                return NoTimer;
+            return addTimer(interval_us, [comm, packet]() { comm->send(packet); });
+        }
+
+        /**
+         * @brief Remove timer (can be called from handlers, also from its own callback).
+         */
+        bool removeTimer(TimerID id)
+        {
+            return timers.erase(id) > 0; // queue entry is skipped later
+        }
+
+        size_t getTimersAmount() const
+        {
+            return timers.size();
+        }
+
+
+        /**
+         * @brief Wait for events and handle them.
+         * @param timeout_ms Max waiting time in milliseconds (0 - don't wait, negative - no limit).
+         * @return Amount of handled events (ready descriptors and fired timers).
+         */
+        size_t runOnce(int timeout_ms = -1)
+        {
+            if (!isValid())
+                return 0;
+
+            int ready;
+            do
+                ready = epoll_wait(epollFd, events.data(), (int)events.size(), timeout_ms);
+            while (ready < 0 && errno == EINTR);
+
+            if (ready <= 0)
+                return 0;
+
+            wakeups++;
+            size_t handled = 0;
+            for (int i = 0; i < ready; ++i)
+            {
+                int fd = events[i].data.fd;
+                if (fd == timerFd)
+                {
+                    handled += handleTimers();
+                    continue;
+                }
+
+                // handler could be removed by another handler
+                auto found = fdHandlers.find(fd);
+                if (found == fdHandlers.end())
+                    continue;
+
+                Handler handler = found->second; // copy, handler may remove itself
+                handler();
+                handled++;
+            }
+
+            handledEvents += handled;
+            return handled;
+        }
+
+        /**
+         * @brief Handle events until stop() is called.
+         */
+        void run()
+        {
+            running = true;
+            while (running && isValid())
+                runOnce(-1);
+        }
+
+        /**
+         * @brief Stop run() after handling current events (call it from handlers).
+         */
+        void stop()
+        {
+            running = false;
+        }
+
+        uint32_t getWakeupsAmount() const { return wakeups; }
+        uint32_t getHandledEventsAmount() const { return handledEvents; }
+        uint32_t getFiredTimersAmount() const { return firedTimers; }
+
+
+    private:
+        static uint64_t getTime_ns()
+        {
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+        }
+
+        /**
+         * @brief Set timerfd to the earliest timer deadline (or disarm it).
+         */
+        void armTimer()
+        {
+            while (!timerQueue.empty() && timers.count(timerQueue.begin()->second) == 0)
+                timerQueue.erase(timerQueue.begin()); // removed timer
+
+            uint64_t deadline_ns = timerQueue.empty() ? 0 : timerQueue.begin()->first;
+            if (deadline_ns == armedDeadline_ns)
+                return;
+
+            itimerspec setting = {};
+            setting.it_value.tv_sec = deadline_ns / 1000000000ull;
+            setting.it_value.tv_nsec = deadline_ns % 1000000000ull;
+            timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &setting, nullptr);
+            armedDeadline_ns = deadline_ns;
+        }
+
+        size_t handleTimers()
+        {
+            uint64_t expirations;
+            ssize_t ignored = ::read(timerFd, &expirations, sizeof(expirations));
+            (void)ignored;
+            armedDeadline_ns = 0;
+
+            size_t fired = 0;
+            uint64_t now_ns = getTime_ns();
+            while (!timerQueue.empty() && timerQueue.begin()->first <= now_ns)
+            {
+                TimerID id = timerQueue.begin()->second;
+                timerQueue.erase(timerQueue.begin());
+
+                auto found = timers.find(id);
+                if (found == timers.end())
+                    continue; // removed
+
+                Handler callback = found->second.callback; // copy, callback may remove the timer
+                callback();
+                fired++;
+
+                found = timers.find(id);
+                if (found == timers.end())
+                    continue;
+
+                Timer& timer = found->second;
+                if (timer.interval_ns == 0)
+                {
+                    timers.erase(found);
+                    continue;
+                }
+
+                // Keep the period, but don't try to catch up after a long delay
+                timer.deadline_ns += timer.interval_ns;
+                if (timer.deadline_ns <= now_ns)
+                    timer.deadline_ns = now_ns + timer.interval_ns;
+                timerQueue.emplace(timer.deadline_ns, id);
+            }
+
+            firedTimers += fired;
+            armTimer();
+            return fired;
+        }
+
+        void closeDescriptors()
+        {
+            if (epollFd >= 0)
+                ::close(epollFd);
+            if (timerFd >= 0)
+                ::close(timerFd);
+            epollFd = timerFd = -1;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,521 @@
+/**
+ * @file LinuxSerialComm.h
+ * @author Jan Wielgus
+ * @brief Serial communication on Linux (/dev/tty*, pseudo terminals) using termios.
+ * Uses the same framing (COBS + checksum) as StreamComm on microcontrollers,
+ * because it is StreamComm working on the file descriptor based Stream.
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef LINUXSERIALCOMM_H
+#define LINUXSERIALCOMM_H
+
+#include "StreamComm.h"
+#include <Arduino.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+#include <vector>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Configuration of the serial port.
+     */
+    struct SerialConfig
+    {
+        uint32_t baudRate = 115200;
+        bool nonBlocking = true;   // read() never waits (VMIN and VTIME are used only if false)
+        uint8_t vmin = 0;          // blocking mode: minimum amount of bytes returned by one read
+        uint8_t vtime = 0;         // blocking mode: read timeout in tenths of a second
+        bool lowLatency = true;    // set ASYNC_LOW_LATENCY flag (ignored by drivers that don't support it)
+        size_t readChunkSize = 4096;   // max amount of bytes read by one syscall
+        size_t writeBufferSize = 65536; // bytes waiting to be written to the port
+        int writeTimeout_ms = 1000;     // max time of waiting for the port when the write buffer is full (or in flush()), then the write fails
+    };
+
+
+
+    /**
+     * @brief Arduino Stream over a serial port file descriptor.
+     * Bytes are read in big chunks (one syscall per readChunkSize bytes)
+     * and served from the internal buffer. Written bytes are buffered
+     * and written by flush() or when the buffer is full, so a whole frame
+     * can be written by a single syscall. If the port doesn't accept bytes
+     * for SerialConfig::writeTimeout_ms, write() returns less than it was given.
+     */
+    class PosixSerialStream : public Stream
+    {
+        int fd = -1;
+        bool ownsFd = false;
+        SerialConfig config;
+
+        std::vector<uint8_t> readBuffer;
+        size_t readBegin = 0;
+        size_t readEnd = 0;
+
+        std::vector<uint8_t> writeBuffer;
+        size_t writeBegin = 0;
+        size_t writeEnd = 0;
+
+    public:
+        PosixSerialStream() = default;
+
+        PosixSerialStream(const PosixSerialStream&) = delete;
+        PosixSerialStream& operator=(const PosixSerialStream&) = delete;
+
+        ~PosixSerialStream()
+        {
+            close();
+        }
+
+        /**
+         * @brief Open and configure serial port.
+         * @param path Path to the device (eg. /dev/ttyUSB0).
+         * @param serialConfig Configuration of the port.
+         * @return false if port could not be opened or configured.
+         */
+        bool open(const char* path, const SerialConfig& serialConfig = SerialConfig())
+        {
+            close();
+
+            int newFd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+            if (newFd < 0)
+                return false;
+
+            if (!adopt(newFd, serialConfig))
+            {
+                ::close(newFd);
+                return false;
+            }
+
+            ownsFd = true;
+            return true;
+        }
+
+        /**
+         * @brief Use already opened file descriptor (eg. master side of a pseudo terminal).
+         * File descriptor will not be closed by this class.
+         * @param existingFd Opened file descriptor of a terminal.
+         * @param serialConfig Configuration of the port.
+         * @return false if terminal could not be configured.
+         */
+        bool adopt(int existingFd, const SerialConfig& serialConfig = SerialConfig())
+        {
+            close();
+
+            config = serialConfig;
+            if (!configureTerminal(existingFd))
+                return false;
+
+            fd = existingFd;
+            ownsFd = false;
+            readBuffer.resize(config.readChunkSize > 0 ? config.readChunkSize : 1);
+            writeBuffer.resize(config.writeBufferSize > 0 ? config.writeBufferSize : 1);
+            readBegin = readEnd = 0;
+            writeBegin = writeEnd = 0;
+            return true;
+        }
+
+        /**
+         * @brief Write pending bytes (if possible) and close the port.
+         */
+        void close()
+        {
+            if (fd < 0)
+                return;
+
+            flushPending();
+            if (ownsFd)
+                ::close(fd);
+            fd = -1;
+            ownsFd = false;
+        }
+
+        bool isOpen() const
+        {
+            return fd >= 0;
+        }
+
+        /**
+         * @return File descriptor of the port (eg. to wait for data using poll/epoll)
+         * or -1 if port is closed.
+         */
+        int getFileDescriptor() const
+        {
+            return fd;
+        }
+
+        /**
+         * @return Amount of bytes written to this stream but not yet to the port.
+         */
+        size_t getPendingWriteSize() const
+        {
+            return writeEnd - writeBegin;
+        }
+
+        /**
+         * @brief Try to write pending bytes without waiting.
+         * @return true if all pending bytes were written.
+         */
+        bool flushPending()
+        {
+            while (writeBegin < writeEnd)
+            {
+                ssize_t written = ::write(fd, writeBuffer.data() + writeBegin, writeEnd - writeBegin);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false; // EAGAIN - try again later, other errors - port is broken
+                }
+                writeBegin += written;
+            }
+
+            writeBegin = writeEnd = 0;
+            return true;
+        }
+
+        int available() override
+        {
+            if (readBegin == readEnd)
+                fillReadBuffer();
+            return (int)(readEnd - readBegin);
+        }
+
+        int read() override
+        {
+            if (readBegin == readEnd && !fillReadBuffer())
+                return -1;
+            return readBuffer[readBegin++];
+        }
+
+        int peek() override
+        {
+            if (readBegin == readEnd && !fillReadBuffer())
+                return -1;
+            return readBuffer[readBegin];
+        }
+
+        size_t readBytes(uint8_t* buffer, size_t length) override
+        {
+            size_t count = 0;
+            while (count < length)
+            {
+                if (readBegin == readEnd && !fillReadBuffer())
+                    break;
+
+                size_t chunk = readEnd - readBegin;
+                chunk = chunk < length - count ? chunk : length - count;
+                memcpy(buffer + count, readBuffer.data() + readBegin, chunk);
+                readBegin += chunk;
+                count += chunk;
+            }
+            return count;
+        }
+
+        size_t write(uint8_t data) override
+        {
+            return write(&data, 1);
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            if (fd < 0)
+                return 0;
+
+            size_t done = 0;
+            while (done < size)
+            {
+                if (writeEnd == writeBuffer.size())
+                {
+                    compactWriteBuffer();
+                    if (writeEnd == writeBuffer.size() && !waitAndFlush())
+                        return done;
+                }
+
+                size_t chunk = writeBuffer.size() - writeEnd;
+                chunk = chunk < size - done ? chunk : size - done;
+                memcpy(writeBuffer.data() + writeEnd, buffer + done, chunk);
+                writeEnd += chunk;
+                done += chunk;
+            }
+            return done;
+        }
+
+        int availableForWrite() override
+        {
+            return (int)(writeBuffer.size() - getPendingWriteSize());
+        }
+
+        void flush() override
+        {
+            while (!flushPending() && waitWritable())
+                ;
+        }
+
+
+    private:
+        bool fillReadBuffer()
+        {
+            if (fd < 0)
+                return false;
+
+            readBegin = readEnd = 0;
+            while (true)
+            {
+                ssize_t received = ::read(fd, readBuffer.data(), readBuffer.size());
+                if (received > 0)
+                {
+                    readEnd = received;
+                    return true;
+                }
+                if (received < 0 && errno == EINTR)
+                    continue;
+                return false; // no data (EAGAIN or VMIN/VTIME timeout) or error
+            }
+        }
+
+        void compactWriteBuffer()
+        {
+            if (writeBegin == 0)
+                return;
+            memmove(writeBuffer.data(), writeBuffer.data() + writeBegin, writeEnd - writeBegin);
+            writeEnd -= writeBegin;
+            writeBegin = 0;
+        }
+
+        bool waitWritable()
+        {
+            pollfd pfd = { fd, POLLOUT, 0 };
+            int result;
+            do
+                result = ::poll(&pfd, 1, config.writeTimeout_ms >= 0 ? config.writeTimeout_ms : 0);
+            while (result < 0 && errno == EINTR);
+            return result > 0 && !(pfd.revents & (POLLERR | POLLNVAL));
+        }
+
+        /**
+         * @brief Used only when the write buffer is full: wait until the port
+         * accepts more bytes and write as many as possible.
+         */
+        bool waitAndFlush()
+        {
+            if (!waitWritable())
+                return false;
+            flushPending();
+            compactWriteBuffer();
+            return writeEnd < writeBuffer.size();
+        }
+
+        bool configureTerminal(int terminalFd)
+        {
+            termios tty;
+            if (tcgetattr(terminalFd, &tty) != 0)
+                return false;
+
+            cfmakeraw(&tty);
+            tty.c_cflag |= CLOCAL | CREAD;
+            tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+            tty.c_cc[VMIN] = config.vmin;
+            tty.c_cc[VTIME] = config.vtime;
+
+            speed_t speed = toSpeed(config.baudRate);
+            if (speed == 0 || cfsetispeed(&tty, speed) != 0 || cfsetospeed(&tty, speed) != 0)
+                return false;
+
+            if (tcsetattr(terminalFd, TCSANOW, &tty) != 0)
+                return false;
+
+            int flags = fcntl(terminalFd, F_GETFL);
+            if (flags < 0)
+                return false;
+            flags = config.nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+            if (fcntl(terminalFd, F_SETFL, flags) != 0)
+                return false;
+
+            if (config.lowLatency)
+            {
+                serial_struct serial;
+                if (ioctl(terminalFd, TIOCGSERIAL, &serial) == 0)
+                {
+                    serial.flags |= ASYNC_LOW_LATENCY;
+                    ioctl(terminalFd, TIOCSSERIAL, &serial); // not supported by all drivers (eg. pty)
+                }
+            }
+
+            tcflush(terminalFd, TCIOFLUSH);
+            return true;
+        }
+
+        static speed_t toSpeed(uint32_t baudRate)
+        {
+            switch (baudRate)
+            {
+                case 1200: return B1200;
+                case 2400: return B2400;
+                case 4800: return B4800;
+                case 9600: return B9600;
+                case 19200: return B19200;
+                case 38400: return B38400;
+                case 57600: return B57600;
+                case 115200: return B115200;
+                case 230400: return B230400;
+                case 460800: return B460800;
+                case 500000: return B500000;
+                case 576000: return B576000;
+                case 921600: return B921600;
+                case 1000000: return B1000000;
+                case 1152000: return B1152000;
+                case 1500000: return B1500000;
+                case 2000000: return B2000000;
+                case 2500000: return B2500000;
+                case 3000000: return B3000000;
+                case 3500000: return B3500000;
+                case 4000000: return B4000000;
+                default: return 0;
+            }
+        }
+    };
+
+
+
+    /**
+     * @brief Transceiver for Linux serial ports. Frames are the same as
+     * sent by StreamComm on microcontrollers (COBS + XOR checksum).
+     * Each sent frame is written to the port by a single syscall,
+     * received bytes are read in big chunks.
+     * @tparam MaxBufferSize Max size of the frame (the same as for StreamComm).
+     */
+    template <const size_t MaxBufferSize>
+    class LinuxSerialComm : public StreamComm<MaxBufferSize, PosixSerialStream>
+    {
+        typedef StreamComm<MaxBufferSize, PosixSerialStream> Base;
+
+        PosixSerialStream serial;
+
+    public:
+        // serial is constructed after the base, but base only stores its address
+        LinuxSerialComm()
+            : Base(&serial)
+        {
+        }
+
+        /**
+         * @brief Open and configure serial port (see PosixSerialStream::open()).
+         */
+        bool open(const char* path, const SerialConfig& config = SerialConfig())
+        {
+            return serial.open(path, config);
+        }
+
+        /**
+         * @brief Use already opened terminal (see PosixSerialStream::adopt()).
+         */
+        bool adopt(int fd, const SerialConfig& config = SerialConfig())
+        {
+            return serial.adopt(fd, config);
+        }
+
+        void close()
+        {
+            serial.close();
+        }
+
+        bool isOpen() const
+        {
+            return serial.isOpen();
+        }
+
+        int getFileDescriptor() const
+        {
+            return serial.getFileDescriptor();
+        }
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            bool result = Base::send(buffer, size);
+            serial.flushPending();
+            return result;
+        }
+
+        bool send(const AutoDataBuffer& buffer) override
+        {
+            bool result = Base::send(buffer);
+            serial.flushPending();
+            return result;
+        }
+
+        bool sendFrame(FrameBuffer& frame) override
+        {
+            bool result = Base::sendFrame(frame);
+            serial.flushPending();
+            return result;
+        }
+
+        bool sendParts(const DataBuffer* parts, size_t count) override
+        {
+            bool result = Base::sendParts(parts, count);
+            serial.flushPending();
+            return result;
+        }
+
+        bool sendShared(SharedFrame& frame) override
+        {
+            bool result = Base::sendShared(frame);
+            serial.flushPending();
+            return result;
+        }
+
+        bool sendWithTrailer(const uint8_t* buffer, size_t size) override
+        {
+            bool result = Base::sendWithTrailer(buffer, size);
+            serial.flushPending();
+            return result;
+        }
+
+        bool receive() override
+        {
+            if (serial.getPendingWriteSize() > 0)
+                serial.flushPending();
+            return Base::receive();
+        }
+
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            if (serial.getPendingWriteSize() > 0)
+                serial.flushPending();
+            return Base::receiveBatch(out, max);
+        }
+
+        /**
+         * @brief Frames that don't fit the stream write buffer would wait for the port.
+         */
+        bool canSend(size_t size) override
+        {
+            if (serial.getPendingWriteSize() > 0)
+                serial.flushPending();
+            return COBS::getEncodedBufferSize(size + 1) + 1 <= (size_t)serial.availableForWrite();
+        }
+
+        size_t getPendingSendSize() const override
+        {
+            return Base::getPendingSendSize() + serial.getPendingWriteSize();
+        }
+
+        bool poll() override
+        {
+            Base::poll();
+            return serial.flushPending() && Base::getPendingSendSize() == 0;
+        }
+    };
+}
+
+
+#endif
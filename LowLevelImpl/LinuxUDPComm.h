@@ -0,0 +1,608 @@
+/**
+ * @file LinuxUDPComm.h
+ * @author Jan Wielgus
+ * @brief UDP communication on Linux with many peers.
+ * Datagrams are received and sent in batches (recvmmsg/sendmmsg),
+ * so one syscall handles many frames. Each received frame has its
+ * source peer, replies are sent to the sender of the frame that is being handled.
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef LINUXUDPCOMM_H
+#define LINUXUDPCOMM_H
+
+#include "ITransceiver.h"
+#include "DataBuffer.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <vector>
+
+
+namespace PacketComm
+{
+    class LinuxUDPComm : public ITransceiver
+    {
+    public:
+        typedef uint16_t PeerID;
+        static const PeerID NoPeer = 0xFFFF;
+
+    private:
+        static const size_t MaxDirectParts = 8; // max parts sent by sendmsg() without copying
+
+        int fd = -1;
+        const size_t MaxDatagramSize;
+        const size_t BatchSize;
+
+        // peers
+        std::vector<sockaddr_in> peers;
+        std::unordered_map<uint64_t, PeerID> peerIndex; // (IP << 16 | port) -> PeerID
+        PeerID targetPeer = NoPeer;
+        bool sendAlwaysToLastSender_flag = true;
+
+        // receiving batch
+        std::vector<uint8_t> receiveStorage;
+        std::vector<mmsghdr> receiveMessages;
+        std::vector<iovec> receiveVectors;
+        std::vector<sockaddr_in> receiveAddresses;
+        size_t receivedAmount = 0;
+        size_t receivedIndex = 0;
+        DataBuffer currentReceived;
+        PeerID currentReceivedPeer = NoPeer;
+        std::vector<PeerID> batchPeers; // source peers of frames returned by the last receiveBatch()
+        size_t batchPeersAmount = 0;
+        bool batchFrameSelection_flag = false; // selectBatchFrame() is called by the user of receiveBatch()
+
+        // sending batch
+        bool sendBatching_flag = true;
+        std::vector<uint8_t> sendStorage;
+        std::vector<mmsghdr> sendMessages;
+        std::vector<iovec> sendVectors;
+        std::vector<PeerID> sendPeers;
+        std::vector<SharedFrame*> sendSharedFrames; // queued without copying (or nullptr if copied to sendStorage)
+        size_t queuedAmount = 0;
+
+        // statistics
+        uint32_t receiveSyscalls = 0;
+        uint32_t sendSyscalls = 0;
+        uint32_t droppedSends = 0;
+        uint32_t truncatedDatagrams = 0;
+
+
+    public:
+        /**
+         * @param maxDatagramSize Max size of one frame.
+         * @param batchSize Max amount of datagrams received or sent by one syscall.
+         */
+        explicit LinuxUDPComm(size_t maxDatagramSize = 1472, size_t batchSize = 64)
+            : MaxDatagramSize(maxDatagramSize),
+              BatchSize(batchSize > 0 ? batchSize : 1),
+              receiveStorage(MaxDatagramSize * BatchSize),
+              receiveMessages(BatchSize),
+              receiveVectors(BatchSize),
+              receiveAddresses(BatchSize),
+              batchPeers(BatchSize),
+              sendStorage(MaxDatagramSize * BatchSize),
+              sendMessages(BatchSize),
+              sendVectors(BatchSize),
+              sendPeers(BatchSize),
+              sendSharedFrames(BatchSize, nullptr)
+        {
+        }
+
+        LinuxUDPComm(const LinuxUDPComm&) = delete;
+        LinuxUDPComm& operator=(const LinuxUDPComm&) = delete;
+
+        ~LinuxUDPComm()
+        {
+            end();
+        }
+
+        /**
+         * @brief Open socket and start listening on the port.
+         * @param port Local port (0 - any free port, check it with getLocalPort()).
+         * @param bindAddress Local IPv4 address or nullptr to listen on all interfaces.
+         * @return false if socket could not be opened or bound.
+         */
+        bool begin(uint16_t port, const char* bindAddress = nullptr)
+        {
+            end();
+
+            int newFd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (newFd < 0)
+                return false;
+
+            sockaddr_in local;
+            memset(&local, 0, sizeof(local));
+            local.sin_family = AF_INET;
+            local.sin_port = htons(port);
+            local.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (bindAddress != nullptr && inet_pton(AF_INET, bindAddress, &local.sin_addr) != 1)
+            {
+                ::close(newFd);
+                return false;
+            }
+
+            if (::bind(newFd, (sockaddr*)&local, sizeof(local)) != 0)
+            {
+                ::close(newFd);
+                return false;
+            }
+
+            fd = newFd;
+            return true;
+        }
+
+        /**
+         * @brief Send queued datagrams and close the socket.
+         */
+        void end()
+        {
+            if (fd < 0)
+                return;
+
+            flush();
+            ::close(fd);
+            fd = -1;
+            receivedAmount = receivedIndex = 0;
+            batchPeersAmount = 0;
+        }
+
+        bool isOpen() const
+        {
+            return fd >= 0;
+        }
+
+        int getFileDescriptor() const
+        {
+            return fd;
+        }
+
+        /**
+         * @brief Change size of the kernel receive buffer. Default buffer holds only
+         * a few hundred small datagrams, which is not enough when many peers
+         * send at the same time (limited by net.core.rmem_max).
+         * @return false if socket is closed or size could not be set.
+         */
+        bool setReceiveBufferSize(int bytes)
+        {
+            return fd >= 0 && setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) == 0;
+        }
+
+        /**
+         * @return Local port of the socket or 0 if socket is closed.
+         */
+        uint16_t getLocalPort() const
+        {
+            sockaddr_in local;
+            socklen_t length = sizeof(local);
+            if (fd < 0 || getsockname(fd, (sockaddr*)&local, &length) != 0)
+                return 0;
+            return ntohs(local.sin_port);
+        }
+
+
+        /**
+         * @brief Queue datagram to the target peer (see setTargetPeer()).
+         * If send batching is enabled, datagrams are sent when the batch is full,
+         * on flush() or when receive() needs to receive the next batch.
+         * @return false if there is no target peer or datagram is too big.
+         */
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            return sendTo(targetPeer, buffer, size);
+        }
+
+        /**
+         * @brief Queue datagram to the chosen peer.
+         * @return false if peer doesn't exist or datagram is too big.
+         */
+        bool sendTo(PeerID peer, const uint8_t* buffer, size_t size)
+        {
+            if (buffer == nullptr)
+                return false;
+
+            DataBuffer part(const_cast<uint8_t*>(buffer), size);
+            return sendPartsTo(peer, &part, 1);
+        }
+
+        /**
+         * @brief Queue datagram made of parts to the target peer (see send()).
+         */
+        bool sendParts(const DataBuffer* parts, size_t count) override
+        {
+            return sendPartsTo(targetPeer, parts, count);
+        }
+
+        bool isSendPartsSupported() const override
+        {
+            return true;
+        }
+
+        /**
+         * @brief Queue datagram made of parts to the chosen peer. Parts are copied
+         * to the batch, or (if send batching is disabled) sent directly by sendmsg().
+         * @return false if peer doesn't exist or datagram is too big.
+         */
+        bool sendPartsTo(PeerID peer, const DataBuffer* parts, size_t count)
+        {
+            size_t size = 0;
+            for (size_t i = 0; i < count; ++i)
+                size += parts[i].size;
+
+            if (fd < 0 || peer >= peers.size() || size == 0 || size > MaxDatagramSize)
+                return false;
+
+            if (!sendBatching_flag && queuedAmount == 0 && count <= MaxDirectParts)
+                return sendDirectly(peer, parts, count);
+
+            if (queuedAmount == BatchSize)
+                flush();
+
+            uint8_t* datagram = sendStorage.data() + queuedAmount * MaxDatagramSize;
+            for (size_t i = 0; i < count; ++i)
+            {
+                memcpy(datagram, parts[i].buffer, parts[i].size);
+                datagram += parts[i].size;
+            }
+            sendVectors[queuedAmount].iov_len = size;
+            sendPeers[queuedAmount] = peer;
+            queuedAmount++;
+
+            if (!sendBatching_flag || queuedAmount == BatchSize)
+                return flush();
+            return true;
+        }
+
+        /**
+         * @brief Queue shared frame to the target peer. It is not copied to the batch,
+         * but kept (SharedFrame::retain()) until the batch is sent.
+         */
+        bool sendShared(SharedFrame& frame) override
+        {
+            DataBuffer data = frame.getData();
+            if (fd < 0 || targetPeer >= peers.size() || data.size == 0 || data.size > MaxDatagramSize)
+                return false;
+
+            if (!sendBatching_flag)
+                return sendPartsTo(targetPeer, &data, 1);
+
+            if (queuedAmount == BatchSize)
+                flush();
+
+            frame.retain();
+            sendSharedFrames[queuedAmount] = &frame;
+            sendVectors[queuedAmount].iov_len = data.size;
+            sendPeers[queuedAmount] = targetPeer;
+            queuedAmount++;
+
+            if (queuedAmount == BatchSize)
+                return flush();
+            return true;
+        }
+
+        /**
+         * @brief Send all queued datagrams (one syscall per BatchSize datagrams).
+         * @return false if some datagrams were not sent (socket buffer is full).
+         */
+        bool flush()
+        {
+            if (queuedAmount == 0 || fd < 0)
+                return queuedAmount == 0;
+
+            for (size_t i = 0; i < queuedAmount; ++i)
+            {
+                if (sendSharedFrames[i] != nullptr)
+                    sendVectors[i].iov_base = sendSharedFrames[i]->getData().buffer;
+                else
+                    sendVectors[i].iov_base = sendStorage.data() + i * MaxDatagramSize;
+                msghdr& header = sendMessages[i].msg_hdr;
+                memset(&header, 0, sizeof(header));
+                header.msg_name = &peers[sendPeers[i]];
+                header.msg_namelen = sizeof(sockaddr_in);
+                header.msg_iov = &sendVectors[i];
+                header.msg_iovlen = 1;
+            }
+
+            size_t sent = 0;
+            while (sent < queuedAmount)
+            {
+                int result = ::sendmmsg(fd, sendMessages.data() + sent, queuedAmount - sent, MSG_DONTWAIT);
+                sendSyscalls++;
+                if (result < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    break;
+                }
+                sent += result;
+            }
+
+            droppedSends += queuedAmount - sent;
+            bool allSent = sent == queuedAmount;
+            releaseSharedFrames();
+            queuedAmount = 0;
+            return allSent;
+        }
+
+        /**
+         * @brief Enable or disable send batching. If disabled, every send()
+         * call sends its datagram immediately.
+         */
+        void setSendBatching(bool enabled)
+        {
+            sendBatching_flag = enabled;
+            if (!enabled)
+                flush();
+        }
+
+
+        /**
+         * @brief Receive next datagram. If all datagrams from the last batch
+         * were already returned, queued datagrams are sent and next batch
+         * is received by one syscall. Datagrams bigger than the max datagram size
+         * are dropped (see getTruncatedDatagramsAmount()).
+         */
+        bool receive() override
+        {
+            skipTruncatedDatagrams();
+            if (receivedIndex >= receivedAmount)
+                flush(); // replies to the previous batch are sent together
+
+            while (receivedIndex >= receivedAmount)
+            {
+                if (!receiveNextBatch())
+                {
+                    currentReceived = DataBuffer();
+                    currentReceivedPeer = NoPeer;
+                    return false;
+                }
+                skipTruncatedDatagrams();
+            }
+
+            size_t index = receivedIndex++;
+            currentReceived = DataBuffer(receiveStorage.data() + index * MaxDatagramSize, receiveMessages[index].msg_len);
+            currentReceivedPeer = getOrAddPeer(receiveAddresses[index]);
+            if (sendAlwaysToLastSender_flag)
+                targetPeer = currentReceivedPeer;
+            return true;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return currentReceived;
+        }
+
+        /**
+         * @brief Return datagrams received by one syscall (they stay valid until
+         * the next receive() or receiveBatch() call). Sender of each of them is
+         * returned by getBatchPeer(). If replies go to the sender (see setTargetPeerAlwaysToSender()),
+         * only one datagram is returned each time until the caller selects frames
+         * by selectBatchFrame() (PacketCommunication does it before each callback).
+         */
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            if (sendAlwaysToLastSender_flag && !batchFrameSelection_flag && max > 1)
+                max = 1; // replies from callbacks have to go to the sender of each datagram
+
+            size_t count = 0;
+            while (count < max)
+            {
+                if (count > 0)
+                {
+                    skipTruncatedDatagrams();
+                    if (receivedIndex >= receivedAmount)
+                        break; // next syscall would overwrite returned datagrams
+                }
+                if (!receive())
+                    break;
+
+                batchPeers[count] = currentReceivedPeer;
+                out[count++] = currentReceived;
+            }
+
+            batchPeersAmount = count;
+            return count;
+        }
+
+        /**
+         * @brief Datagram with this index of the last receiveBatch() is handled now:
+         * getReceivedPeer() returns its sender and replies go to it (if the target peer
+         * is always the sender).
+         */
+        void selectBatchFrame(size_t index) override
+        {
+            batchFrameSelection_flag = true;
+            if (index >= batchPeersAmount)
+                return;
+
+            currentReceivedPeer = batchPeers[index];
+            if (sendAlwaysToLastSender_flag)
+                targetPeer = currentReceivedPeer;
+        }
+
+        /**
+         * @return Peer that sent the datagram with this index of the last receiveBatch() call or NoPeer.
+         */
+        PeerID getBatchPeer(size_t index) const
+        {
+            return index < batchPeersAmount ? batchPeers[index] : NoPeer;
+        }
+
+        /**
+         * @return Peer that sent the last received (or selected) datagram or NoPeer.
+         */
+        PeerID getReceivedPeer() const
+        {
+            return currentReceivedPeer;
+        }
+
+
+        /**
+         * @brief Add peer (or find existing one) by its IPv4 address and port.
+         * @return ID of the peer or NoPeer if address is invalid.
+         */
+        PeerID addPeer(const char* ipAddress, uint16_t port)
+        {
+            sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            if (inet_pton(AF_INET, ipAddress, &address.sin_addr) != 1)
+                return NoPeer;
+            return getOrAddPeer(address);
+        }
+
+        /**
+         * @return Address of the peer or nullptr if peer doesn't exist.
+         */
+        const sockaddr_in* getPeerAddress(PeerID peer) const
+        {
+            return peer < peers.size() ? &peers[peer] : nullptr;
+        }
+
+        size_t getPeersAmount() const
+        {
+            return peers.size();
+        }
+
+        /**
+         * @brief All next datagrams sent by send() will be sent to this peer.
+         */
+        void setTargetPeer(PeerID peer)
+        {
+            targetPeer = peer;
+            sendAlwaysToLastSender_flag = false;
+        }
+
+        /**
+         * @brief Datagrams sent by send() always go to the sender of the last received datagram
+         * (default).
+         */
+        void setTargetPeerAlwaysToSender()
+        {
+            sendAlwaysToLastSender_flag = true;
+        }
+
+        uint32_t getReceiveSyscallsAmount() const { return receiveSyscalls; }
+        uint32_t getSendSyscallsAmount() const { return sendSyscalls; }
+        uint32_t getDroppedSendsAmount() const { return droppedSends; }
+        uint32_t getTruncatedDatagramsAmount() const { return truncatedDatagrams; }
+
+
+    private:
+        void releaseSharedFrames()
+        {
+            for (size_t i = 0; i < queuedAmount; ++i)
+            {
+                if (sendSharedFrames[i] != nullptr)
+                {
+                    sendSharedFrames[i]->release();
+                    sendSharedFrames[i] = nullptr;
+                }
+            }
+        }
+
+        /**
+         * @brief Send the datagram made of parts by a single sendmsg() call.
+         */
+        bool sendDirectly(PeerID peer, const DataBuffer* parts, size_t count)
+        {
+            iovec vectors[MaxDirectParts];
+            for (size_t i = 0; i < count; ++i)
+            {
+                vectors[i].iov_base = parts[i].buffer;
+                vectors[i].iov_len = parts[i].size;
+            }
+
+            msghdr header;
+            memset(&header, 0, sizeof(header));
+            header.msg_name = &peers[peer];
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov = vectors;
+            header.msg_iovlen = count;
+
+            ssize_t result;
+            do
+            {
+                result = ::sendmsg(fd, &header, MSG_DONTWAIT);
+                sendSyscalls++;
+            } while (result < 0 && errno == EINTR);
+
+            if (result < 0)
+            {
+                droppedSends++;
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Datagrams that didn't fit MaxDatagramSize are truncated by the kernel, they are dropped.
+         */
+        void skipTruncatedDatagrams()
+        {
+            while (receivedIndex < receivedAmount && (receiveMessages[receivedIndex].msg_hdr.msg_flags & MSG_TRUNC))
+            {
+                truncatedDatagrams++;
+                receivedIndex++;
+            }
+        }
+
+        bool receiveNextBatch()
+        {
+            receivedAmount = receivedIndex = 0;
+            if (fd < 0)
+                return false;
+
+            for (size_t i = 0; i < BatchSize; ++i)
+            {
+                receiveVectors[i].iov_base = receiveStorage.data() + i * MaxDatagramSize;
+                receiveVectors[i].iov_len = MaxDatagramSize;
+                msghdr& header = receiveMessages[i].msg_hdr;
+                memset(&header, 0, sizeof(header));
+                header.msg_name = &receiveAddresses[i];
+                header.msg_namelen = sizeof(sockaddr_in);
+                header.msg_iov = &receiveVectors[i];
+                header.msg_iovlen = 1;
+            }
+
+            int result;
+            do
+            {
+                result = ::recvmmsg(fd, receiveMessages.data(), BatchSize, MSG_DONTWAIT, nullptr);
+                receiveSyscalls++;
+            } while (result < 0 && errno == EINTR);
+
+            if (result <= 0)
+                return false;
+
+            receivedAmount = result;
+            return true;
+        }
+
+        PeerID getOrAddPeer(const sockaddr_in& address)
+        {
+            uint64_t key = ((uint64_t)address.sin_addr.s_addr << 16) | address.sin_port;
+            auto found = peerIndex.find(key);
+            if (found != peerIndex.end())
+                return found->second;
+
+            if (peers.size() >= NoPeer)
+                return NoPeer;
+
+            PeerID peer = (PeerID)peers.size();
+            peers.push_back(address);
+            peerIndex.emplace(key, peer);
+            return peer;
+        }
+    };
+}
+
+
+#endif
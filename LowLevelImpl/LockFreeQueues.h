@@ -0,0 +1,279 @@
+/**
+ * @file LockFreeQueues.h
+ * @author Jan Wielgus
+ * @brief Lock-free queues used to pass work and frames between threads:
+ * single producer single consumer ring and work stealing deque.
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef LOCKFREEQUEUES_H
+#define LOCKFREEQUEUES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+
+namespace PacketComm
+{
+    static const size_t CacheLineSize = 64;
+
+
+    /**
+     * @brief Bounded single producer single consumer queue.
+     * Elements are constructed once and reused, producer writes them in place
+     * (beginPush() / commitPush()) and consumer reads them in place (front() / pop()).
+     * @tparam T Type of the element (default constructible).
+     */
+    template <class T>
+    class SPSCQueue
+    {
+        const size_t Capacity;
+        const size_t Mask;
+        std::unique_ptr<T[]> elements;
+
+        alignas(CacheLineSize) std::atomic<size_t> head; // next element to write (producer)
+        size_t cachedTail = 0;
+
+        alignas(CacheLineSize) std::atomic<size_t> tail; // next element to read (consumer)
+        size_t cachedHead = 0;
+
+    public:
+        /**
+         * @param capacity Max amount of elements (rounded up to the power of two).
+         */
+        explicit SPSCQueue(size_t capacity)
+            : Capacity(roundUpToPowerOfTwo(capacity)),
+              Mask(Capacity - 1),
+              elements(new T[Capacity]),
+              head(0),
+              tail(0)
+        {
+        }
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        /**
+         * @brief Producer: get element to fill.
+         * @return Pointer to the free element or nullptr if queue is full.
+         */
+        T* beginPush()
+        {
+            size_t currentHead = head.load(std::memory_order_relaxed);
+            if (currentHead - cachedTail == Capacity)
+            {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (currentHead - cachedTail == Capacity)
+                    return nullptr;
+            }
+            return &elements[currentHead & Mask];
+        }
+
+        /**
+         * @brief Producer: publish element returned by beginPush().
+         */
+        void commitPush()
+        {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Producer: copy value to the queue.
+         * @return false if queue is full.
+         */
+        bool push(const T& value)
+        {
+            T* element = beginPush();
+            if (element == nullptr)
+                return false;
+            *element = value;
+            commitPush();
+            return true;
+        }
+
+        /**
+         * @brief Consumer: get the oldest element.
+         * @return Pointer to the element or nullptr if queue is empty.
+         */
+        T* front()
+        {
+            size_t currentTail = tail.load(std::memory_order_relaxed);
+            if (currentTail == cachedHead)
+            {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (currentTail == cachedHead)
+                    return nullptr;
+            }
+            return &elements[currentTail & Mask];
+        }
+
+        /**
+         * @brief Consumer: release element returned by front().
+         */
+        void pop()
+        {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Consumer: copy the oldest element and remove it.
+         * @return false if queue is empty.
+         */
+        bool pop(T& value)
+        {
+            T* element = front();
+            if (element == nullptr)
+                return false;
+            value = *element;
+            pop();
+            return true;
+        }
+
+        /**
+         * @return Approximate amount of elements (exact if called by producer or consumer
+         * while the other side is not working).
+         */
+        size_t size() const
+        {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        size_t getCapacity() const
+        {
+            return Capacity;
+        }
+
+    private:
+        static size_t roundUpToPowerOfTwo(size_t value)
+        {
+            size_t result = 1;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+    };
+
+
+
+    /**
+     * @brief Bounded work stealing deque (Chase-Lev). Owner thread pushes and pops
+     * at the bottom, other threads steal from the top.
+     * @tparam T Trivially copyable type of the work item (eg. index).
+     */
+    template <class T>
+    class WorkStealingDeque
+    {
+        const int64_t Capacity;
+        const int64_t Mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+
+        alignas(CacheLineSize) std::atomic<int64_t> top;
+        alignas(CacheLineSize) std::atomic<int64_t> bottom;
+
+    public:
+        /**
+         * @param capacity Max amount of items (rounded up to the power of two).
+         */
+        explicit WorkStealingDeque(size_t capacity)
+            : Capacity(roundUpToPowerOfTwo(capacity)),
+              Mask(Capacity - 1),
+              items(new std::atomic<T>[Capacity]),
+              top(0),
+              bottom(0)
+        {
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /**
+         * @brief Owner: add item at the bottom.
+         * @return false if deque is full.
+         */
+        bool push(T item)
+        {
+            int64_t b = bottom.load(std::memory_order_relaxed);
+            int64_t t = top.load(std::memory_order_acquire);
+            if (b - t >= Capacity)
+                return false;
+
+            items[b & Mask].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Owner: take the newest item.
+         * @return false if deque is empty (or the last item was stolen).
+         */
+        bool pop(T& item)
+        {
+            int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b)
+            {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false; // empty
+            }
+
+            item = items[b & Mask].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // the last item, race with thieves
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Any thread: take the oldest item.
+         * @return false if deque is empty or another thread took the item first.
+         */
+        bool steal(T& item)
+        {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b)
+                return false;
+
+            item = items[t & Mask].load(std::memory_order_relaxed);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        /**
+         * @return Approximate amount of items.
+         */
+        size_t size() const
+        {
+            int64_t amount = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+            return amount > 0 ? (size_t)amount : 0;
+        }
+
+    private:
+        static int64_t roundUpToPowerOfTwo(size_t value)
+        {
+            int64_t result = 1;
+            while ((size_t)result < value)
+                result <<= 1;
+            return result;
+        }
+    };
+}
+
+
+#endif
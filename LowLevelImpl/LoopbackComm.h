@@ -0,0 +1,554 @@
+/**
+ * @file LoopbackComm.h
+ * @author Jan Wielgus
+ * @brief In-memory transceiver pair and Stream pair with deterministic
+ * fault injection (bandwidth limit, latency, loss, bit flips, duplication,
+ * reordering and fragmented byte delivery).
+ * Used to test and benchmark communication without hardware.
+ * Host only (uses standard library containers).
+ * @date 2026-10-19
+ */
+
+#ifndef LOOPBACKCOMM_H
+#define LOOPBACKCOMM_H
+
+#include "ITransceiver.h"
+#include "DataBuffer.h"
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Impairments of one direction of the loopback link.
+     * Probabilities are in range [0.0, 1.0] and are applied to each
+     * segment (frame for LoopbackComm, single write() call for LoopbackStream).
+     */
+    struct LinkImpairments
+    {
+        uint32_t bandwidth_Bps = 0;         // bytes per second, 0 - unlimited
+        uint32_t latency_us = 0;            // constant propagation delay
+        float lossProbability = 0.f;        // segment is dropped
+        float corruptionProbability = 0.f;  // one random bit of the segment is flipped
+        float duplicationProbability = 0.f; // segment is delivered twice
+        float reorderProbability = 0.f;     // segment is delayed by reorderDelay_us (and overtaken by next ones)
+        uint32_t reorderDelay_us = 1000;
+        size_t maxFragmentSize = 0;         // LoopbackStream only: bytes become available in random chunks [1, maxFragmentSize], 0 - at once
+        size_t txBufferSize = 0;            // LoopbackStream only: output buffer emptied at bandwidth_Bps (availableForWrite()), 0 - unlimited
+        uint32_t seed = 1;                  // the same seed - the same sequence of faults
+    };
+
+
+    /**
+     * @brief Counters of what happened to segments pushed to the channel.
+     */
+    struct LinkStatistics
+    {
+        uint32_t pushed = 0;
+        uint32_t delivered = 0;
+        uint32_t lost = 0;
+        uint32_t corrupted = 0;
+        uint32_t duplicated = 0;
+        uint32_t reordered = 0;
+    };
+
+
+
+    /**
+     * @brief One direction of the loopback link. Segments pushed to the channel
+     * are impaired and scheduled for delivery according to LinkImpairments.
+     */
+    class LoopbackChannel
+    {
+    public:
+        typedef uint32_t (*ClockFunction)();
+
+    private:
+        struct Segment
+        {
+            uint32_t deliveryTime_us;
+            std::vector<uint8_t> data;
+        };
+
+        LinkImpairments impairments;
+        LinkStatistics statistics;
+        ClockFunction clock;
+        uint32_t randomState;
+        uint32_t linkFreeTime_us = 0; // when the last scheduled byte leaves the sender
+        bool byteMode = false;
+
+        std::deque<Segment> pending; // ordered by delivery time
+        std::deque<std::vector<uint8_t>> readySegments;
+        std::vector<uint8_t> readyBytes;
+        size_t readyBytesIndex = 0;
+
+
+    public:
+        explicit LoopbackChannel(const LinkImpairments& impairments = LinkImpairments())
+            : clock(defaultClock)
+        {
+            setImpairments(impairments);
+        }
+
+        /**
+         * @brief Change impairments and restart the random generator with the new seed.
+         */
+        void setImpairments(const LinkImpairments& newImpairments)
+        {
+            impairments = newImpairments;
+            randomState = newImpairments.seed != 0 ? newImpairments.seed : 1;
+        }
+
+        const LinkImpairments& getImpairments() const
+        {
+            return impairments;
+        }
+
+        /**
+         * @brief Replace time source (micros() by default), eg. with simulated time.
+         */
+        void setClock(ClockFunction clockFunction)
+        {
+            clock = clockFunction;
+        }
+
+        const LinkStatistics& getStatistics() const
+        {
+            return statistics;
+        }
+
+        /**
+         * @brief In byte mode delivered segments are joined into one byte stream
+         * (segment boundaries are lost). Set by LoopbackStream.
+         */
+        void setByteMode(bool enabled)
+        {
+            byteMode = enabled;
+        }
+
+        /**
+         * @brief Impair and schedule the segment for delivery.
+         */
+        void push(const uint8_t* data, size_t size)
+        {
+            if (size == 0)
+                return;
+
+            statistics.pushed++;
+
+            if (isUnimpaired())
+            {
+                deliver(data, size);
+                return;
+            }
+
+            uint32_t now = clock();
+            uint32_t transmissionTime_us = impairments.bandwidth_Bps == 0 ? 0
+                : (uint32_t)((uint64_t)size * 1000000 / impairments.bandwidth_Bps);
+            if (isBefore(linkFreeTime_us, now))
+                linkFreeTime_us = now;
+            linkFreeTime_us += transmissionTime_us; // lost bytes occupied the link too
+
+            if (chance(impairments.lossProbability))
+            {
+                statistics.lost++;
+                return;
+            }
+
+            std::vector<uint8_t> segment(data, data + size);
+            if (chance(impairments.corruptionProbability))
+            {
+                uint32_t bit = nextRandom() % (size * 8);
+                segment[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+                statistics.corrupted++;
+            }
+
+            uint32_t deliveryTime = linkFreeTime_us + impairments.latency_us;
+            if (chance(impairments.reorderProbability))
+            {
+                deliveryTime += impairments.reorderDelay_us;
+                statistics.reordered++;
+            }
+
+            if (chance(impairments.duplicationProbability))
+            {
+                schedule(deliveryTime, segment);
+                statistics.duplicated++;
+            }
+
+            schedule(deliveryTime, std::move(segment));
+        }
+
+        /**
+         * @return Free space of the sender output buffer (LinkImpairments::txBufferSize).
+         * Bytes that are not transmitted yet (at bandwidth_Bps) occupy it.
+         */
+        size_t getWritableBytes()
+        {
+            if (impairments.txBufferSize == 0)
+                return 0x7FFF;
+
+            uint32_t now = clock();
+            if (impairments.bandwidth_Bps == 0 || !isBefore(now, linkFreeTime_us))
+                return impairments.txBufferSize;
+
+            uint64_t untransmitted = (uint64_t)(linkFreeTime_us - now) * impairments.bandwidth_Bps / 1000000;
+            return untransmitted < impairments.txBufferSize ? impairments.txBufferSize - (size_t)untransmitted : 0;
+        }
+
+        /**
+         * @brief Take next delivered segment as a whole (frame mode).
+         * @param output Segment data is moved here.
+         * @return true if any segment was delivered.
+         */
+        bool popSegment(std::vector<uint8_t>& output)
+        {
+            deliverDue();
+            if (readySegments.empty())
+                return false;
+
+            output.swap(readySegments.front());
+            readySegments.pop_front();
+            return true;
+        }
+
+        /**
+         * @return Amount of delivered bytes that can be read (byte mode).
+         */
+        size_t availableBytes()
+        {
+            deliverDue();
+            return readyBytes.size() - readyBytesIndex;
+        }
+
+        /**
+         * @return Next delivered byte or -1 if there is no data (byte mode).
+         */
+        int readByte()
+        {
+            if (availableBytes() == 0)
+                return -1;
+
+            uint8_t data = readyBytes[readyBytesIndex++];
+            if (readyBytesIndex == readyBytes.size())
+            {
+                readyBytes.clear();
+                readyBytesIndex = 0;
+            }
+            return data;
+        }
+
+        /**
+         * @return Next delivered byte without removing it or -1 if there is no data.
+         */
+        int peekByte()
+        {
+            return availableBytes() == 0 ? -1 : readyBytes[readyBytesIndex];
+        }
+
+        /**
+         * @brief Read many delivered bytes at once (byte mode).
+         * @return Amount of bytes copied to buffer.
+         */
+        size_t readBytes(uint8_t* buffer, size_t length)
+        {
+            size_t toRead = availableBytes();
+            toRead = toRead < length ? toRead : length;
+            memcpy(buffer, readyBytes.data() + readyBytesIndex, toRead);
+            readyBytesIndex += toRead;
+            if (readyBytesIndex == readyBytes.size())
+            {
+                readyBytes.clear();
+                readyBytesIndex = 0;
+            }
+            return toRead;
+        }
+
+        /**
+         * @return Amount of segments that were scheduled but are not delivered yet.
+         */
+        size_t getPendingAmount() const
+        {
+            return pending.size();
+        }
+
+        /**
+         * @brief Remove all scheduled and delivered data.
+         */
+        void clear()
+        {
+            pending.clear();
+            readySegments.clear();
+            readyBytes.clear();
+            readyBytesIndex = 0;
+        }
+
+
+    private:
+        static uint32_t defaultClock()
+        {
+            return (uint32_t)micros();
+        }
+
+        static bool isBefore(uint32_t a, uint32_t b)
+        {
+            return (int32_t)(a - b) < 0; // wrap-safe
+        }
+
+        bool isUnimpaired() const
+        {
+            return impairments.bandwidth_Bps == 0 && impairments.latency_us == 0
+                && impairments.lossProbability <= 0.f && impairments.corruptionProbability <= 0.f
+                && impairments.duplicationProbability <= 0.f && impairments.reorderProbability <= 0.f
+                && impairments.maxFragmentSize == 0 && pending.empty();
+        }
+
+        uint32_t nextRandom()
+        {
+            // xorshift32
+            randomState ^= randomState << 13;
+            randomState ^= randomState >> 17;
+            randomState ^= randomState << 5;
+            return randomState;
+        }
+
+        bool chance(float probability)
+        {
+            if (probability <= 0.f)
+                return false;
+            return (nextRandom() >> 8) < (uint32_t)(probability * (1 << 24));
+        }
+
+        void schedule(uint32_t deliveryTime, std::vector<uint8_t> segment)
+        {
+            if (!byteMode || impairments.maxFragmentSize == 0 || segment.size() <= 1)
+            {
+                insertPending(deliveryTime, std::move(segment));
+                return;
+            }
+
+            // split into random sized fragments spread over the transmission time
+            size_t offset = 0;
+            uint32_t byteTime_us = impairments.bandwidth_Bps == 0 ? 0 : 1000000 / impairments.bandwidth_Bps;
+            uint32_t fragmentTime = deliveryTime - (uint32_t)(segment.size() * byteTime_us);
+            while (offset < segment.size())
+            {
+                size_t fragmentSize = 1 + nextRandom() % impairments.maxFragmentSize;
+                if (fragmentSize > segment.size() - offset)
+                    fragmentSize = segment.size() - offset;
+
+                fragmentTime += (uint32_t)(fragmentSize * byteTime_us);
+                insertPending(fragmentTime, std::vector<uint8_t>(segment.begin() + offset, segment.begin() + offset + fragmentSize));
+                offset += fragmentSize;
+            }
+        }
+
+        void insertPending(uint32_t deliveryTime, std::vector<uint8_t> segment)
+        {
+            auto position = pending.end();
+            while (position != pending.begin() && isBefore(deliveryTime, (position - 1)->deliveryTime_us))
+                --position;
+            pending.insert(position, Segment{ deliveryTime, std::move(segment) });
+        }
+
+        void deliverDue()
+        {
+            if (pending.empty())
+                return;
+
+            uint32_t now = clock();
+            while (!pending.empty() && !isBefore(now, pending.front().deliveryTime_us))
+            {
+                if (byteMode)
+                    readyBytes.insert(readyBytes.end(), pending.front().data.begin(), pending.front().data.end());
+                else
+                    readySegments.push_back(std::move(pending.front().data));
+                pending.pop_front();
+                statistics.delivered++;
+            }
+        }
+
+        void deliver(const uint8_t* data, size_t size)
+        {
+            if (byteMode)
+                readyBytes.insert(readyBytes.end(), data, data + size);
+            else
+                readySegments.emplace_back(data, data + size);
+            statistics.delivered++;
+        }
+    };
+
+
+
+    /**
+     * @brief Transceiver that sends frames to one channel and receives
+     * from another. Frame boundaries are preserved (like UDP datagrams).
+     * Use LoopbackLink to create a connected pair.
+     */
+    class LoopbackComm : public ITransceiver
+    {
+        LoopbackChannel* outgoing;
+        LoopbackChannel* incoming;
+        std::vector<uint8_t> receivedFrame;
+        std::vector<std::vector<uint8_t>> receivedBatch; // frames returned by receiveBatch()
+
+    public:
+        LoopbackComm(LoopbackChannel* outgoing, LoopbackChannel* incoming)
+            : outgoing(outgoing), incoming(incoming)
+        {
+        }
+
+        LoopbackComm(const LoopbackComm&) = delete;
+        LoopbackComm& operator=(const LoopbackComm&) = delete;
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (buffer == nullptr || size == 0)
+                return false;
+
+            outgoing->push(buffer, size);
+            return true;
+        }
+
+        bool receive() override
+        {
+            if (incoming->popSegment(receivedFrame))
+                return true;
+
+            receivedFrame.clear();
+            return false;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return DataBuffer(receivedFrame.data(), receivedFrame.size());
+        }
+
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            if (receivedBatch.size() < max)
+                receivedBatch.resize(max);
+
+            size_t count = 0;
+            while (count < max && incoming->popSegment(receivedBatch[count]))
+            {
+                out[count] = DataBuffer(receivedBatch[count].data(), receivedBatch[count].size());
+                count++;
+            }
+            return count;
+        }
+    };
+
+
+
+    /**
+     * @brief Arduino Stream that writes bytes to one channel and reads from another.
+     * Can be used with StreamComm. Use LoopbackStreamPair to create a connected pair.
+     */
+    class LoopbackStream : public Stream
+    {
+        LoopbackChannel* outgoing;
+        LoopbackChannel* incoming;
+
+    public:
+        LoopbackStream(LoopbackChannel* outgoing, LoopbackChannel* incoming)
+            : outgoing(outgoing), incoming(incoming)
+        {
+            outgoing->setByteMode(true);
+            incoming->setByteMode(true);
+        }
+
+        LoopbackStream(const LoopbackStream&) = delete;
+        LoopbackStream& operator=(const LoopbackStream&) = delete;
+
+        size_t write(uint8_t data) override
+        {
+            return write(&data, 1);
+        }
+
+        /**
+         * @brief With LinkImpairments::txBufferSize set, waits for free space
+         * like HardwareSerial (time has to advance, eg. the default clock).
+         */
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            size_t written = 0;
+            while (written < size)
+            {
+                size_t chunk = outgoing->getWritableBytes();
+                chunk = chunk < size - written ? chunk : size - written;
+                outgoing->push(buffer + written, chunk);
+                written += chunk;
+            }
+            return size;
+        }
+
+        int availableForWrite() override
+        {
+            return (int)outgoing->getWritableBytes();
+        }
+
+        int available() override
+        {
+            return (int)incoming->availableBytes();
+        }
+
+        int read() override
+        {
+            return incoming->readByte();
+        }
+
+        int peek() override
+        {
+            return incoming->peekByte();
+        }
+
+        size_t readBytes(uint8_t* buffer, size_t length) override
+        {
+            return incoming->readBytes(buffer, length);
+        }
+    };
+
+
+
+    /**
+     * @brief Two channels (A -> B and B -> A) with endpoints of type EndpointType
+     * (LoopbackComm or LoopbackStream) connected to them.
+     */
+    template <class EndpointType>
+    class LoopbackPair
+    {
+        LoopbackChannel channelAtoB;
+        LoopbackChannel channelBtoA;
+        EndpointType endpointA;
+        EndpointType endpointB;
+
+    public:
+        explicit LoopbackPair(const LinkImpairments& impairments = LinkImpairments())
+            : channelAtoB(impairments),
+              channelBtoA(impairments),
+              endpointA(&channelAtoB, &channelBtoA),
+              endpointB(&channelBtoA, &channelAtoB)
+        {
+        }
+
+        LoopbackPair(const LoopbackPair&) = delete;
+        LoopbackPair& operator=(const LoopbackPair&) = delete;
+
+        EndpointType& getEndpointA() { return endpointA; }
+        EndpointType& getEndpointB() { return endpointB; }
+
+        LoopbackChannel& getChannelAtoB() { return channelAtoB; }
+        LoopbackChannel& getChannelBtoA() { return channelBtoA; }
+    };
+
+    typedef LoopbackPair<LoopbackComm> LoopbackLink;
+    typedef LoopbackPair<LoopbackStream> LoopbackStreamPair;
+}
+
+
+#endif
@@ -0,0 +1,325 @@
+/**
+ * @file ReplayComm.h
+ * @author Jan Wielgus
+ * @brief Playback of traces recorded by CaptureComm.h taps:
+ * ReplayComm returns recorded frames as received frames of a transceiver,
+ * ReplayStream returns recorded raw bytes as a stream (eg. for StreamComm).
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef REPLAYCOMM_H
+#define REPLAYCOMM_H
+
+#include "ITransceiver.h"
+#include "TraceFile.h"
+#include "DataBuffer.h"
+#include <Arduino.h>
+#include <string.h>
+#include <time.h>
+
+
+namespace PacketComm
+{
+    enum class ReplayTiming : uint8_t
+    {
+        RECORDED,  // records are available when the same time passed as in the trace
+        AS_FAST_AS_POSSIBLE
+    };
+
+
+    /**
+     * @brief Returns records of one type and channel from the trace
+     * when they are due according to the timing. Each player has its own
+     * read position, so many players can share one TraceReader.
+     */
+    class TracePlayer
+    {
+        TraceReader* const Reader;
+        const TraceRecordType Type;
+        const uint8_t Channel;
+        ReplayTiming timing;
+        size_t readPosition = 0;
+
+        TraceRecord pending;
+        bool pending_flag = false;
+        bool finished_flag = false;
+        bool started_flag = false;
+        uint64_t startTime_ns = 0;
+        uint64_t firstTimestamp_ns = 0;
+
+    public:
+        TracePlayer(TraceReader* reader, TraceRecordType type, uint8_t channel, ReplayTiming timing)
+            : Reader(reader),
+              Type(type),
+              Channel(channel),
+              timing(timing)
+        {
+        }
+
+        void setTiming(ReplayTiming timing)
+        {
+            this->timing = timing;
+        }
+
+        /**
+         * @brief Start from the first record again (time of the first record is now).
+         */
+        void rewind()
+        {
+            readPosition = 0;
+            pending_flag = false;
+            finished_flag = false;
+            started_flag = false;
+        }
+
+        /**
+         * @return true if all records were returned.
+         */
+        bool isFinished() const
+        {
+            return finished_flag;
+        }
+
+        /**
+         * @param record Output record.
+         * @return false if there is no record that is due now.
+         */
+        bool next(TraceRecord& record)
+        {
+            if (!pending_flag && !readMatching())
+                return false;
+
+            if (timing == ReplayTiming::RECORDED)
+            {
+                uint64_t now = getTime_ns();
+                if (!started_flag)
+                {
+                    started_flag = true;
+                    startTime_ns = now;
+                    firstTimestamp_ns = pending.timestamp_ns;
+                }
+
+                if (now - startTime_ns < pending.timestamp_ns - firstTimestamp_ns)
+                    return false; // not yet
+            }
+
+            record = pending;
+            pending_flag = false;
+            return true;
+        }
+
+
+    private:
+        bool readMatching()
+        {
+            while (Reader->next(pending, readPosition))
+            {
+                if (pending.type == Type && pending.channel == Channel)
+                {
+                    pending_flag = true;
+                    return true;
+                }
+            }
+
+            finished_flag = true;
+            return false;
+        }
+
+        static uint64_t getTime_ns()
+        {
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+        }
+    };
+
+
+
+    /**
+     * @brief Transceiver that receives frames from the trace (FRAME_RECEIVED records
+     * by default). Received frames point into the mapped trace.
+     * Sent frames are dropped (only counted).
+     */
+    class ReplayComm : public ITransceiver
+    {
+        TracePlayer player;
+        DataBuffer currentReceived;
+
+        // statistics
+        uint32_t sentFrames = 0;
+
+    public:
+        /**
+         * @param reader Opened trace file.
+         * @param channel Channel of replayed records.
+         * @param timing Return frames at recorded timing or as fast as possible.
+         * @param type Type of replayed records (eg. FRAME_SENT to replay the other side).
+         */
+        ReplayComm(TraceReader* reader, uint8_t channel = 0, ReplayTiming timing = ReplayTiming::RECORDED,
+                   TraceRecordType type = TraceRecordType::FRAME_RECEIVED)
+            : player(reader, type, channel, timing)
+        {
+        }
+
+        ReplayComm(const ReplayComm&) = delete;
+        ReplayComm& operator=(const ReplayComm&) = delete;
+
+        void setTiming(ReplayTiming timing) { player.setTiming(timing); }
+        void rewind() { player.rewind(); }
+        bool isFinished() const { return player.isFinished(); }
+
+        uint32_t getSentFramesAmount() const { return sentFrames; }
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (buffer == nullptr || size == 0)
+                return false;
+
+            sentFrames++;
+            return true;
+        }
+
+        bool receive() override
+        {
+            TraceRecord record;
+            if (!player.next(record))
+            {
+                currentReceived = DataBuffer();
+                return false;
+            }
+
+            currentReceived = record.data;
+            return true;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return currentReceived;
+        }
+
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            TraceRecord record;
+            size_t count = 0;
+            while (count < max && player.next(record))
+                out[count++] = record.data;
+            return count;
+        }
+    };
+
+
+
+    /**
+     * @brief Stream that returns bytes from the trace (RAW_RECEIVED records
+     * by default). Written bytes are dropped (only counted).
+     */
+    class ReplayStream : public Stream
+    {
+        TracePlayer player;
+        DataBuffer currentRecord;
+        size_t readIndex = 0;
+
+        // statistics
+        size_t writtenBytes = 0;
+
+    public:
+        /**
+         * @param reader Opened trace file.
+         * @param channel Channel of replayed records.
+         * @param timing Return bytes at recorded timing or as fast as possible.
+         * @param type Type of replayed records (eg. RAW_SENT to replay the other side).
+         */
+        ReplayStream(TraceReader* reader, uint8_t channel = 0, ReplayTiming timing = ReplayTiming::RECORDED,
+                     TraceRecordType type = TraceRecordType::RAW_RECEIVED)
+            : player(reader, type, channel, timing)
+        {
+        }
+
+        ReplayStream(const ReplayStream&) = delete;
+        ReplayStream& operator=(const ReplayStream&) = delete;
+
+        void setTiming(ReplayTiming timing) { player.setTiming(timing); }
+
+        void rewind()
+        {
+            player.rewind();
+            currentRecord = DataBuffer();
+            readIndex = 0;
+        }
+
+        bool isFinished() const
+        {
+            return player.isFinished() && readIndex == currentRecord.size;
+        }
+
+        size_t getWrittenBytesAmount() const { return writtenBytes; }
+
+        size_t write(uint8_t data) override
+        {
+            (void)data;
+            writtenBytes++;
+            return 1;
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            (void)buffer;
+            writtenBytes += size;
+            return size;
+        }
+
+        int available() override
+        {
+            return fillRecord() ? currentRecord.size - readIndex : 0;
+        }
+
+        int read() override
+        {
+            return fillRecord() ? currentRecord.buffer[readIndex++] : -1;
+        }
+
+        int peek() override
+        {
+            return fillRecord() ? currentRecord.buffer[readIndex] : -1;
+        }
+
+        size_t readBytes(uint8_t* buffer, size_t length) override
+        {
+            size_t count = 0;
+            while (count < length && fillRecord())
+            {
+                size_t chunk = currentRecord.size - readIndex;
+                if (chunk > length - count)
+                    chunk = length - count;
+
+                memcpy(buffer + count, currentRecord.buffer + readIndex, chunk);
+                readIndex += chunk;
+                count += chunk;
+            }
+            return count;
+        }
+
+
+    private:
+        /**
+         * @return true if there are unread bytes in the current record.
+         */
+        bool fillRecord()
+        {
+            TraceRecord record;
+            while (readIndex == currentRecord.size)
+            {
+                if (!player.next(record))
+                    return false;
+
+                currentRecord = record.data;
+                readIndex = 0;
+            }
+            return true;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,478 @@
+/**
+ * @file ShardedGateway.h
+ * @author Jan Wielgus
+ * @brief Multi-core runtime for gateways with a large number of links
+ * (serial ports, UDP sockets, ...). Links are divided between shards,
+ * each shard is a worker thread pinned to its core with its own event loop.
+ * Idle shards steal receive batches of hot shards. Received frames
+ * are passed to the application thread through lock-free queues.
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef SHARDEDGATEWAY_H
+#define SHARDEDGATEWAY_H
+
+#include "ITransceiver.h"
+#include "PacketCommunication.h"
+#include "LinuxEventLoop.h"
+#include "LockFreeQueues.h"
+#include <pthread.h>
+#include <poll.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Configuration of the ShardedGateway.
+     */
+    struct ShardedGatewayConfig
+    {
+        size_t shardsAmount = 0;         // 0 - one shard per available core
+        bool pinThreads = true;          // pin shard N to core (firstCore + N) % cores
+        size_t firstCore = 0;
+        bool workStealing = true;
+        size_t stealThreshold = 2;       // wake up an idle shard if more link batches are waiting
+        size_t maxFramesPerBatch = 64;   // frames received from one link before other links are served
+        size_t frameQueueCapacity = 4096; // received frames waiting for the application (per shard)
+    };
+
+
+
+    /**
+     * @brief Runtime that receives from many links on many cores.
+     * Each link is a transceiver (received frames go to the application thread,
+     * see pollReceived()) or a PacketCommunication (its receive() and callbacks
+     * are executed on the worker threads). One link is never handled
+     * by two threads at the same time, but can be handled by different threads
+     * one after another (work stealing).
+     * Sending is not synchronized with receiving and must be done by the user
+     * in a thread-safe way.
+     * @tparam MaxFrameSize Max size of the frame passed to the application.
+     */
+    template <const size_t MaxFrameSize>
+    class ShardedGateway
+    {
+        static_assert(MaxFrameSize <= 0xFFFF, "ReceivedFrame::size is uint16_t");
+
+    public:
+        typedef uint32_t LinkID;
+        static const LinkID NoLink = 0xFFFFFFFF;
+
+        struct ReceivedFrame
+        {
+            LinkID link;
+            uint16_t size;
+            uint8_t data[MaxFrameSize];
+        };
+
+    private:
+        struct Link
+        {
+            ITransceiver* transceiver;
+            PacketCommunication* comm;
+            int fd;
+            size_t shard;
+        };
+
+        struct alignas(CacheLineSize) Shard
+        {
+            LinuxEventLoop loop;
+            int wakeFd = -1;
+            std::unique_ptr<WorkStealingDeque<LinkID>> pendingLinks;
+            std::unique_ptr<SPSCQueue<ReceivedFrame>> receivedFrames; // produced by this shard thread
+            std::thread thread;
+            std::atomic<bool> sleeping;
+            size_t linksAmount = 0;
+
+            // statistics
+            std::atomic<uint64_t> handledBatches;
+            std::atomic<uint64_t> stolenBatches;
+            std::atomic<uint64_t> droppedFrames;
+
+            Shard()
+                : sleeping(false),
+                  handledBatches(0),
+                  stolenBatches(0),
+                  droppedFrames(0)
+            {
+            }
+        };
+
+        const ShardedGatewayConfig Config;
+        std::vector<Link> links;
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::atomic<bool> running;
+        bool started = false;
+
+        // application thread notification
+        int applicationFd = -1;
+        std::atomic<bool> applicationWaiting;
+
+
+    public:
+        explicit ShardedGateway(const ShardedGatewayConfig& config = ShardedGatewayConfig())
+            : Config(config),
+              running(false),
+              applicationWaiting(false)
+        {
+            size_t amount = config.shardsAmount;
+            if (amount == 0)
+                amount = getCoresAmount();
+
+            for (size_t i = 0; i < amount; ++i)
+            {
+                shards.emplace_back(new Shard);
+                Shard& shard = *shards.back();
+                shard.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                int wakeFd = shard.wakeFd;
+                shard.loop.addFileDescriptor(wakeFd, [wakeFd]() {
+                    uint64_t counter;
+                    ssize_t ignored = ::read(wakeFd, &counter, sizeof(counter));
+                    (void)ignored;
+                });
+                shard.receivedFrames.reset(new SPSCQueue<ReceivedFrame>(config.frameQueueCapacity));
+            }
+
+            applicationFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        }
+
+        ShardedGateway(const ShardedGateway&) = delete;
+        ShardedGateway& operator=(const ShardedGateway&) = delete;
+
+        ~ShardedGateway()
+        {
+            stop();
+            for (auto& shard : shards)
+                if (shard->wakeFd >= 0)
+                    ::close(shard->wakeFd);
+            if (applicationFd >= 0)
+                ::close(applicationFd);
+        }
+
+
+        /**
+         * @brief Add link which received frames are passed to the application (see pollReceived()).
+         * Can be called only before start().
+         * @param transceiver Transceiver of the link.
+         * @param fd File descriptor that becomes readable when transceiver has data.
+         * @return ID of the link or NoLink.
+         */
+        LinkID addLink(ITransceiver* transceiver, int fd)
+        {
+            if (transceiver == nullptr)
+                return NoLink;
+            return addLink(transceiver, nullptr, fd);
+        }
+
+        /**
+         * @brief Add link which receive() is called on the worker threads
+         * (packet callbacks are executed there). Can be called only before start().
+         * @param comm Communication of the link.
+         * @param fd File descriptor that becomes readable when its transceiver has data.
+         * @return ID of the link or NoLink.
+         */
+        LinkID addLink(PacketCommunication* comm, int fd)
+        {
+            if (comm == nullptr)
+                return NoLink;
+            return addLink(nullptr, comm, fd);
+        }
+
+        /**
+         * @brief Start worker threads.
+         * @return false if already started or there are no shards.
+         */
+        bool start()
+        {
+            if (started || shards.empty())
+                return false;
+
+            for (size_t i = 0; i < shards.size(); ++i)
+            {
+                Shard& shard = *shards[i];
+                // each link can be pending only once (one shot descriptors),
+                // stolen batches are never pushed to the thief deque
+                shard.pendingLinks.reset(new WorkStealingDeque<LinkID>(shard.linksAmount + 1));
+            }
+
+            for (LinkID id = 0; id < links.size(); ++id)
+            {
+                Shard& shard = *shards[links[id].shard];
+                size_t shardIndex = links[id].shard;
+                shard.loop.addFileDescriptor(links[id].fd, [this, shardIndex, id]() {
+                    onLinkReadable(shardIndex, id);
+                }, true);
+            }
+
+            running = true;
+            started = true;
+            for (size_t i = 0; i < shards.size(); ++i)
+            {
+                shards[i]->thread = std::thread([this, i]() { work(i); });
+                if (Config.pinThreads)
+                    pinThread(shards[i]->thread, (Config.firstCore + i) % getCoresAmount());
+            }
+            return true;
+        }
+
+        /**
+         * @brief Stop and join worker threads.
+         */
+        void stop()
+        {
+            if (!started)
+                return;
+
+            running = false;
+            for (auto& shard : shards)
+                wakeShard(*shard);
+            for (auto& shard : shards)
+                if (shard->thread.joinable())
+                    shard->thread.join();
+
+            for (LinkID id = 0; id < links.size(); ++id)
+                shards[links[id].shard]->loop.removeFileDescriptor(links[id].fd);
+            started = false;
+        }
+
+
+        /**
+         * @brief Pass received frames to the callback. Must be called from one
+         * application thread only.
+         * @param callback Function called as callback(const ReceivedFrame&).
+         * @param maxFrames Max amount of passed frames.
+         * @return Amount of passed frames.
+         */
+        template <class Callback>
+        size_t pollReceived(Callback&& callback, size_t maxFrames = (size_t)-1)
+        {
+            size_t passed = 0;
+            for (auto& shard : shards)
+            {
+                SPSCQueue<ReceivedFrame>& queue = *shard->receivedFrames;
+                ReceivedFrame* frame;
+                while (passed < maxFrames && (frame = queue.front()) != nullptr)
+                {
+                    callback(static_cast<const ReceivedFrame&>(*frame));
+                    queue.pop();
+                    passed++;
+                }
+            }
+            return passed;
+        }
+
+        /**
+         * @brief Sleep until received frames are available (application thread).
+         * @param timeout_ms Max waiting time in milliseconds (negative - no limit).
+         * @return true if there are frames to poll.
+         */
+        bool waitForFrames(int timeout_ms)
+        {
+            if (hasFrames())
+                return true;
+
+            applicationWaiting.store(true, std::memory_order_seq_cst);
+            if (!hasFrames())
+            {
+                pollfd pfd = { applicationFd, POLLIN, 0 };
+                if (::poll(&pfd, 1, timeout_ms) > 0)
+                {
+                    uint64_t counter;
+                    ssize_t ignored = ::read(applicationFd, &counter, sizeof(counter));
+                    (void)ignored;
+                }
+            }
+            applicationWaiting.store(false, std::memory_order_seq_cst);
+
+            return hasFrames();
+        }
+
+        size_t getShardsAmount() const
+        {
+            return shards.size();
+        }
+
+        size_t getLinksAmount() const
+        {
+            return links.size();
+        }
+
+        uint64_t getHandledBatchesAmount() const { return sumStatistic(&Shard::handledBatches); }
+        uint64_t getStolenBatchesAmount() const { return sumStatistic(&Shard::stolenBatches); }
+        uint64_t getDroppedFramesAmount() const { return sumStatistic(&Shard::droppedFrames); }
+
+
+    private:
+        LinkID addLink(ITransceiver* transceiver, PacketCommunication* comm, int fd)
+        {
+            if (started || fd < 0 || shards.empty() || links.size() >= NoLink)
+                return NoLink;
+
+            // the least loaded shard
+            size_t shardIndex = 0;
+            for (size_t i = 1; i < shards.size(); ++i)
+                if (shards[i]->linksAmount < shards[shardIndex]->linksAmount)
+                    shardIndex = i;
+
+            Link link;
+            link.transceiver = transceiver;
+            link.comm = comm;
+            link.fd = fd;
+            link.shard = shardIndex;
+            links.push_back(link);
+            shards[shardIndex]->linksAmount++;
+            return (LinkID)(links.size() - 1);
+        }
+
+        /**
+         * @brief Called by the owner shard event loop (descriptor is disabled until rearmed).
+         */
+        void onLinkReadable(size_t shardIndex, LinkID id)
+        {
+            Shard& shard = *shards[shardIndex];
+            shard.pendingLinks->push(id);
+
+            if (Config.workStealing && shard.pendingLinks->size() > Config.stealThreshold)
+                wakeIdleShard(shardIndex);
+        }
+
+        void work(size_t shardIndex)
+        {
+            Shard& shard = *shards[shardIndex];
+            LinkID id;
+
+            while (running.load(std::memory_order_relaxed))
+            {
+                while (shard.pendingLinks->pop(id))
+                    handleBatch(shard, id);
+
+                if (Config.workStealing && stealBatch(shardIndex, id))
+                {
+                    handleBatch(shard, id);
+                    shard.stolenBatches.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                shard.sleeping.store(true, std::memory_order_seq_cst);
+                shard.loop.runOnce(-1);
+                shard.sleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Receive up to maxFramesPerBatch frames from the link.
+         * @param shard Shard of the current thread (not necessarily the link owner).
+         */
+        void handleBatch(Shard& shard, LinkID id)
+        {
+            Link& link = links[id];
+
+            if (link.comm != nullptr)
+                link.comm->receive(); // receives all available data
+            else
+            {
+                size_t passed = 0;
+                for (; passed < Config.maxFramesPerBatch && link.transceiver->receive(); ++passed)
+                {
+                    DataBuffer received = link.transceiver->getReceived();
+                    ReceivedFrame* frame = shard.receivedFrames->beginPush();
+                    if (frame == nullptr || received.size > MaxFrameSize)
+                    {
+                        shard.droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    frame->link = id;
+                    frame->size = (uint16_t)received.size;
+                    memcpy(frame->data, received.buffer, received.size);
+                    shard.receivedFrames->commitPush();
+                }
+                if (passed > 0 && applicationWaiting.load(std::memory_order_seq_cst))
+                {
+                    uint64_t one = 1;
+                    ssize_t ignored = ::write(applicationFd, &one, sizeof(one));
+                    (void)ignored;
+                }
+            }
+
+            shard.handledBatches.fetch_add(1, std::memory_order_relaxed);
+
+            // Descriptor is level triggered, so if batch limit was reached, rearming it
+            // makes the rest of the data wait behind other pending links
+            shards[link.shard]->loop.rearmFileDescriptor(link.fd);
+        }
+
+        bool stealBatch(size_t thiefIndex, LinkID& id)
+        {
+            for (size_t offset = 1; offset < shards.size(); ++offset)
+            {
+                Shard& victim = *shards[(thiefIndex + offset) % shards.size()];
+                if (victim.pendingLinks->size() > 0 && victim.pendingLinks->steal(id))
+                    return true;
+            }
+            return false;
+        }
+
+        void wakeIdleShard(size_t busyIndex)
+        {
+            for (size_t offset = 1; offset < shards.size(); ++offset)
+            {
+                Shard& shard = *shards[(busyIndex + offset) % shards.size()];
+                if (shard.sleeping.load(std::memory_order_seq_cst))
+                {
+                    wakeShard(shard);
+                    return;
+                }
+            }
+        }
+
+        static void wakeShard(Shard& shard)
+        {
+            uint64_t one = 1;
+            ssize_t ignored = ::write(shard.wakeFd, &one, sizeof(one));
+            (void)ignored;
+        }
+
+        bool hasFrames() const
+        {
+            for (auto& shard : shards)
+                if (!shard->receivedFrames->empty())
+                    return true;
+            return false;
+        }
+
+        uint64_t sumStatistic(std::atomic<uint64_t> Shard::*statistic) const
+        {
+            uint64_t sum = 0;
+            for (auto& shard : shards)
+                sum += ((*shard).*statistic).load(std::memory_order_relaxed);
+            return sum;
+        }
+
+        static size_t getCoresAmount()
+        {
+            unsigned int cores = std::thread::hardware_concurrency();
+            return cores > 0 ? cores : 1;
+        }
+
+        static void pinThread(std::thread& thread, size_t core)
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(core, &cpuSet);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet); // ignored if not permitted
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,558 @@
+/**
+ * @file SharedMemoryComm.h
+ * @author Jan Wielgus
+ * @brief Communication between processes (or threads) on the same Linux host
+ * through lock-free single producer single consumer rings in shared memory.
+ * Frames are written in place (PacketCommunication serializes packets directly
+ * into the ring) and read in place (getReceived() points into the ring),
+ * without any encoding or checksum.
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef SHAREDMEMORYCOMM_H
+#define SHAREDMEMORYCOMM_H
+
+#include "ITransceiver.h"
+#include "DataBuffer.h"
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Transceiver working on a shared memory segment with two rings
+     * (one for each direction). One side creates the segment (create()),
+     * the other opens it (open()). Each ring has exactly one producer
+     * and one consumer.
+     *
+     * Waiting for data: waitForData() sleeps on a futex in the shared memory
+     * (works between any processes). Optionally each side can have an eventfd
+     * "doorbell" (eg. to use with epoll), see setWakeupEventFds().
+     */
+    class SharedMemoryComm : public ITransceiver
+    {
+        static const uint32_t Magic = 0x504B5348; // "PKSH"
+        static const uint32_t Version = 1;
+        static const uint32_t PaddingRecord = 0xFFFFFFFF;
+        static const size_t RecordHeaderSize = 8;
+        static const size_t CacheLine = 64;
+
+        static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+            "Shared memory rings require lock-free atomics");
+
+        struct alignas(CacheLine) RingControl
+        {
+            alignas(CacheLine) std::atomic<uint64_t> head; // bytes written by the producer
+            alignas(CacheLine) std::atomic<uint64_t> tail; // bytes released by the consumer
+            alignas(CacheLine) std::atomic<uint32_t> consumerWaiting;
+            std::atomic<uint32_t> wakeSequence; // futex word
+        };
+
+        struct SegmentHeader
+        {
+            std::atomic<uint32_t> magic; // set as the last one by the creator
+            uint32_t version;
+            uint64_t ringCapacity;
+            RingControl rings[2];
+        };
+
+        struct Ring
+        {
+            RingControl* control = nullptr;
+            uint8_t* data = nullptr;
+        };
+
+        int shmFd = -1;
+        void* segment = nullptr;
+        size_t segmentSize = 0;
+        uint64_t capacity = 0;
+
+        Ring sendRing;
+        Ring receiveRing;
+
+        // producer side state
+        uint64_t producerHead = 0;
+        uint64_t cachedTail = 0;
+        uint64_t reservedHead = 0; // head after padding of the reserved record
+        uint8_t* reservedRecord = nullptr;
+        size_t reservedSize = 0;
+
+        // consumer side state
+        uint64_t consumerTail = 0;
+        uint64_t cachedHead = 0;
+        size_t currentRecordSize = 0; // size of records returned by getReceived() or receiveBatch() (released on the next call)
+        DataBuffer currentReceived;
+        uint32_t invalidRecords = 0; // statistics
+
+        int ownEventFd = -1;
+        int peerEventFd = -1;
+
+
+    public:
+        SharedMemoryComm() = default;
+
+        SharedMemoryComm(const SharedMemoryComm&) = delete;
+        SharedMemoryComm& operator=(const SharedMemoryComm&) = delete;
+
+        ~SharedMemoryComm()
+        {
+            close();
+        }
+
+        /**
+         * @brief Create new shared memory segment (this is side A).
+         * @param name Name of the segment (starting with '/', see shm_open()).
+         * @param ringCapacity Size of each ring in bytes. Frames can have at most
+         * half of this size.
+         * @return false if segment could not be created.
+         */
+        bool create(const char* name, size_t ringCapacity)
+        {
+            close();
+
+            capacity = (ringCapacity + CacheLine - 1) / CacheLine * CacheLine;
+            if (capacity < CacheLine)
+                return false;
+
+            int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0600);
+            if (fd < 0)
+                return false;
+
+            size_t size = getDataOffset() + 2 * capacity;
+            if (ftruncate(fd, size) != 0 || !map(fd, size))
+            {
+                ::close(fd);
+                return false;
+            }
+
+            SegmentHeader* header = getHeader();
+            header->version = Version;
+            header->ringCapacity = capacity;
+            for (RingControl& ring : header->rings)
+            {
+                ring.head.store(0, std::memory_order_relaxed);
+                ring.tail.store(0, std::memory_order_relaxed);
+                ring.consumerWaiting.store(0, std::memory_order_relaxed);
+                ring.wakeSequence.store(0, std::memory_order_relaxed);
+            }
+            header->magic.store(Magic, std::memory_order_release);
+
+            attachRings(0, 1);
+            return true;
+        }
+
+        /**
+         * @brief Open segment created by the other side (this is side B).
+         * @param name Name of the segment passed to create().
+         * @return false if segment doesn't exist or is not initialized yet.
+         */
+        bool open(const char* name)
+        {
+            close();
+
+            int fd = shm_open(name, O_RDWR | O_CLOEXEC, 0600);
+            if (fd < 0)
+                return false;
+
+            struct stat info;
+            if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SegmentHeader) || !map(fd, info.st_size))
+            {
+                ::close(fd);
+                return false;
+            }
+
+            SegmentHeader* header = getHeader();
+            if (header->magic.load(std::memory_order_acquire) != Magic || header->version != Version
+                || header->ringCapacity == 0 || header->ringCapacity % CacheLine != 0
+                || header->ringCapacity > segmentSize || getDataOffset() + 2 * header->ringCapacity > segmentSize)
+            {
+                close();
+                return false;
+            }
+
+            capacity = header->ringCapacity;
+            attachRings(1, 0);
+            return true;
+        }
+
+        /**
+         * @brief Unmap the segment (segment still exists until unlink()).
+         */
+        void close()
+        {
+            if (segment != nullptr)
+                munmap(segment, segmentSize);
+            if (shmFd >= 0)
+                ::close(shmFd);
+
+            segment = nullptr;
+            shmFd = -1;
+            segmentSize = 0;
+            sendRing = Ring();
+            receiveRing = Ring();
+            reservedRecord = nullptr;
+            currentRecordSize = 0;
+            currentReceived = DataBuffer();
+        }
+
+        /**
+         * @brief Remove segment name (memory is freed when all sides close it).
+         */
+        static bool unlink(const char* name)
+        {
+            return shm_unlink(name) == 0;
+        }
+
+        bool isOpen() const
+        {
+            return segment != nullptr;
+        }
+
+        /**
+         * @return Max size of the frame that can be sent.
+         */
+        size_t getMaxFrameSize() const
+        {
+            return capacity / 2 - RecordHeaderSize;
+        }
+
+        /**
+         * @return Amount of invalid records (or heads) written by the other side (eg. crashed
+         * or broken process). Data up to its head is dropped after each of them.
+         */
+        uint32_t getInvalidRecordsAmount() const
+        {
+            return invalidRecords;
+        }
+
+        /**
+         * @brief Set eventfd doorbells. Own eventfd is signaled by the other side
+         * when it writes to the empty ring (use it with poll/epoll, see getFileDescriptor()).
+         * Peer eventfd is the own eventfd of the other side (the same descriptor
+         * in one process, or passed to another process eg. by fork or unix socket).
+         * Own eventfd is read by receive() when the ring is empty, so it has to be
+         * non-blocking (created with EFD_NONBLOCK).
+         * @param ownEventFd eventfd of this side or -1.
+         * @param peerEventFd eventfd of the other side or -1.
+         * @return false if ownEventFd is not non-blocking (doorbells are not changed then).
+         */
+        bool setWakeupEventFds(int ownEventFd, int peerEventFd)
+        {
+            if (ownEventFd >= 0)
+            {
+                int flags = ::fcntl(ownEventFd, F_GETFL);
+                if (flags < 0 || (flags & O_NONBLOCK) == 0)
+                    return false;
+            }
+
+            this->ownEventFd = ownEventFd;
+            this->peerEventFd = peerEventFd;
+            return true;
+        }
+
+        /**
+         * @return Own doorbell eventfd or -1 if not set.
+         */
+        int getFileDescriptor() const
+        {
+            return ownEventFd;
+        }
+
+
+        bool send(const uint8_t* buffer, size_t size) override
+        {
+            if (buffer == nullptr || size == 0)
+                return false;
+
+            DataBuffer record = reserveSendBuffer(size);
+            if (record.buffer == nullptr)
+                return false;
+
+            memcpy(record.buffer, buffer, size);
+            return commitSendBuffer(size);
+        }
+
+        DataBuffer reserveSendBuffer(size_t size) override
+        {
+            if (sendRing.control == nullptr || size == 0 || size > getMaxFrameSize())
+                return DataBuffer();
+
+            size_t recordSize = getRecordSize(size);
+            uint64_t position = producerHead % capacity;
+            uint64_t contiguous = capacity - position;
+            uint64_t padding = contiguous < recordSize ? contiguous : 0;
+
+            if (producerHead + padding + recordSize - cachedTail > capacity)
+            {
+                cachedTail = sendRing.control->tail.load(std::memory_order_acquire);
+                if (producerHead + padding + recordSize - cachedTail > capacity)
+                    return DataBuffer(); // ring is full
+            }
+
+            if (padding > 0)
+            {
+                writeRecordHeader(sendRing.data + position, PaddingRecord);
+                position = 0;
+            }
+
+            reservedHead = producerHead + padding;
+            reservedRecord = sendRing.data + position;
+            reservedSize = size;
+            return DataBuffer(reservedRecord + RecordHeaderSize, size);
+        }
+
+        bool commitSendBuffer(size_t size) override
+        {
+            if (reservedRecord == nullptr || size == 0 || size > reservedSize)
+                return false;
+
+            writeRecordHeader(reservedRecord, (uint32_t)size);
+            uint64_t previousHead = producerHead;
+            producerHead = reservedHead + getRecordSize(size);
+            reservedRecord = nullptr;
+
+            RingControl* control = sendRing.control;
+            control->head.store(producerHead, std::memory_order_seq_cst);
+
+            // Wake up the consumer if it sleeps or if ring was empty (doorbell)
+            if (control->consumerWaiting.load(std::memory_order_seq_cst) != 0)
+            {
+                control->wakeSequence.fetch_add(1, std::memory_order_seq_cst);
+                futex(&control->wakeSequence, FUTEX_WAKE, 1, nullptr);
+            }
+            if (peerEventFd >= 0 && control->tail.load(std::memory_order_seq_cst) == previousHead)
+            {
+                uint64_t one = 1;
+                ssize_t ignored = ::write(peerEventFd, &one, sizeof(one));
+                (void)ignored;
+            }
+
+            return true;
+        }
+
+
+        /**
+         * @brief Release the previously received frame and get the next one.
+         * Received data stays in the ring until the next receive() call.
+         */
+        bool receive() override
+        {
+            if (receiveRing.control == nullptr)
+                return false;
+
+            releaseCurrent();
+
+            if (peekRecord(currentReceived))
+                return true;
+
+            // Ring is empty: reset doorbell and check again (data could come in the meantime)
+            consumerTail += currentRecordSize; // skipped padding
+            currentRecordSize = 0;
+            receiveRing.control->tail.store(consumerTail, std::memory_order_seq_cst);
+            if (ownEventFd >= 0)
+            {
+                uint64_t counter;
+                ssize_t ignored = ::read(ownEventFd, &counter, sizeof(counter));
+                (void)ignored;
+                if (peekRecord(currentReceived))
+                    return true;
+            }
+
+            currentReceived = DataBuffer();
+            return false;
+        }
+
+        const DataBuffer getReceived() override
+        {
+            return currentReceived;
+        }
+
+        /**
+         * @brief Release previously received frames and get the next ones (in place).
+         * All of them stay in the ring until the next receive() or receiveBatch() call.
+         */
+        size_t receiveBatch(DataBuffer* out, size_t max) override
+        {
+            if (max == 0 || !receive())
+                return 0;
+
+            out[0] = currentReceived;
+            size_t count = 1;
+            while (count < max && peekRecord(out[count]))
+                count++;
+
+            currentReceived = out[count - 1];
+            return count;
+        }
+
+        /**
+         * @brief Sleep until there is data to receive.
+         * @param timeout_ms Max waiting time in milliseconds (negative - no limit).
+         * @return true if there is data to receive.
+         */
+        bool waitForData(int timeout_ms)
+        {
+            if (receiveRing.control == nullptr)
+                return false;
+
+            RingControl* control = receiveRing.control;
+            if (hasData())
+                return true;
+
+            control->consumerWaiting.store(1, std::memory_order_seq_cst);
+            uint32_t sequence = control->wakeSequence.load(std::memory_order_seq_cst);
+            if (!hasData())
+            {
+                timespec timeout;
+                timeout.tv_sec = timeout_ms / 1000;
+                timeout.tv_nsec = (long)(timeout_ms % 1000) * 1000000;
+                futex(&control->wakeSequence, FUTEX_WAIT, sequence, timeout_ms < 0 ? nullptr : &timeout);
+            }
+            control->consumerWaiting.store(0, std::memory_order_seq_cst);
+
+            return hasData();
+        }
+
+
+    private:
+        static size_t getDataOffset()
+        {
+            return (sizeof(SegmentHeader) + CacheLine - 1) / CacheLine * CacheLine;
+        }
+
+        static size_t getRecordSize(size_t frameSize)
+        {
+            return (RecordHeaderSize + frameSize + 7) & ~(size_t)7;
+        }
+
+        SegmentHeader* getHeader() const
+        {
+            return static_cast<SegmentHeader*>(segment);
+        }
+
+        bool map(int fd, size_t size)
+        {
+            void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED)
+                return false;
+
+            shmFd = fd;
+            segment = address;
+            segmentSize = size;
+            return true;
+        }
+
+        void attachRings(int sendIndex, int receiveIndex)
+        {
+            uint8_t* data = static_cast<uint8_t*>(segment) + getDataOffset();
+            SegmentHeader* header = getHeader();
+
+            sendRing.control = &header->rings[sendIndex];
+            sendRing.data = data + sendIndex * capacity;
+            receiveRing.control = &header->rings[receiveIndex];
+            receiveRing.data = data + receiveIndex * capacity;
+
+            producerHead = sendRing.control->head.load(std::memory_order_acquire);
+            cachedTail = sendRing.control->tail.load(std::memory_order_acquire);
+            consumerTail = receiveRing.control->tail.load(std::memory_order_acquire);
+            cachedHead = receiveRing.control->head.load(std::memory_order_acquire);
+        }
+
+        static void writeRecordHeader(uint8_t* record, uint32_t length)
+        {
+            memcpy(record, &length, sizeof(length));
+        }
+
+        void releaseCurrent()
+        {
+            if (currentRecordSize == 0)
+                return;
+
+            consumerTail += currentRecordSize;
+            currentRecordSize = 0;
+            receiveRing.control->tail.store(consumerTail, std::memory_order_release);
+        }
+
+        bool hasData()
+        {
+            cachedHead = receiveRing.control->head.load(std::memory_order_seq_cst);
+            return cachedHead != consumerTail + currentRecordSize;
+        }
+
+        /**
+         * @brief Find the next record after the not released ones (skips padding).
+         * Doesn't release it. Head and records are written by the other process,
+         * so they are checked before use (record has to be inside the ring and before the head).
+         * @param record Set to the frame in the record.
+         */
+        bool peekRecord(DataBuffer& record)
+        {
+            while (true)
+            {
+                uint64_t next = consumerTail + currentRecordSize;
+                if (next == cachedHead)
+                {
+                    cachedHead = receiveRing.control->head.load(std::memory_order_seq_cst);
+                    if (next == cachedHead)
+                        return false;
+                }
+
+                uint64_t available = cachedHead - next;
+                uint64_t position = next % capacity;
+                if (available > capacity || available < RecordHeaderSize || position + RecordHeaderSize > capacity)
+                    return dropInvalidRecords();
+
+                uint32_t length;
+                memcpy(&length, receiveRing.data + position, sizeof(length));
+
+                if (length == PaddingRecord)
+                {
+                    if (capacity - position > available)
+                        return dropInvalidRecords();
+                    currentRecordSize += capacity - position;
+                    continue;
+                }
+
+                if (length == 0 || length > capacity - position - RecordHeaderSize || getRecordSize(length) > available)
+                    return dropInvalidRecords();
+
+                record = DataBuffer(receiveRing.data + position + RecordHeaderSize, length);
+                currentRecordSize += getRecordSize(length);
+                return true;
+            }
+        }
+
+        /**
+         * @brief Skip all data written by the other side (up to its head), the rest
+         * of the ring can't be trusted. Records that were already returned stay valid.
+         * If the head itself is out of the ring, nothing is read until it is valid again.
+         * @return false (no record).
+         */
+        bool dropInvalidRecords()
+        {
+            invalidRecords++;
+            uint64_t distance = cachedHead - (consumerTail + currentRecordSize);
+            if (distance <= capacity)
+                currentRecordSize += distance;
+            return false;
+        }
+
+        static long futex(std::atomic<uint32_t>* address, int operation, uint32_t value, const timespec* timeout)
+        {
+            return syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), operation, value, timeout, nullptr, 0);
+        }
+    };
+}
+
+
+#endif
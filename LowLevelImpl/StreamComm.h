@@ -11,116 +11,253 @@
 #ifndef STREAMCOMM_H
 #define STREAMCOMM_H
 
+#include "PacketCommConfig.h"
 #include "ITransceiver.h"
 #include "DataBuffer.h"
 #include "Encoding/COBS.h" // SLIP.h is alternative
+#include "Encoding/COBSEncoder.h"
+#include "Encoding/XORChecksum.h"
 #include <Arduino.h>
 #include <string.h>
 
 
 namespace PacketComm
 {
-    template <const size_t MaxBufferSize>
+    /**
+     * @brief Calls Stream methods used by StreamComm. If StreamType is
+     * a concrete class, calls are not virtual and can be inlined.
+     */
+    template <class StreamType, bool IsAbstract = __is_abstract(StreamType)>
+    struct StreamCalls
+    {
+        static int available(StreamType* stream) { return stream->StreamType::available(); }
+        static int read(StreamType* stream) { return stream->StreamType::read(); }
+        static size_t write(StreamType* stream, uint8_t data) { return stream->StreamType::write(data); }
+        static size_t write(StreamType* stream, const uint8_t* buffer, size_t size) { return stream->StreamType::write(buffer, size); }
+        static size_t readBytes(StreamType* stream, uint8_t* buffer, size_t length) { return stream->StreamType::readBytes(buffer, length); }
+        static int availableForWrite(StreamType* stream) { return stream->StreamType::availableForWrite(); }
+    };
+
+    template <class StreamType>
+    struct StreamCalls<StreamType, true>
+    {
+        static int available(StreamType* stream) { return stream->available(); }
+        static int read(StreamType* stream) { return stream->read(); }
+        static size_t write(StreamType* stream, uint8_t data) { return stream->write(data); }
+        static size_t write(StreamType* stream, const uint8_t* buffer, size_t size) { return stream->write(buffer, size); }
+        static size_t readBytes(StreamType* stream, uint8_t* buffer, size_t length) { return stream->readBytes(buffer, length); }
+        static int availableForWrite(StreamType* stream) { return stream->availableForWrite(); }
+    };
+
+    template <class A, class B>
+    struct IsSameType { static const bool value = false; };
+
+    template <class A>
+    struct IsSameType<A, A> { static const bool value = true; };
+
+    /**
+     * @brief value is false if StreamType inherits availableForWrite() from Print,
+     * which always returns 0 (eg. SoftwareSerial, or any stream used through Stream).
+     */
+    template <class StreamType>
+    struct ImplementsAvailableForWrite
+    {
+        static const bool value = !IsSameType<decltype(&StreamType::availableForWrite), int (Print::*)()>::value;
+    };
+
+
+    /**
+     * @tparam MaxBufferSize Max size of the frame (whole packet with its header, not only the data).
+     * RAM used by buffers is about 3 * MaxBufferSize (encoded frame for sending and two encoded
+     * frames for receiving, each MaxBufferSize + 2 bytes or more for frames over 253 bytes) + SendQueueSize.
+     * @tparam StreamType Type of the stream. Default (Stream) works with any stream.
+     * Concrete type (eg. HardwareSerial) removes virtual calls for each byte,
+     * but the stream object has to be exactly of that type (not derived).
+     * @tparam SendQueueSize 0 - sending blocks until the whole frame is written to the stream.
+     * Otherwise sending never blocks: only availableForWrite() bytes are written, the rest of
+     * the frame is kept in the send queue of this size (bytes of encoded frames) and written
+     * by poll() (and receive()). Frames that don't fit the queue are not sent at all.
+     * StreamType has to be a concrete type that implements availableForWrite() (eg. HardwareSerial),
+     * otherwise nothing would be ever written, so it doesn't compile (eg. with Stream or SoftwareSerial).
+     */
+    template <const size_t MaxBufferSize, class StreamType = Stream, const size_t SendQueueSize = 0>
     class StreamComm : public ITransceiver
     {
+        typedef StreamCalls<StreamType> Calls;
+
+        static const bool NonBlocking = SendQueueSize > 0;
+        static const size_t SendQueueCapacity = NonBlocking ? SendQueueSize : 1;
+        static_assert(!NonBlocking || ImplementsAvailableForWrite<StreamType>::value,
+            "Non-blocking StreamComm needs StreamType that implements availableForWrite() (eg. HardwareSerial), use SendQueueSize = 0 otherwise");
+
         static const uint8_t PacketMarker;
-        Stream* stream;
+        static const size_t EncodedBufferSize = COBS::getEncodedBufferSize(MaxBufferSize + 1); // frame with checksum after encoding
+        static const size_t ReceiveBufferSize = 2 * EncodedBufferSize;
+        StreamType* stream;
 
         // sending helper variables:
-        uint8_t encodeBuffer[COBS::getEncodedBufferSize(MaxBufferSize)]; // buffer with data after encoding, used by sending methods
+        uint8_t encodeBuffer[EncodedBufferSize]; // buffer with data after encoding, used by sending methods
+
+        // non-blocking sending helper variables:
+        // Encoded bytes that were not written yet (ring buffer), frames are written in order.
+        uint8_t sendQueue[SendQueueCapacity];
+        size_t sendQueueBegin = 0; // first queued byte
+        size_t queuedBytes = 0; // amount of bytes in sendQueue
+
+        // statistics
+        uint32_t queuedFrames = 0; // frames that were not written at once
+        uint32_t wouldBlockFrames = 0; // frames that were not sent (no space in the queue)
 
         // receiving helper variables:
-        uint8_t receiveBuffer[MaxBufferSize]; // accumulate received bytes into array
-        size_t receiveBufferIndex = 0; // amount of data in receiveBuffer
-        uint8_t decodedData[MaxBufferSize]; // received and decoded data
-        size_t decodedDataSize = 0;
+        // Received bytes are read in chunks into receiveBuffer and frames are decoded in place,
+        // so one receiveBatch() call can return several frames. Incomplete frame is at the end.
+        uint8_t receiveBuffer[ReceiveBufferSize];
+        size_t receivedBytes = 0; // amount of data in receiveBuffer
+        size_t frameBegin = 0; // beginning of the incomplete frame
+        size_t scanIndex = 0; // bytes before this index were already searched for the marker
+        bool discardingFrame_flag = false; // frame was too big, bytes are dropped until the next marker
+        DataBuffer currentReceived; // frame returned by getReceived()
+
+#if PACKETCOMM_LATENCY_TRACING
+        LatencyTracer* latencyTracer = nullptr;
+        uint32_t lastRead_us = 0; // time of the last readAvailable() that read any bytes
+#endif
 
 
     public:
+        static const size_t MaxFrameSize = MaxBufferSize; // max size of sent and received frames (packets)
+
         /**
          * @brief Ctor.
          * @param streamPtr Pointer to Arduino Stream object.
          * Initialize the stream manually outside of this class.
          */
-        explicit StreamComm(Stream* stream);
+        explicit StreamComm(StreamType* stream);
 
         StreamComm(const StreamComm& other) = delete;
         StreamComm& operator=(const StreamComm& other) = delete;
 
         bool send(const uint8_t* buffer, size_t size) override;
         bool send(const AutoDataBuffer& buffer) override;
+        bool sendFrame(FrameBuffer& frame) override;
+        bool sendParts(const DataBuffer* parts, size_t count) override;
+        bool sendShared(SharedFrame& frame) override;
+        bool sendWithTrailer(const uint8_t* buffer, size_t size) override;
+        SharedFrame::Encoding getFraming() const override { return SharedFrame::Encoding::COBS_XOR_CHECKSUM; }
+        SharedFrame::Encoding getReceivedFraming() const override { return SharedFrame::Encoding::COBS_XOR_CHECKSUM; }
+        bool isSendPartsSupported() const override { return true; }
         bool receive() override;
         const DataBuffer getReceived() override;
+        size_t receiveBatch(DataBuffer* out, size_t max) override;
+        bool canSend(size_t size) override;
+        size_t getPendingSendSize() const override { return queuedBytes; }
+        bool poll() override;
+
+        uint32_t getQueuedFramesAmount() const { return queuedFrames; }
+        uint32_t getWouldBlockFramesAmount() const { return wouldBlockFrames; }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer) override
+        {
+            latencyTracer = tracer;
+        }
+#endif
+
 
     private:
         /**
-         * @brief Calculate the checksum for passed data buffer.
-         * @param buffer pointer to the array with data (only data).
-         * @param size size of the array with data.
-         * @return checksum for the passed data buffer.
+         * @brief Add checksum, encode and write the frame to the stream.
+         * @param buffer Frame with at least one free byte after it (for checksum).
+         * @param size Size of the frame (without free byte).
          */
-        uint8_t calculateChecksum(const uint8_t* buffer, size_t size)
-        {
-            uint8_t checksum = buffer[0];
-            for (size_t i = 1; i < size; i++)
-                checksum ^= buffer[i]; // xor'owanie kolejnych bajtow
-            
-            return checksum;
-        }
+        bool encodeAndWrite(uint8_t* buffer, size_t size);
 
         /**
-         * @brief Check if passed buffer checksum is correct.
-         * @param buffer pointer to the array of data (only data).
-         * @param size size of the array with data (amount of bytes).
-         * @param expectedChecksum checksum that that array should have.
-         * @return true if array has the same checksum as checksum in parameter,
-         * false otherwise.
+         * @brief Write encoded frame and the marker to the stream
+         * (or to the send queue in the non-blocking mode).
+         * @return false if the frame would block (nothing was written).
          */
-        bool checkChecksum(const uint8_t* buffer, size_t size, uint8_t expectedChecksum)
-        {
-            if (size == 0)
-                return false;
-            
-            return calculateChecksum(buffer, size) == expectedChecksum;
-        }
+        bool writeEncoded(const uint8_t* encoded, size_t numEncoded);
+
+        /**
+         * @brief Write as much of the frame as the stream accepts without blocking
+         * and queue the rest (after the already queued frames).
+         * @return false if the frame doesn't fit the stream and the queue.
+         */
+        bool writeNonBlocking(const uint8_t* encoded, size_t numEncoded);
+
+        /**
+         * @brief Add bytes at the end of the send queue (there has to be enough space).
+         */
+        void enqueue(const uint8_t* data, size_t size);
+
+        /**
+         * @return Amount of bytes that can be written to the stream without blocking.
+         */
+        size_t getAvailableForWrite();
+
+        /**
+         * @brief Read available bytes after the data in receiveBuffer.
+         * @param canMoveFrames true if decoded frames at the beginning of receiveBuffer
+         * are no longer needed (incomplete frame can be moved to the beginning).
+         * @return false if nothing was read.
+         */
+        bool readAvailable(bool canMoveFrames);
+
+        /**
+         * @brief Decode the frame in place and verify its checksum.
+         * @param frame Received bytes between markers.
+         * @param size Amount of received bytes.
+         * @return Decoded frame (without checksum) or empty buffer if frame is invalid.
+         */
+        DataBuffer decodeInPlace(uint8_t* frame, size_t size);
     };
 
 
 
-    template <const size_t MaxBufferSize>
-    const uint8_t StreamComm<MaxBufferSize>::PacketMarker = 0;
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const uint8_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::PacketMarker = 0;
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const size_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::EncodedBufferSize;
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const size_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::ReceiveBufferSize;
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const size_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::MaxFrameSize;
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::NonBlocking;
 
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const size_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::SendQueueCapacity;
 
-    template <const size_t MaxBufferSize>
-    StreamComm<MaxBufferSize>::StreamComm(Stream* stream)
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    StreamComm<MaxBufferSize, StreamType, SendQueueSize>::StreamComm(StreamType* stream)
     {
         this->stream = stream;
     }
 
 
-    template <const size_t MaxBufferSize>
-    bool StreamComm<MaxBufferSize>::send(const uint8_t* buffer, size_t size)
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::send(const uint8_t* buffer, size_t size)
     {
         if (buffer == nullptr || size == 0 || size > MaxBufferSize)
             return false;
 
-        uint8_t* bufferWithChecksum = new uint8_t[size + 1];
-        memcpy(bufferWithChecksum, buffer, size);
-        bufferWithChecksum[size] = calculateChecksum(buffer, size); // add checksum after the last byte
-
-        size_t numEncoded = COBS::encode(bufferWithChecksum, size + 1, encodeBuffer);
-
-        stream->write(encodeBuffer, numEncoded);
-        stream->write(PacketMarker);
+        // buffer has no space for the checksum, it is added to the encoded data (without a copy)
+        COBSEncoder encoder(encodeBuffer);
+        encoder.add(buffer, size);
+        encoder.add(XORChecksum::calculate(buffer, size));
 
-        delete[] bufferWithChecksum;
-
-        return true;
+        return writeEncoded(encodeBuffer, encoder.finish());
     }
 
 
-    template <const size_t MaxBufferSize>
-    bool StreamComm<MaxBufferSize>::send(const AutoDataBuffer& buffer)
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::send(const AutoDataBuffer& buffer)
     {
         if (buffer.size == 0 || buffer.size > MaxBufferSize)
             return false;
@@ -131,68 +268,345 @@ namespace PacketComm
         if (buffer.size > buffer.AllocatedSize) // in this case data packet is corrupted - memory used is bigger than allocated memory
             return false;
         
+        return encodeAndWrite(buffer.buffer, buffer.size);
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::sendFrame(FrameBuffer& frame)
+    {
+        if (frame.getSize() == 0 || frame.getSize() > MaxBufferSize)
+            return false;
+
+        if (frame.getTailroom() == 0)
+            return send(frame.getData(), frame.getSize());
+
+        return encodeAndWrite(frame.getData(), frame.getSize()); // checksum is placed in the tailroom
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::encodeAndWrite(uint8_t* buffer, size_t size)
+    {
         // add checksum after the last byte
-        buffer.buffer[buffer.size] = calculateChecksum(buffer.buffer, buffer.size);
+        buffer[size] = XORChecksum::calculate(buffer, size);
 
-        size_t numEncoded = COBS::encode(buffer.buffer, buffer.size + 1, encodeBuffer);
+        size_t numEncoded = COBS::encode(buffer, size + 1, encodeBuffer);
+        return writeEncoded(encodeBuffer, numEncoded);
+    }
 
-        stream->write(encodeBuffer, numEncoded);
-        stream->write(PacketMarker);
 
-        return true;
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::sendParts(const DataBuffer* parts, size_t count)
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < count; ++i)
+            size += parts[i].size;
+        if (size == 0 || size > MaxBufferSize)
+            return false;
+
+        // Parts are encoded directly, checksum is calculated on the way
+        COBSEncoder encoder(encodeBuffer);
+        uint8_t checksum = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (parts[i].size == 0)
+                continue;
+            checksum ^= XORChecksum::calculate(parts[i].buffer, parts[i].size);
+            encoder.add(parts[i].buffer, parts[i].size);
+        }
+        encoder.add(checksum);
+
+        return writeEncoded(encodeBuffer, encoder.finish());
     }
 
 
-    template <const size_t MaxBufferSize>
-    bool StreamComm<MaxBufferSize>::receive()
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::sendShared(SharedFrame& frame)
     {
-        while (stream->available() > 0)
+        DataBuffer data = frame.getData();
+        if (data.size == 0 || data.size > MaxBufferSize)
+            return false;
+
+        // Frame is encoded only by the first StreamComm, others write the same bytes
+        DataBuffer encoded = frame.getEncoded(SharedFrame::Encoding::COBS_XOR_CHECKSUM);
+        if (encoded.buffer == nullptr)
         {
-            uint8_t data = stream->read();
+            uint8_t* destination = frame.allocateEncoded(SharedFrame::Encoding::COBS_XOR_CHECKSUM, COBS::getEncodedBufferSize(data.size + 1));
+            if (destination == nullptr)
+                return sendFrame(frame.getFrame()); // encoded frame could not be shared
+
+            COBSEncoder encoder(destination);
+            encoder.add(data.buffer, data.size);
+            encoder.add(XORChecksum::calculate(data.buffer, data.size));
+            frame.setEncodedSize(encoder.finish());
+            encoded = frame.getEncoded(SharedFrame::Encoding::COBS_XOR_CHECKSUM);
+        }
+
+        return writeEncoded(encoded.buffer, encoded.size);
+    }
+
 
-            if (data == PacketMarker)
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::sendWithTrailer(const uint8_t* buffer, size_t size)
+    {
+        if (buffer == nullptr || size == 0 || size > MaxBufferSize)
+            return false;
+
+        // checksum was verified by the receiving StreamComm and is right after the frame
+        size_t numEncoded = COBS::encode(buffer, size + 1, encodeBuffer);
+        return writeEncoded(encodeBuffer, numEncoded);
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::writeEncoded(const uint8_t* encoded, size_t numEncoded)
+    {
+#if PACKETCOMM_LATENCY_TRACING
+        if (latencyTracer != nullptr)
+            latencyTracer->markSendEncoded();
+#endif
+
+        if (NonBlocking)
+        {
+            if (!writeNonBlocking(encoded, numEncoded))
             {
-                decodedDataSize = COBS::decode(receiveBuffer, receiveBufferIndex, decodedData);
-                if (decodedDataSize == 0)
-                    continue;
+                wouldBlockFrames++;
+                return false;
+            }
+        }
+        else if (Calls::write(stream, encoded, numEncoded) != numEncoded || Calls::write(stream, PacketMarker) != 1)
+            return false; // stream failed or timed out (receiver drops the cut frame)
+
+#if PACKETCOMM_LATENCY_TRACING
+        if (latencyTracer != nullptr)
+            latencyTracer->markSendWritten(); // or queued
+#endif
+        return true;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::writeNonBlocking(const uint8_t* encoded, size_t numEncoded)
+    {
+        poll(); // queued frames are written first
+
+        size_t frameSize = numEncoded + 1; // with the marker
+        size_t writable = queuedBytes == 0 ? getAvailableForWrite() : 0;
+        if (frameSize > writable + SendQueueCapacity - queuedBytes)
+            return false;
+
+        size_t written = 0;
+        if (writable > 0)
+        {
+            written = Calls::write(stream, encoded, writable < numEncoded ? writable : numEncoded);
+            if (written == numEncoded && writable > numEncoded)
+                written += Calls::write(stream, PacketMarker);
+        }
+
+        if (written == frameSize)
+            return true;
+
+        // Rest of the frame is written by poll(). If the stream accepted less than
+        // availableForWrite() and the rest doesn't fit, the frame is cut (receiver drops it).
+        size_t rest = written < numEncoded ? numEncoded - written : 0;
+        size_t freeSpace = SendQueueCapacity - queuedBytes;
+        if (rest >= freeSpace)
+            rest = freeSpace - 1;
+        enqueue(encoded + written, rest);
+        enqueue(&PacketMarker, 1);
+        queuedFrames++;
+        return true;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    void StreamComm<MaxBufferSize, StreamType, SendQueueSize>::enqueue(const uint8_t* data, size_t size)
+    {
+        size_t end = (sendQueueBegin + queuedBytes) % SendQueueCapacity;
+        size_t firstPart = SendQueueCapacity - end;
+        if (firstPart > size)
+            firstPart = size;
+
+        memcpy(sendQueue + end, data, firstPart);
+        memcpy(sendQueue, data + firstPart, size - firstPart);
+        queuedBytes += size;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    size_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::getAvailableForWrite()
+    {
+        int available = Calls::availableForWrite(stream);
+        return available > 0 ? (size_t)available : 0;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::poll()
+    {
+        while (queuedBytes > 0)
+        {
+            size_t writable = getAvailableForWrite();
+            size_t contiguous = SendQueueCapacity - sendQueueBegin;
+            if (contiguous > queuedBytes)
+                contiguous = queuedBytes;
+            if (writable > contiguous)
+                writable = contiguous;
+
+            size_t written = writable > 0 ? Calls::write(stream, sendQueue + sendQueueBegin, writable) : 0;
+            if (written == 0)
+                return false; // stream output is full, try again later
+
+            sendQueueBegin = (sendQueueBegin + written) % SendQueueCapacity;
+            queuedBytes -= written;
+        }
+
+        sendQueueBegin = 0;
+        return true;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::canSend(size_t size)
+    {
+        if (!NonBlocking)
+            return true;
+
+        poll();
+        size_t freeSpace = SendQueueCapacity - queuedBytes;
+        if (queuedBytes == 0)
+            freeSpace += getAvailableForWrite();
+        return COBS::getEncodedBufferSize(size + 1) + 1 <= freeSpace; // with checksum and marker
+    }
 
-                receiveBufferIndex = 0; // reset index in the received data buffer
 
-                uint8_t checksum = decodedData[decodedDataSize - 1];
-                bool checksumResult = checkChecksum(decodedData, decodedDataSize - 1, checksum);
-                decodedDataSize = checksumResult ? decodedDataSize-1 : 0; // if passed checksum test then "remove" checksum (decrease size), else buffer is corrupted
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::receive()
+    {
+        if (receiveBatch(&currentReceived, 1) > 0)
+            return true;
+
+        currentReceived = DataBuffer();
+        return false;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    const DataBuffer StreamComm<MaxBufferSize, StreamType, SendQueueSize>::getReceived()
+    {
+        return currentReceived;
+    }
 
-                if (decodedDataSize > 0) // Return true if packet has been received
-                    return true;
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    size_t StreamComm<MaxBufferSize, StreamType, SendQueueSize>::receiveBatch(DataBuffer* out, size_t max)
+    {
+        if (queuedBytes > 0)
+            poll();
+
+        size_t count = 0;
+
+        while (count < max)
+        {
+            if (scanIndex == receivedBytes && !readAvailable(count == 0))
+                break;
+
+            uint8_t* marker = (uint8_t*)memchr(receiveBuffer + scanIndex, PacketMarker, receivedBytes - scanIndex);
+            if (marker == nullptr)
+            {
+                scanIndex = receivedBytes;
+
+                if (discardingFrame_flag || receivedBytes - frameBegin > EncodedBufferSize)
+                {
+                    // ERROR, received frame is too big to decode (increase MaxBufferSize).
+                    // Drop it until the next marker.
+                    discardingFrame_flag = true;
+                    receivedBytes = scanIndex = frameBegin;
+                }
+                continue;
             }
-            else
+
+            size_t frameEnd = marker - receiveBuffer;
+            uint8_t* frame = receiveBuffer + frameBegin;
+            size_t frameSize = frameEnd - frameBegin;
+
+            if (!discardingFrame_flag && frameSize <= EncodedBufferSize)
             {
-                if (receiveBufferIndex + 1 < MaxBufferSize)
-                    receiveBuffer[receiveBufferIndex++] = data;
-                else
+                DataBuffer decoded = decodeInPlace(frame, frameSize);
+                if (decoded.size > 0)
                 {
-                    // ERROR, buffer overflow if we write.
-                    // Received buffer was too big to decode (increase MaxBufferSize).
-
-                    // Finnish receiving this packet and reset the receiveBuffer
-                    while (stream->available() && stream->read() != PacketMarker);
-                    receiveBufferIndex = 0;
-                    decodedDataSize = 0;
-                    //return false;
+#if PACKETCOMM_LATENCY_TRACING
+                    if (latencyTracer != nullptr)
+                        latencyTracer->markFrameComplete(decoded);
+#endif
+                    out[count++] = decoded;
                 }
             }
+
+            discardingFrame_flag = false;
+            frameBegin = scanIndex = frameEnd + 1;
+
+#if PACKETCOMM_LATENCY_TRACING
+            // bytes after the marker were read by the last read (the rest was already scanned)
+            if (frameBegin < receivedBytes && latencyTracer != nullptr)
+                latencyTracer->markFrameStart(lastRead_us);
+#endif
         }
 
-        // Any complete buffer was received.
-        decodedDataSize = 0;
-        return false;
+        return count;
+    }
+
+
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    bool StreamComm<MaxBufferSize, StreamType, SendQueueSize>::readAvailable(bool canMoveFrames)
+    {
+        if (canMoveFrames && frameBegin > 0)
+        {
+            // incomplete frame is moved to the beginning
+            receivedBytes -= frameBegin;
+            scanIndex -= frameBegin;
+            memmove(receiveBuffer, receiveBuffer + frameBegin, receivedBytes);
+            frameBegin = 0;
+        }
+
+        int available = Calls::available(stream);
+        size_t freeSpace = ReceiveBufferSize - receivedBytes;
+        if (available <= 0 || freeSpace == 0)
+            return false; // if buffer is full of returned frames, the rest is read by the next call
+
+        size_t toRead = (size_t)available < freeSpace ? (size_t)available : freeSpace;
+        size_t numRead = Calls::readBytes(stream, receiveBuffer + receivedBytes, toRead);
+
+#if PACKETCOMM_LATENCY_TRACING
+        if (numRead > 0 && latencyTracer != nullptr)
+        {
+            lastRead_us = micros();
+            if (receivedBytes == frameBegin)
+                latencyTracer->markFrameStart(lastRead_us); // first bytes of a new frame
+        }
+#endif
+
+        receivedBytes += numRead;
+        return numRead > 0;
     }
 
 
-    template <const size_t MaxBufferSize>
-    const DataBuffer StreamComm<MaxBufferSize>::getReceived()
+    template <const size_t MaxBufferSize, class StreamType, const size_t SendQueueSize>
+    DataBuffer StreamComm<MaxBufferSize, StreamType, SendQueueSize>::decodeInPlace(uint8_t* frame, size_t size)
     {
-        return DataBuffer(decodedData, decodedDataSize);
+        // decoded data is never longer than encoded, so it can overwrite the source
+        size_t decodedSize = COBS::decode(frame, size, frame);
+        if (decodedSize < 2)
+            return DataBuffer(); // no data or only checksum
+
+        // if passed checksum test then "remove" checksum (decrease size), else buffer is corrupted
+        // (checksum stays after the frame, see getReceivedFraming())
+        uint8_t checksum = frame[decodedSize - 1];
+        if (!XORChecksum::check(frame, decodedSize - 1, checksum))
+            return DataBuffer();
+
+        return DataBuffer(frame, decodedSize - 1);
     }
 }
 
@@ -0,0 +1,402 @@
+/**
+ * @file TraceFile.h
+ * @author Jan Wielgus
+ * @brief Append-only binary trace of timestamped frames and raw stream bytes,
+ * written and read through mmap (see CaptureComm.h and ReplayComm.h).
+ * Host only.
+ * @date 2026-10-19
+ */
+
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+#include "DataBuffer.h"
+#include <atomic>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+namespace PacketComm
+{
+    enum class TraceRecordType : uint8_t
+    {
+        FRAME_SENT,     // frame passed to the transceiver (decoded)
+        FRAME_RECEIVED, // frame returned by the transceiver (decoded)
+        RAW_SENT,       // bytes written to the stream (encoded)
+        RAW_RECEIVED    // bytes read from the stream (encoded)
+    };
+
+
+    struct TraceRecord
+    {
+        uint64_t timestamp_ns; // since the trace was opened for writing
+        TraceRecordType type;
+        uint8_t channel; // eg. index of the captured link
+        DataBuffer data;
+    };
+
+
+    /**
+     * @brief Layout of the trace file shared by TraceWriter and TraceReader.
+     * File header is followed by records (record header and data padded to 8 bytes).
+     */
+    class TraceFormat
+    {
+    protected:
+        static const uint32_t Magic = 0x504B5452; // "PKTR"
+        static const uint32_t Version = 1;
+        static const size_t Alignment = 8;
+
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            std::atomic<uint64_t> dataSize; // bytes of complete records
+            uint64_t startWallTime_ns; // CLOCK_REALTIME when the trace was opened
+            uint64_t reserved;
+        };
+
+        struct RecordHeader
+        {
+            uint64_t timestamp_ns;
+            uint32_t size;
+            uint8_t type;
+            uint8_t channel;
+            uint16_t reserved;
+        };
+
+        static_assert(sizeof(FileHeader) % Alignment == 0 && sizeof(RecordHeader) % Alignment == 0,
+            "Trace headers have to keep records aligned");
+
+        static size_t getRecordSize(size_t dataSize)
+        {
+            return sizeof(RecordHeader) + (dataSize + Alignment - 1) / Alignment * Alignment;
+        }
+
+        static uint64_t getTime_ns(clockid_t clock = CLOCK_MONOTONIC)
+        {
+            timespec now;
+            clock_gettime(clock, &now);
+            return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+        }
+    };
+
+
+
+    /**
+     * @brief Appends records to the memory mapped file. File grows by growStep bytes
+     * when needed and is truncated to the recorded data on close().
+     * Size of complete records is updated in the file header after each record,
+     * so the trace can be read even if the process crashes.
+     * One writer per file, not thread-safe (use one writer per thread).
+     */
+    class TraceWriter : private TraceFormat
+    {
+        int fd = -1;
+        uint8_t* mapping = nullptr;
+        size_t mappingSize = 0;
+        size_t growStep = 0;
+        size_t writePosition = 0;
+        uint64_t startTime_ns = 0;
+
+        // statistics
+        uint32_t recordsAmount = 0;
+        uint32_t failedRecords = 0;
+
+    public:
+        TraceWriter() = default;
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        ~TraceWriter()
+        {
+            close();
+        }
+
+        /**
+         * @brief Create the trace file (existing file is truncated).
+         * @param path Path to the file.
+         * @param growStep Amount of bytes the file grows by when it is full.
+         * @return false if file could not be created or mapped.
+         */
+        bool open(const char* path, size_t growStep = 1 << 20)
+        {
+            close();
+
+            this->growStep = growStep > sizeof(FileHeader) ? growStep : sizeof(FileHeader);
+            fd = ::open(path, O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0)
+                return false;
+
+            if (!resize(this->growStep))
+            {
+                close();
+                return false;
+            }
+
+            FileHeader* header = getHeader();
+            header->magic = Magic;
+            header->version = Version;
+            header->dataSize.store(0, std::memory_order_relaxed);
+            header->startWallTime_ns = getTime_ns(CLOCK_REALTIME);
+            header->reserved = 0;
+
+            writePosition = sizeof(FileHeader);
+            startTime_ns = getTime_ns();
+            recordsAmount = 0;
+            failedRecords = 0;
+            return true;
+        }
+
+        /**
+         * @brief Truncate the file to recorded data and unmap it.
+         */
+        void close()
+        {
+            if (mapping != nullptr)
+                munmap(mapping, mappingSize);
+            if (fd >= 0)
+            {
+                if (writePosition > 0 && ftruncate(fd, writePosition) != 0)
+                    failedRecords++;
+                ::close(fd);
+            }
+
+            fd = -1;
+            mapping = nullptr;
+            mappingSize = 0;
+            writePosition = 0;
+        }
+
+        bool isOpen() const
+        {
+            return mapping != nullptr;
+        }
+
+        /**
+         * @brief Append record with data made of parts (eg. from ITransmitter::sendParts()).
+         * @return false if trace is not open or file could not grow.
+         */
+        bool append(TraceRecordType type, uint8_t channel, const DataBuffer* parts, size_t count)
+        {
+            size_t size = 0;
+            for (size_t i = 0; i < count; ++i)
+                size += parts[i].size;
+
+            size_t recordSize = getRecordSize(size);
+            if (!isOpen() || size > UINT32_MAX || !ensureSpace(recordSize))
+            {
+                failedRecords++;
+                return false;
+            }
+
+            RecordHeader* record = (RecordHeader*)(mapping + writePosition);
+            record->timestamp_ns = getTime_ns() - startTime_ns;
+            record->size = (uint32_t)size;
+            record->type = (uint8_t)type;
+            record->channel = channel;
+            record->reserved = 0;
+
+            uint8_t* data = (uint8_t*)(record + 1);
+            for (size_t i = 0; i < count; ++i)
+            {
+                memcpy(data, parts[i].buffer, parts[i].size);
+                data += parts[i].size;
+            }
+
+            writePosition += recordSize;
+            getHeader()->dataSize.store(writePosition - sizeof(FileHeader), std::memory_order_release);
+            recordsAmount++;
+            return true;
+        }
+
+        bool append(TraceRecordType type, uint8_t channel, const uint8_t* buffer, size_t size)
+        {
+            DataBuffer part(const_cast<uint8_t*>(buffer), size);
+            return append(type, channel, &part, 1);
+        }
+
+        uint32_t getRecordsAmount() const { return recordsAmount; }
+        uint32_t getFailedRecordsAmount() const { return failedRecords; }
+
+
+    private:
+        FileHeader* getHeader()
+        {
+            return (FileHeader*)mapping;
+        }
+
+        bool ensureSpace(size_t recordSize)
+        {
+            if (writePosition + recordSize <= mappingSize)
+                return true;
+
+            size_t newSize = mappingSize + growStep;
+            if (newSize < writePosition + recordSize)
+                newSize = writePosition + recordSize;
+            return resize(newSize);
+        }
+
+        bool resize(size_t newSize)
+        {
+            if (ftruncate(fd, newSize) != 0)
+                return false;
+
+            void* newMapping = mapping == nullptr
+                ? mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                : mremap(mapping, mappingSize, newSize, MREMAP_MAYMOVE);
+            if (newMapping == MAP_FAILED)
+                return false;
+
+            mapping = (uint8_t*)newMapping;
+            mappingSize = newSize;
+            return true;
+        }
+    };
+
+
+
+    /**
+     * @brief Reads records of the trace file. File is mapped privately, so data
+     * of returned records can be modified (like buffers returned by transceivers)
+     * and stays valid until close().
+     */
+    class TraceReader : private TraceFormat
+    {
+        uint8_t* mapping = nullptr;
+        size_t mappingSize = 0;
+        size_t dataEnd = 0;
+        size_t readPosition = 0;
+        uint64_t startWallTime_ns = 0;
+
+    public:
+        TraceReader() = default;
+
+        TraceReader(const TraceReader&) = delete;
+        TraceReader& operator=(const TraceReader&) = delete;
+
+        ~TraceReader()
+        {
+            close();
+        }
+
+        /**
+         * @brief Open the trace file (also the one that is still written or was left
+         * by a crashed process, then only complete records are read).
+         * @return false if file could not be opened or is not a trace file.
+         */
+        bool open(const char* path)
+        {
+            close();
+
+            int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return false;
+
+            struct stat info;
+            if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(FileHeader))
+            {
+                ::close(fd);
+                return false;
+            }
+
+            void* newMapping = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ::close(fd); // mapping keeps the file
+            if (newMapping == MAP_FAILED)
+                return false;
+
+            mapping = (uint8_t*)newMapping;
+            mappingSize = info.st_size;
+
+            FileHeader* header = (FileHeader*)mapping;
+            uint64_t dataSize = header->dataSize.load(std::memory_order_acquire);
+            if (header->magic != Magic || header->version != Version || dataSize > mappingSize - sizeof(FileHeader))
+            {
+                close();
+                return false;
+            }
+
+            dataEnd = sizeof(FileHeader) + dataSize;
+            startWallTime_ns = header->startWallTime_ns;
+            rewind();
+            return true;
+        }
+
+        void close()
+        {
+            if (mapping != nullptr)
+                munmap(mapping, mappingSize);
+
+            mapping = nullptr;
+            mappingSize = 0;
+            dataEnd = 0;
+            readPosition = 0;
+        }
+
+        bool isOpen() const
+        {
+            return mapping != nullptr;
+        }
+
+        /**
+         * @brief Read the next record.
+         * @param record Output record (data points into the mapped file).
+         * @return false if there are no more records.
+         */
+        bool next(TraceRecord& record)
+        {
+            return next(record, readPosition);
+        }
+
+        /**
+         * @brief Read the record at the given position (independent of next(record)),
+         * so many readers of one file can read at their own pace.
+         * @param record Output record (data points into the mapped file).
+         * @param position Position of the record, 0 for the first one. Set to the next record.
+         * @return false if there are no more records.
+         */
+        bool next(TraceRecord& record, size_t& position) const
+        {
+            if (mapping == nullptr)
+                return false;
+            if (position < sizeof(FileHeader))
+                position = sizeof(FileHeader);
+            if (position + sizeof(RecordHeader) > dataEnd)
+                return false;
+
+            RecordHeader* header = (RecordHeader*)(mapping + position);
+            size_t recordSize = getRecordSize(header->size);
+            if (recordSize > dataEnd - position)
+                return false; // corrupted record
+
+            record.timestamp_ns = header->timestamp_ns;
+            record.type = (TraceRecordType)header->type;
+            record.channel = header->channel;
+            record.data = DataBuffer((uint8_t*)(header + 1), header->size);
+
+            position += recordSize;
+            return true;
+        }
+
+        /**
+         * @brief Start reading from the first record again.
+         */
+        void rewind()
+        {
+            readPosition = mapping != nullptr ? sizeof(FileHeader) : 0;
+        }
+
+        /**
+         * @return Wall clock time (CLOCK_REALTIME) when the trace was started.
+         */
+        uint64_t getStartWallTime_ns() const { return startWallTime_ns; }
+    };
+}
+
+
+#endif
@@ -9,6 +9,14 @@
 using namespace PacketComm;
 
 
+const size_t Packet::MinHeaderSize;
+const size_t Packet::MaxHeaderSize;
+
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+static const size_t IDMaxSize = 3; // varint of 16-bit ID
+#endif
+
+
 Packet::Packet(PacketIDType packetID, Type type, Callback callback)
     : PacketID(packetID), packetType(type), onReceiveCallback(callback)
 {
@@ -23,8 +31,69 @@ void Packet::setOnReceiveCallback(Callback callback)
 
 size_t Packet::getBuffer(uint8_t* outputBuffer) const
 {
-    PacketIDType id = PacketID;
+    size_t headerSize = writeHeader(outputBuffer);
+    return headerSize + getDataOnly(outputBuffer + headerSize);
+}
+
+
+size_t Packet::getBufferParts(uint8_t* headerBuffer, DataBuffer* parts) const
+{
+    DataBuffer data;
+    if (getDataOnlySize() > 0)
+    {
+        data = getDataOnlyInPlace();
+        if (data.buffer == nullptr)
+            return 0; // header is not written (sequence number is used by getBuffer())
+    }
+
+    parts[0] = DataBuffer(headerBuffer, writeHeader(headerBuffer));
+    if (data.buffer == nullptr)
+        return 1;
+
+    parts[1] = data;
+    return 2;
+}
+
+
+DataBuffer Packet::getDataOnlyInPlace() const
+{
+    return DataBuffer();
+}
+
+
+bool Packet::isDataValid(const uint8_t* inputBuffer, size_t size) const
+{
+    (void)inputBuffer;
+    return size == getDataOnlySize();
+}
+
 
+size_t Packet::writeHeader(uint8_t* outputBuffer) const
+{
+    Header header;
+    header.id = PacketID;
+#if PACKETCOMM_HEADER_LENGTH
+    header.dataSize = getDataOnlySize();
+#else
+    header.dataSize = 0;
+#endif
+#if PACKETCOMM_HEADER_SEQUENCE
+    header.sequence = ++sequence;
+#else
+    header.sequence = 0;
+#endif
+    return writeHeader(outputBuffer, header);
+}
+
+
+size_t Packet::writeHeader(uint8_t* outputBuffer, const Header& header)
+{
+    PacketIDType id = header.id;
+    size_t size = sizeof(PacketIDType);
+
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+    size = Varint::write(outputBuffer, id);
+#else
     // MSB is first (Big-endian)
     // copy byte by byte from last to first
     // for (int8_t i = sizeof(PacketIDType) - 1; i >= 0; --i)
@@ -39,8 +108,17 @@ size_t Packet::getBuffer(uint8_t* outputBuffer) const
         outputBuffer[i] = uint8_t(id & 0xff);
         id >>= 8;
     }
+#endif
 
-    return sizeof(PacketIDType) + getDataOnly(outputBuffer + sizeof(PacketIDType));
+#if PACKETCOMM_HEADER_LENGTH
+    size += Varint::write(outputBuffer + size, (uint32_t)header.dataSize);
+#endif
+
+#if PACKETCOMM_HEADER_SEQUENCE
+    outputBuffer[size++] = header.sequence;
+#endif
+
+    return size;
 }
 
 
@@ -49,13 +127,42 @@ bool Packet::updatePacketBuffer(const uint8_t* inputBuffer)
     if (!checkIfBufferMatch(inputBuffer))
         return false;
 
-    updateDataOnly(inputBuffer + sizeof(PacketIDType));
+    size_t headerSize = getHeaderSizeFromBuffer(inputBuffer);
+#if PACKETCOMM_HEADER_SEQUENCE
+    sequence = inputBuffer[headerSize - 1];
+#endif
+    updateDataOnly(inputBuffer + headerSize);
+    return true;
+}
+
+
+bool Packet::getIDFromBuffer(const uint8_t* buffer, size_t size, PacketIDType& id)
+{
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+    if (Varint::getEncodedSize(buffer, size < IDMaxSize ? size : IDMaxSize) == 0)
+        return false;
+
+    uint32_t varintID;
+    Varint::read(buffer, varintID);
+    if (varintID > 0xFFFF)
+        return false;
+#else
+    if (size < sizeof(PacketIDType))
+        return false;
+#endif
+
+    id = readID(buffer);
     return true;
 }
 
 
-Packet::PacketIDType Packet::getIDFromBuffer(const uint8_t* buffer)
+Packet::PacketIDType Packet::readID(const uint8_t* buffer)
 {
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+    uint32_t varintID;
+    Varint::read(buffer, varintID);
+    return (PacketIDType)varintID;
+#else
     PacketIDType id = 0;
 
     // MSB is first (Big-endian)
@@ -72,4 +179,71 @@ Packet::PacketIDType Packet::getIDFromBuffer(const uint8_t* buffer)
         id |= buffer[i];
     }
     return id;
+#endif
+}
+
+
+bool Packet::readHeader(const DataBuffer& buffer, Header& header)
+{
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+    size_t position = Varint::getEncodedSize(buffer.buffer, buffer.size < IDMaxSize ? buffer.size : IDMaxSize);
+    if (position == 0)
+        return false;
+
+    uint32_t varintID;
+    Varint::read(buffer.buffer, varintID);
+    if (varintID > 0xFFFF)
+        return false;
+    header.id = (PacketIDType)varintID;
+#else
+    size_t position = sizeof(PacketIDType);
+    if (buffer.size < position)
+        return false;
+    header.id = readID(buffer.buffer);
+#endif
+
+#if PACKETCOMM_HEADER_LENGTH
+    size_t lengthSize = Varint::getEncodedSize(buffer.buffer + position, buffer.size - position);
+    uint32_t dataSize;
+    if (lengthSize == 0)
+        return false;
+    Varint::read(buffer.buffer + position, dataSize);
+    position += lengthSize;
+#endif
+
+#if PACKETCOMM_HEADER_SEQUENCE
+    if (buffer.size <= position)
+        return false;
+    header.sequence = buffer.buffer[position++];
+#else
+    header.sequence = 0;
+#endif
+
+    header.size = position;
+    header.dataSize = buffer.size - position;
+
+#if PACKETCOMM_HEADER_LENGTH
+    if (dataSize != header.dataSize)
+        return false;
+#endif
+
+    return true;
+}
+
+
+size_t Packet::getHeaderSizeFromBuffer(const uint8_t* buffer)
+{
+#if PACKETCOMM_HEADER_ID_SIZE != 0 && !PACKETCOMM_HEADER_LENGTH
+    (void)buffer; // header has fixed size
+#endif
+
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+    size_t size = Varint::getEncodedSize(buffer, IDMaxSize);
+#else
+    size_t size = sizeof(PacketIDType);
+#endif
+#if PACKETCOMM_HEADER_LENGTH
+    size += Varint::getEncodedSize(buffer + size, Varint::MaxSize);
+#endif
+    return size + PACKETCOMM_HEADER_SEQUENCE;
 }
@@ -8,12 +8,19 @@
 #ifndef PACKET_H
 #define PACKET_H
 
+#include "DataBuffer.h"
+#include "PacketCommConfig.h"
+#include "Encoding/FieldCodecs.h"
 #include <stdint.h>
 #include <stddef.h>
 
 
 namespace PacketComm
 {
+    template <class Transceiver> class PacketCommunicationT;
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize> class StaticPacketCommunication;
+
+
     /**
      * @brief Base class for all data packets.
      */
@@ -21,7 +28,37 @@ namespace PacketComm
     {
     public:
         typedef void (*Callback)(); // void function pointer
+
+#if PACKETCOMM_HEADER_ID_SIZE == 1
+        typedef uint8_t PacketIDType;
+#elif PACKETCOMM_HEADER_ID_SIZE == 2 || PACKETCOMM_HEADER_ID_SIZE == 0
         typedef uint16_t PacketIDType;
+#elif PACKETCOMM_HEADER_ID_SIZE == 4
+        typedef uint32_t PacketIDType;
+#else
+#error "PACKETCOMM_HEADER_ID_SIZE has to be 0 (varint), 1, 2 or 4"
+#endif
+
+        /**
+         * @brief Header of a received packet (see PacketCommConfig.h).
+         */
+        struct Header
+        {
+            PacketIDType id;
+            size_t size; // size of the header
+            size_t dataSize; // size of the data after the header
+            uint8_t sequence; // 0 if there is no sequence number in the header
+        };
+
+        // Size of the header (depends on the ID and data size if they are varints),
+        // use MaxHeaderSize for arrays of headers
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+        static const size_t MinHeaderSize = 1 + PACKETCOMM_HEADER_LENGTH + PACKETCOMM_HEADER_SEQUENCE;
+        static const size_t MaxHeaderSize = 3 + PACKETCOMM_HEADER_LENGTH * Varint::MaxSize + PACKETCOMM_HEADER_SEQUENCE;
+#else
+        static const size_t MinHeaderSize = sizeof(PacketIDType) + PACKETCOMM_HEADER_LENGTH + PACKETCOMM_HEADER_SEQUENCE;
+        static const size_t MaxHeaderSize = sizeof(PacketIDType) + PACKETCOMM_HEADER_LENGTH * Varint::MaxSize + PACKETCOMM_HEADER_SEQUENCE;
+#endif
 
         enum class Type
         {
@@ -34,8 +71,12 @@ namespace PacketComm
         const PacketIDType PacketID;
         const Type packetType;
         Callback onReceiveCallback;
+#if PACKETCOMM_HEADER_SEQUENCE
+        mutable uint8_t sequence = 0;
+#endif
 
         friend class PacketCommunication;
+        friend class PacketCommunicationCore;
 
 
     public:
@@ -56,10 +97,22 @@ namespace PacketComm
 
         /**
          * @return Size of this packet in bytes (total amount of bytes that
-         * this packet consists of including packet ID).
+         * this packet consists of including the header).
          */
         size_t getSize() const;
 
+        /**
+         * @return Size of the header of this packet in bytes.
+         */
+        size_t getHeaderSize() const;
+
+        /**
+         * @return Sequence number of the last sent or received packet (0 if sequence
+         * numbers are disabled by PACKETCOMM_HEADER_SEQUENCE). Each sent packet
+         * (each getBuffer() call) has the next number, gaps in received numbers are lost packets.
+         */
+        uint8_t getSequence() const;
+
         /**
          * @return Type of this packet.
          */
@@ -72,7 +125,7 @@ namespace PacketComm
         void setOnReceiveCallback(Callback callback);
 
         /**
-         * @brief Fill the outputBuffer with packet's internal data (includes PacketID).
+         * @brief Fill the outputBuffer with packet's internal data (includes the header).
          * outputBuffer size have to be at least packet size (check it with getSize() method).
          * @param outputBuffer Pointer to the array where data will be stored.
          * @return Size of this packet in bytes (same value that
@@ -80,6 +133,17 @@ namespace PacketComm
          */
         size_t getBuffer(uint8_t* outputBuffer) const;
 
+        /**
+         * @brief Get the packet as parts without copying its data: header (written to headerBuffer)
+         * and data placed in the packet's memory. Used for vectored sending (ITransmitter::sendParts()).
+         * @param headerBuffer Array of at least MaxHeaderSize bytes where the header will be stored.
+         * @param parts Array of 2 parts, filled with header and data.
+         * @return Amount of filled parts (1 if packet has no data) or 0 if data
+         * is not stored in one piece (use getBuffer() then, the header is not written
+         * and the sequence number is not used).
+         */
+        size_t getBufferParts(uint8_t* headerBuffer, DataBuffer* parts) const;
+
         /**
          * @brief Update packet internal buffer with an inputBuffer (inputBuffer have to
          * contain PacketID, basically have to be exactly what getBuffer() method returned).
@@ -93,8 +157,28 @@ namespace PacketComm
          * @brief Enables to check ID of buffer (if that buffer was inside a packet,
          * what would be its ID).
          * @param buffer Buffer to chech its ID.
+         * @param size Size of the buffer.
+         * @param id Read ID (set only if true is returned).
+         * @return false if the buffer is too short to contain the ID or the ID is invalid.
          */
-        static PacketIDType getIDFromBuffer(const uint8_t* buffer);
+        static bool getIDFromBuffer(const uint8_t* buffer, size_t size, PacketIDType& id);
+
+        /**
+         * @brief Read and check the header of a received buffer.
+         * @param buffer Received packet.
+         * @param header Output header.
+         * @return false if the buffer is too short or the header is invalid
+         * (eg. size in the header doesn't match the buffer size).
+         */
+        static bool readHeader(const DataBuffer& buffer, Header& header);
+
+        /**
+         * @brief Write the header (eg. changed header of a received packet).
+         * @param outputBuffer Array of at least MaxHeaderSize bytes.
+         * @param header Header to write (size is not used).
+         * @return Size of the written header.
+         */
+        static size_t writeHeader(uint8_t* outputBuffer, const Header& header);
 
 
     protected:
@@ -119,8 +203,45 @@ namespace PacketComm
          */
         virtual void updateDataOnly(const uint8_t* inputBuffer) = 0;
 
+        /**
+         * @return Packet data (excluding PacketID) in the packet's memory or empty buffer
+         * if data is not stored in one piece or can't be read in place. Empty by default.
+         */
+        virtual DataBuffer getDataOnlyInPlace() const;
+
+        /**
+         * @brief Check if received data can update this packet. By default its size
+         * has to be equal to getDataOnlySize(). Packets with variable size
+         * (eg. with varint fields) check the data itself.
+         * @param inputBuffer Received data (without the header).
+         * @param size Size of the received data.
+         * @return true if updateDataOnly() can be called with this data.
+         */
+        virtual bool isDataValid(const uint8_t* inputBuffer, size_t size) const;
+
 
     private:
+        /**
+         * @brief Write the header to the outputBuffer.
+         * @return Size of the header.
+         */
+        size_t writeHeader(uint8_t* outputBuffer) const;
+
+        /**
+         * @return Size of the header of this packet with data of dataSize bytes.
+         */
+        size_t getHeaderSize(size_t dataSize) const;
+
+        /**
+         * @return Size of the header at the beginning of the buffer (buffer has to contain whole header).
+         */
+        static size_t getHeaderSizeFromBuffer(const uint8_t* buffer);
+
+        /**
+         * @return ID at the beginning of the buffer (buffer has to contain whole valid ID).
+         */
+        static PacketIDType readID(const uint8_t* buffer);
+
         /**
          * @brief Execute received callback. If callback was not set,this method takes no action.
          */
@@ -147,7 +268,47 @@ namespace PacketComm
 
     inline size_t Packet::getSize() const
     {
-        return sizeof(PacketIDType) + getDataOnlySize();
+        size_t dataSize = getDataOnlySize();
+        return getHeaderSize(dataSize) + dataSize;
+    }
+
+
+    inline size_t Packet::getHeaderSize() const
+    {
+#if PACKETCOMM_HEADER_LENGTH
+        return getHeaderSize(getDataOnlySize());
+#else
+        return getHeaderSize(0);
+#endif
+    }
+
+
+    inline size_t Packet::getHeaderSize(size_t dataSize) const
+    {
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+        size_t size = Varint::getSize(PacketID);
+#else
+        size_t size = sizeof(PacketIDType);
+#endif
+#if PACKETCOMM_HEADER_LENGTH
+        size += Varint::getSize((uint32_t)dataSize);
+#else
+        (void)dataSize;
+#endif
+#if PACKETCOMM_HEADER_SEQUENCE
+        size += 1;
+#endif
+        return size;
+    }
+
+
+    inline uint8_t Packet::getSequence() const
+    {
+#if PACKETCOMM_HEADER_SEQUENCE
+        return sequence;
+#else
+        return 0;
+#endif
     }
 
 
@@ -166,7 +327,7 @@ namespace PacketComm
 
     inline bool Packet::checkIfBufferMatch(const uint8_t* buffer)
     {
-        return getIDFromBuffer(buffer) == PacketID;
+        return readID(buffer) == PacketID;
     }
 }
 
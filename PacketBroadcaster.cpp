@@ -0,0 +1,50 @@
+/**
+ * @file PacketBroadcaster.cpp
+ * @author Jan Wielgus
+ * @date 2026-10-19
+ */
+
+#include "PacketBroadcaster.h"
+
+using namespace PacketComm;
+
+
+PacketBroadcaster::PacketBroadcaster(IBufferAllocator* allocator)
+    : Allocator(allocator)
+{
+}
+
+
+bool PacketBroadcaster::addLink(ITransmitter* link)
+{
+    for (size_t i = 0; i < links.size(); ++i)
+        if (links[i] == link)
+            return false;
+
+    return links.add(link);
+}
+
+
+size_t PacketBroadcaster::send(const Packet* packetToSend)
+{
+    SharedFrame* frame = SharedFrame::create(packetToSend->getSize(), Allocator);
+    if (frame == nullptr)
+    {
+        failedSends += links.size();
+        return 0;
+    }
+
+    packetToSend->getBuffer(frame->getFrame().getData());
+
+    size_t sent = 0;
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+        if (links[i]->sendShared(*frame))
+            sent++;
+        else
+            failedSends++;
+    }
+
+    frame->release(); // links that still need the frame have retained it
+    return sent;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file PacketBroadcaster.h
+ * @author Jan Wielgus
+ * @brief Sends the same packet by many transmitters at once
+ * (eg. telemetry over serial, UDP and to a logger).
+ * @date 2026-10-19
+ */
+
+#ifndef PACKETBROADCASTER_H
+#define PACKETBROADCASTER_H
+
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "SharedFrame.h"
+#include "DataBuffer.h"
+#include <GrowingArray.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Packet is serialized once to the SharedFrame that is passed to all links
+     * (ITransmitter::sendShared()). Links with the same framing (eg. many StreamComm)
+     * encode it only once, links that send later (eg. LinuxUDPComm with send batching)
+     * keep the frame instead of copying it. Frame is released after the last link.
+     */
+    class PacketBroadcaster
+    {
+        SimpleDataStructures::GrowingArray<ITransmitter*> links;
+        IBufferAllocator* const Allocator;
+
+        // statistics
+        uint32_t failedSends = 0;
+
+    public:
+        /**
+         * @param allocator Allocator of shared frames (eg. BufferPool), new[] is used if nullptr.
+         */
+        explicit PacketBroadcaster(IBufferAllocator* allocator = nullptr);
+
+        PacketBroadcaster(const PacketBroadcaster&) = delete;
+        PacketBroadcaster& operator=(const PacketBroadcaster&) = delete;
+
+        /**
+         * @brief Add transmitter that will send all broadcasted packets.
+         * @return false if link was already added.
+         */
+        bool addLink(ITransmitter* link);
+
+        size_t getLinksAmount() const { return links.size(); }
+
+        /**
+         * @brief Send the packet by all links.
+         * @param packetToSend Pointer to the packet that need to be sent.
+         * @return Amount of links that sent the packet.
+         */
+        size_t send(const Packet* packetToSend);
+
+        /**
+         * @return Amount of sends that failed (counted for each link).
+         */
+        uint32_t getFailedSendsAmount() const { return failedSends; }
+    };
+}
+
+
+#endif
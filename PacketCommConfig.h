@@ -0,0 +1,68 @@
+/**
+ * @file PacketCommConfig.h
+ * @author Jan Wielgus
+ * @brief Compile-time configuration of the library.
+ * Change values in this file (or define them globally before
+ * including any library header) to enable optional features.
+ * @date 2026-10-19
+ */
+
+#ifndef PACKETCOMMCONFIG_H
+#define PACKETCOMMCONFIG_H
+
+
+// 1 - timestamp received and sent frames and collect latency histograms (see LatencyTracer.h),
+// 0 - tracing hooks are not compiled at all (no overhead)
+#ifndef PACKETCOMM_LATENCY_TRACING
+#define PACKETCOMM_LATENCY_TRACING 0
+#endif
+
+// Amount of different packet IDs that LatencyTracer can keep histograms for
+#ifndef PACKETCOMM_LATENCY_TRACKED_IDS
+#define PACKETCOMM_LATENCY_TRACKED_IDS 8
+#endif
+
+
+// Buffers of AutoDataBuffer up to this size (in bytes) are stored inside the object
+// instead of being allocated (0 - always allocate)
+#ifndef PACKETCOMM_INLINE_BUFFER_SIZE
+#define PACKETCOMM_INLINE_BUFFER_SIZE 16
+#endif
+
+
+// Free space reserved before and after each sent packet, so that transceivers
+// can add headers and trailers (eg. checksum) without copying (see FrameBuffer)
+#ifndef PACKETCOMM_FRAME_HEADROOM
+#define PACKETCOMM_FRAME_HEADROOM 4
+#endif
+
+#ifndef PACKETCOMM_FRAME_TAILROOM
+#define PACKETCOMM_FRAME_TAILROOM 4
+#endif
+
+
+// Packet header (the same on both sides). Default is a 2-byte ID only.
+// ID size: 1, 2 or 4 bytes (little-endian) or 0 - varint ID (1..3 bytes, IDs up to 65535)
+#ifndef PACKETCOMM_HEADER_ID_SIZE
+#define PACKETCOMM_HEADER_ID_SIZE 2
+#endif
+
+// 1 - header contains size of the packet data (varint), received packets are checked against it
+#ifndef PACKETCOMM_HEADER_LENGTH
+#define PACKETCOMM_HEADER_LENGTH 0
+#endif
+
+// 1 - header contains 1-byte sequence number of the packet (see Packet::getSequence())
+#ifndef PACKETCOMM_HEADER_SEQUENCE
+#define PACKETCOMM_HEADER_SEQUENCE 0
+#endif
+
+
+// Max amount of frames received from the transceiver by one receiveBatch() call
+// (array of this size is placed on the stack while receiving)
+#ifndef PACKETCOMM_RECEIVE_BATCH_SIZE
+#define PACKETCOMM_RECEIVE_BATCH_SIZE 8
+#endif
+
+
+#endif
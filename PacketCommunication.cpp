@@ -5,6 +5,7 @@
  */
 
 #include "PacketCommunication.h"
+#include <Arduino.h>
 
 using namespace PacketComm;
 
@@ -64,55 +65,28 @@ void PacketCommunication::receive()
 
 bool PacketCommunication::send(const Packet* packetToSend)
 {
-    // Make sending buffer size at least packet to send size + 1.
-    // It saves time because low level comm don't have to make bigger buffer to add checksum.
-    sendingBuffer.ensureAllocatedSize(packetToSend->getSize() + 1, false);
-    sendingBuffer.size = packetToSend->getSize();
-    packetToSend->getBuffer(sendingBuffer.buffer);
-    return LowLevelComm->send(sendingBuffer);
+    return PacketCommunicationCore::send(*this, LowLevelComm, packetToSend);
 }
 
 
-PacketCommunication::Percentage PacketCommunication::receiveAndUpdatePackets()
+bool PacketCommunication::poll()
 {
-    uint16_t receivedPacketsTotal = 0;
-    uint16_t successfullyReceivedPackets = 0;
-
-    while (LowLevelComm->receive())
-    {
-        receivedPacketsTotal++;
-
-        const DataBuffer receivedBuffer = LowLevelComm->getReceived();
-
-        Packet* matchingPacket = getRegisteredReceivePacket(receivedBuffer);
-        if (matchingPacket == nullptr)
-            continue;
-
-        switch (matchingPacket->getType())
-        {
-            case Packet::Type::DATA:
-                matchingPacket->updatePacketBuffer(receivedBuffer.buffer); // this method returns bool, but should be always true
-                matchingPacket->executeOnReceiveCallback();
-                break;
-
-            case Packet::Type::EVENT:
-                matchingPacket->executeOnReceiveCallback();
-                break;
+    return LowLevelComm->poll();
+}
 
-            // other types...
-            // TODO: string packet implementation
 
-            default:
-                continue; // invalid type
-        }
+#if PACKETCOMM_LATENCY_TRACING
+void PacketCommunication::setLatencyTracer(LatencyTracer* tracer)
+{
+    latencyTracer = tracer;
+    LowLevelComm->setLatencyTracer(tracer);
+}
+#endif
 
-        successfullyReceivedPackets++;
-    }
 
-    // Assess receiving
-    if (receivedPacketsTotal != 0)
-        return ((float)successfullyReceivedPackets / receivedPacketsTotal) * 100.f;
-    return 0;
+PacketCommunication::Percentage PacketCommunication::receiveAndUpdatePackets()
+{
+    return PacketCommunicationCore::receiveAndUpdatePackets(*this, LowLevelComm);
 }
 
 
@@ -139,8 +113,29 @@ Packet* PacketCommunication::getRegisteredReceivePacket(Packet::PacketIDType pac
 
 Packet* PacketCommunication::getRegisteredReceivePacket(const DataBuffer& buffer)
 {
-    Packet::PacketIDType idFromBuffer = Packet::getIDFromBuffer(buffer.buffer);
-    return getRegisteredReceivePacket(idFromBuffer, buffer.size);
+    Packet::Header header;
+    if (!Packet::readHeader(buffer, header))
+        return nullptr;
+
+    Packet* matchingPacket = getRegisteredReceivePacket(header.id);
+    if (matchingPacket != nullptr && matchingPacket->isDataValid(buffer.buffer + header.size, header.dataSize))
+        return matchingPacket;
+
+    return nullptr;
+}
+
+
+DataBuffer PacketCommunication::getSendingBuffer(size_t size)
+{
+    if (!sendingBuffer.ensureAllocatedSize(size, false))
+        return DataBuffer();
+    return DataBuffer(sendingBuffer.buffer, sendingBuffer.AllocatedSize);
+}
+
+
+void PacketCommunication::onPacketReceived(Packet* receivedPacket)
+{
+    (void)receivedPacket;
 }
 
 
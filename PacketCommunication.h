@@ -8,6 +8,8 @@
 #ifndef PACKETCOMMUNICATION_H
 #define PACKETCOMMUNICATION_H
 
+#include "PacketCommConfig.h"
+#include "PacketCommunicationCore.h"
 #include "IConnectionStatus.h"
 #include "ITransceiver.h"
 #include "Packet.h"
@@ -26,16 +28,22 @@ namespace PacketComm
      */
     class PacketCommunication : public IConnectionStatus
     {
+        friend class PacketCommunicationCore;
+
         FL::EVAFilter connectionStabilityFilter;
 
     protected:
         ITransceiver* const LowLevelComm;
         SimpleDataStructures::GrowingArray<Packet*> registeredReceivePackets;
         AutoDataBuffer sendingBuffer;
-        
+        ITransmitter::SendStatus lastSendStatus = ITransmitter::SendStatus::SENT;
+#if PACKETCOMM_LATENCY_TRACING
+        LatencyTracer* latencyTracer = nullptr;
+#endif
 
     public:
         typedef uint8_t Percentage;
+        typedef ITransmitter::SendStatus SendStatus;
 
         /**
          * @brief Construct a new Packet Communication object.
@@ -92,10 +100,33 @@ namespace PacketComm
         /**
          * @brief Send data packet passed in a parameter.
          * @param packetToSend Pointer to the data packet that need to be sent.
-         * @return false if data packet was not sent because of any reason.
+         * @return false if data packet was not sent because of any reason
+         * (see getLastSendStatus()). Packet queued by a non-blocking low-level comm counts as sent.
          */
         virtual bool send(const Packet* packetToSend);
 
+        /**
+         * @brief Continue sending of frames queued by a non-blocking low-level comm
+         * (see ITransmitter::poll()). StreamComm does it also while receiving, call it often if only sending.
+         * @return true if nothing is left to send.
+         */
+        bool poll();
+
+        /**
+         * @return Result of the last send() call: SENT, QUEUED (the rest is sent by poll()),
+         * WOULD_BLOCK (low-level comm output is full now, try again later) or FAILED.
+         */
+        SendStatus getLastSendStatus() const { return lastSendStatus; }
+
+#if PACKETCOMM_LATENCY_TRACING
+        /**
+         * @brief Set tracer that will collect latency histograms of received
+         * and sent packets. Tracer is passed also to the low-level comm.
+         * @param tracer Pointer to the tracer or nullptr to disable tracing.
+         */
+        void setLatencyTracer(LatencyTracer* tracer);
+#endif
+
 
     protected:
         /**
@@ -117,15 +148,28 @@ namespace PacketComm
 
         /**
          * @brief Search for packet in the registeredReceivePackets array using data buffer
-         * (checks it's ID and size) that could be updated with it.
+         * (checks its header and data, see Packet::readHeader() and Packet::isDataValid()) that could be updated with it.
          * This method don't modify neither buffer nor packet.
          * @param buffer Buffer for which we want to have a packet.
          * @return Pointer to the previously registered packet or nullptr if such packet was not found.
          */
         Packet* getRegisteredReceivePacket(const DataBuffer& buffer);
 
+        /**
+         * @brief Called after each successfully received packet was updated
+         * and its callback was executed. Does nothing by default.
+         * @param receivedPacket Pointer to the registered packet that was received.
+         */
+        virtual void onPacketReceived(Packet* receivedPacket);
+
 
     private:
+        /**
+         * @return sendingBuffer (allocated to at least size bytes) as DataBuffer
+         * with the allocated size, or empty DataBuffer if it could not be allocated.
+         */
+        DataBuffer getSendingBuffer(size_t size);
+
         /**
          * @brief Use after each receiving to update conneciton stability value.
          * @param receivedPercent assessment of received data [0 <= receivedPercent <= 100]
@@ -0,0 +1,210 @@
+/**
+ * @file PacketCommunicationCore.h
+ * @author Jan Wielgus
+ * @brief Send and receive paths shared by PacketCommunication,
+ * PacketCommunicationT and StaticPacketCommunication.
+ * @date 2026-10-19
+ */
+
+#ifndef PACKETCOMMUNICATIONCORE_H
+#define PACKETCOMMUNICATIONCORE_H
+
+#include "PacketCommConfig.h"
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "DataBuffer.h"
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Calls transceiver methods directly (not through ITransceiver),
+     * so they can be inlined. Transceiver has to be exactly of that type (not derived).
+     */
+    template <class Transceiver>
+    struct TransceiverCalls
+    {
+        static bool canSend(Transceiver* comm, size_t size) { return comm->Transceiver::canSend(size); }
+        static DataBuffer reserveSendBuffer(Transceiver* comm, size_t size) { return comm->Transceiver::reserveSendBuffer(size); }
+        static bool commitSendBuffer(Transceiver* comm, size_t size) { return comm->Transceiver::commitSendBuffer(size); }
+        static bool isSendPartsSupported(Transceiver* comm) { return comm->Transceiver::isSendPartsSupported(); }
+        static bool sendParts(Transceiver* comm, const DataBuffer* parts, size_t count) { return comm->Transceiver::sendParts(parts, count); }
+        static bool sendFrame(Transceiver* comm, FrameBuffer& frame) { return comm->Transceiver::sendFrame(frame); }
+        static size_t getPendingSendSize(Transceiver* comm) { return comm->Transceiver::getPendingSendSize(); }
+        static size_t receiveBatch(Transceiver* comm, DataBuffer* out, size_t max) { return comm->Transceiver::receiveBatch(out, max); }
+        static void selectBatchFrame(Transceiver* comm, size_t index) { comm->Transceiver::selectBatchFrame(index); }
+    };
+
+    /**
+     * @brief Virtual calls for any ITransceiver (PacketCommunication).
+     */
+    template <>
+    struct TransceiverCalls<ITransceiver>
+    {
+        static bool canSend(ITransceiver* comm, size_t size) { return comm->canSend(size); }
+        static DataBuffer reserveSendBuffer(ITransceiver* comm, size_t size) { return comm->reserveSendBuffer(size); }
+        static bool commitSendBuffer(ITransceiver* comm, size_t size) { return comm->commitSendBuffer(size); }
+        static bool isSendPartsSupported(ITransceiver* comm) { return comm->isSendPartsSupported(); }
+        static bool sendParts(ITransceiver* comm, const DataBuffer* parts, size_t count) { return comm->sendParts(parts, count); }
+        static bool sendFrame(ITransceiver* comm, FrameBuffer& frame) { return comm->sendFrame(frame); }
+        static size_t getPendingSendSize(ITransceiver* comm) { return comm->getPendingSendSize(); }
+        static size_t receiveBatch(ITransceiver* comm, DataBuffer* out, size_t max) { return comm->receiveBatch(out, max); }
+        static void selectBatchFrame(ITransceiver* comm, size_t index) { comm->selectBatchFrame(index); }
+    };
+
+
+    /**
+     * @brief Packet communication classes are friends of this class and pass themselves
+     * to its methods. Each of them has: LowLevelComm, lastSendStatus, latencyTracer (if tracing),
+     * getSendingBuffer(size) (buffer of at least size bytes for the frame or nullptr),
+     * getRegisteredReceivePacket(id) and onPacketReceived(packet).
+     */
+    class PacketCommunicationCore
+    {
+    public:
+        /**
+         * @brief Send the packet by the first way the low level comm supports:
+         * serialize it in place, pass the header and the data as parts
+         * or serialize it between headroom and tailroom of the sending buffer.
+         * Updates lastSendStatus.
+         */
+        template <class Communication, class Transceiver>
+        static bool send(Communication& communication, Transceiver* lowLevelComm, const Packet* packetToSend)
+        {
+            typedef TransceiverCalls<Transceiver> Calls;
+            typedef ITransmitter::SendStatus SendStatus;
+
+            size_t packetSize = packetToSend->getSize();
+            if (!Calls::canSend(lowLevelComm, packetSize))
+            {
+                // packet is not serialized when the low level comm can't take it now
+                communication.lastSendStatus = SendStatus::WOULD_BLOCK;
+                return false;
+            }
+
+#if PACKETCOMM_LATENCY_TRACING
+            if (communication.latencyTracer != nullptr)
+                communication.latencyTracer->markSendStart();
+#endif
+
+            // bytes of earlier frames that are still waiting don't make this one queued
+            size_t pendingBefore = Calls::getPendingSendSize(lowLevelComm);
+
+            bool result;
+            DataBuffer inPlaceBuffer = Calls::reserveSendBuffer(lowLevelComm, packetSize);
+            uint8_t headerBuffer[Packet::MaxHeaderSize];
+            DataBuffer parts[2];
+            size_t partsAmount;
+            DataBuffer sendingBuffer;
+
+            if (inPlaceBuffer.buffer != nullptr)
+            {
+                // Zero-copy: packet is written directly to the low level comm output
+                packetToSend->getBuffer(inPlaceBuffer.buffer);
+                result = Calls::commitSendBuffer(lowLevelComm, packetSize);
+            }
+            else if (Calls::isSendPartsSupported(lowLevelComm) && (partsAmount = packetToSend->getBufferParts(headerBuffer, parts)) > 0)
+            {
+                // Payload is passed to the low level comm directly from the packet's memory
+                result = Calls::sendParts(lowLevelComm, parts, partsAmount);
+            }
+            else if ((sendingBuffer = communication.getSendingBuffer(PACKETCOMM_FRAME_HEADROOM + packetSize + PACKETCOMM_FRAME_TAILROOM)).buffer != nullptr)
+            {
+                // Packet is placed between headroom and tailroom,
+                // so low level comm can add its headers and trailers (eg. checksum) without copying.
+                FrameBuffer frame(sendingBuffer.buffer, sendingBuffer.size, PACKETCOMM_FRAME_HEADROOM);
+                packetToSend->getBuffer(frame.pushBack(packetSize));
+                result = Calls::sendFrame(lowLevelComm, frame);
+            }
+            else
+                result = false; // sending buffer could not be allocated
+
+#if PACKETCOMM_LATENCY_TRACING
+            if (communication.latencyTracer != nullptr && result)
+                communication.latencyTracer->commitSend(packetToSend->getID());
+#endif
+
+            if (!result)
+                communication.lastSendStatus = SendStatus::FAILED;
+            else
+                communication.lastSendStatus = Calls::getPendingSendSize(lowLevelComm) > pendingBefore ? SendStatus::QUEUED : SendStatus::SENT;
+            return result;
+        }
+
+        /**
+         * @brief Receive all available frames (in batches), update matching registered
+         * packets and call their callbacks.
+         * @return Percentage of received frames that matched a registered packet
+         * (0 if nothing was received).
+         */
+        template <class Communication, class Transceiver>
+        static uint8_t receiveAndUpdatePackets(Communication& communication, Transceiver* lowLevelComm)
+        {
+            typedef TransceiverCalls<Transceiver> Calls;
+
+            uint16_t receivedPacketsTotal = 0;
+            uint16_t successfullyReceivedPackets = 0;
+
+            DataBuffer batch[PACKETCOMM_RECEIVE_BATCH_SIZE];
+            size_t batchSize;
+
+            while ((batchSize = Calls::receiveBatch(lowLevelComm, batch, PACKETCOMM_RECEIVE_BATCH_SIZE)) > 0)
+            {
+                receivedPacketsTotal += batchSize;
+
+                for (size_t i = 0; i < batchSize; ++i)
+                {
+                    const DataBuffer& receivedBuffer = batch[i];
+
+                    Packet::Header header;
+                    if (!Packet::readHeader(receivedBuffer, header))
+                        continue;
+
+                    Packet* matchingPacket = communication.getRegisteredReceivePacket(header.id);
+                    if (matchingPacket == nullptr || !matchingPacket->isDataValid(receivedBuffer.buffer + header.size, header.dataSize))
+                        continue;
+
+#if PACKETCOMM_LATENCY_TRACING
+                    if (communication.latencyTracer != nullptr)
+                        communication.latencyTracer->commitReceive(matchingPacket->getID(), receivedBuffer);
+#endif
+
+                    Calls::selectBatchFrame(lowLevelComm, i); // eg. replies from callbacks go to the sender of this frame
+                    switch (matchingPacket->getType())
+                    {
+                        case Packet::Type::DATA:
+                            matchingPacket->updatePacketBuffer(receivedBuffer.buffer); // this method returns bool, but should be always true
+                            matchingPacket->executeOnReceiveCallback();
+                            break;
+
+                        case Packet::Type::EVENT:
+                            matchingPacket->executeOnReceiveCallback();
+                            break;
+
+                        // other types...
+                        // TODO: string packet implementation
+
+                        default:
+                            continue; // invalid type
+                    }
+
+                    communication.onPacketReceived(matchingPacket);
+                    successfullyReceivedPackets++;
+                }
+
+#if PACKETCOMM_LATENCY_TRACING
+                if (communication.latencyTracer != nullptr)
+                    communication.latencyTracer->beginReceiveBatch(); // frames that were not dispatched are forgotten
+#endif
+            }
+
+            // Assess receiving
+            if (receivedPacketsTotal != 0)
+                return ((float)successfullyReceivedPackets / receivedPacketsTotal) * 100.f;
+            return 0;
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,230 @@
+/**
+ * @file PacketCommunicationT.h
+ * @author Jan Wielgus
+ * @brief Packet communication templated on the concrete transceiver type.
+ * Transceiver methods are called directly (not through ITransceiver),
+ * so the whole receive -> decode -> dispatch path can be inlined.
+ * @date 2026-10-19
+ */
+
+#ifndef PACKETCOMMUNICATIONT_H
+#define PACKETCOMMUNICATIONT_H
+
+#include "PacketCommConfig.h"
+#include "PacketCommunicationCore.h"
+#include "IConnectionStatus.h"
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "DataBuffer.h"
+#include <Arduino.h>
+#include <EVAFilter.h>
+#include <GrowingArray.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief The same as PacketCommunication, but without virtual calls
+     * to the low level comm. Use PacketCommunication if the transceiver type
+     * is not known at compile time or the communication has to be extended
+     * (PacketCommunicationT has no virtual methods to override).
+     * @tparam Transceiver Concrete (not abstract) transceiver class, eg. StreamComm<64, HardwareSerial>.
+     * Transceiver object has to be exactly of that type (not derived),
+     * because its methods are called non-virtually.
+     */
+    template <class Transceiver>
+    class PacketCommunicationT : public IConnectionStatus
+    {
+        static_assert(!__is_abstract(Transceiver), "Transceiver has to be a concrete class, use PacketCommunication for ITransceiver");
+        friend class PacketCommunicationCore;
+
+        FL::EVAFilter connectionStabilityFilter;
+        Transceiver* const LowLevelComm;
+        SimpleDataStructures::GrowingArray<Packet*> registeredReceivePackets;
+        AutoDataBuffer sendingBuffer;
+        ITransmitter::SendStatus lastSendStatus = ITransmitter::SendStatus::SENT;
+        void (*packetReceivedCallback)(Packet* receivedPacket) = nullptr;
+#if PACKETCOMM_LATENCY_TRACING
+        LatencyTracer* latencyTracer = nullptr;
+#endif
+
+    public:
+        typedef uint8_t Percentage;
+        typedef ITransmitter::SendStatus SendStatus;
+        typedef void (*PacketReceivedCallback)(Packet* receivedPacket);
+
+        /**
+         * @param lowLevelComm pointer to the low level communication instance.
+         */
+        explicit PacketCommunicationT(Transceiver* lowLevelComm);
+
+        PacketCommunicationT(const PacketCommunicationT&) = delete;
+        PacketCommunicationT& operator=(const PacketCommunicationT&) = delete;
+
+        /**
+         * @brief Same as PacketCommunication::registerReceivePacket().
+         */
+        bool registerReceivePacket(Packet* receivePacket);
+
+        Percentage getConnectionStability() override;
+
+        /**
+         * @brief Same as PacketCommunication::adaptConnStabilityToFrequency().
+         */
+        void adaptConnStabilityToFrequency(float frequency_Hz);
+
+        /**
+         * @brief Same as PacketCommunication::setConnStabilitySmoothness().
+         */
+        void setConnStabilitySmoothness(float smoothness);
+
+        /**
+         * @brief Receive all available data and update registered packets
+         * (and call their received callbacks).
+         */
+        void receive();
+
+        /**
+         * @brief Send data packet passed in a parameter.
+         * @param packetToSend Pointer to the data packet that need to be sent.
+         * @return false if data packet was not sent because of any reason.
+         */
+        bool send(const Packet* packetToSend);
+
+        /**
+         * @brief Same as PacketCommunication::poll().
+         */
+        bool poll() { return LowLevelComm->Transceiver::poll(); }
+
+        /**
+         * @brief Same as PacketCommunication::getLastSendStatus().
+         */
+        SendStatus getLastSendStatus() const { return lastSendStatus; }
+
+        /**
+         * @brief Function called after each successfully received packet was updated
+         * and its callback was executed (PacketCommunication::onPacketReceived() without virtual calls).
+         * @param callback Pointer to the function or nullptr to disable it.
+         */
+        void setPacketReceivedCallback(PacketReceivedCallback callback) { packetReceivedCallback = callback; }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer);
+#endif
+
+
+    private:
+        Percentage receiveAndUpdatePackets();
+        Packet* getRegisteredReceivePacket(Packet::PacketIDType packetID, size_t packetSize = -1);
+        DataBuffer getSendingBuffer(size_t size);
+
+        void onPacketReceived(Packet* receivedPacket)
+        {
+            if (packetReceivedCallback != nullptr)
+                packetReceivedCallback(receivedPacket);
+        }
+    };
+
+
+
+    template <class Transceiver>
+    PacketCommunicationT<Transceiver>::PacketCommunicationT(Transceiver* lowLevelComm)
+        : LowLevelComm(lowLevelComm),
+          sendingBuffer(0)
+    {
+    }
+
+
+    template <class Transceiver>
+    bool PacketCommunicationT<Transceiver>::registerReceivePacket(Packet* receivePacket)
+    {
+        if (getRegisteredReceivePacket(receivePacket->getID()) != nullptr)
+            return false;
+
+        return registeredReceivePackets.add(receivePacket);
+    }
+
+
+    template <class Transceiver>
+    typename PacketCommunicationT<Transceiver>::Percentage PacketCommunicationT<Transceiver>::getConnectionStability()
+    {
+        return uint8_t(connectionStabilityFilter.getFilteredValue() + 0.5f);
+    }
+
+
+    template <class Transceiver>
+    void PacketCommunicationT<Transceiver>::adaptConnStabilityToFrequency(float frequency_Hz)
+    {
+        // The same linear function as in PacketCommunication
+        float interval_us = 1000000.f / frequency_Hz;
+        float filterBeta = -7.3e-7 * (float)interval_us + 0.86f;
+        filterBeta = constrain(filterBeta, 0.1f, 0.97f);
+        connectionStabilityFilter.setFilterBeta(filterBeta);
+    }
+
+
+    template <class Transceiver>
+    void PacketCommunicationT<Transceiver>::setConnStabilitySmoothness(float smoothness)
+    {
+        smoothness = constrain(smoothness, 0.0f, 0.995f);
+        connectionStabilityFilter.setFilterBeta(smoothness);
+    }
+
+
+    template <class Transceiver>
+    void PacketCommunicationT<Transceiver>::receive()
+    {
+        Percentage receivingResult = receiveAndUpdatePackets();
+        connectionStabilityFilter.update(receivingResult > 100 ? 100 : receivingResult);
+    }
+
+
+    template <class Transceiver>
+    bool PacketCommunicationT<Transceiver>::send(const Packet* packetToSend)
+    {
+        return PacketCommunicationCore::send(*this, LowLevelComm, packetToSend);
+    }
+
+
+#if PACKETCOMM_LATENCY_TRACING
+    template <class Transceiver>
+    void PacketCommunicationT<Transceiver>::setLatencyTracer(LatencyTracer* tracer)
+    {
+        latencyTracer = tracer;
+        LowLevelComm->Transceiver::setLatencyTracer(tracer);
+    }
+#endif
+
+
+    template <class Transceiver>
+    typename PacketCommunicationT<Transceiver>::Percentage PacketCommunicationT<Transceiver>::receiveAndUpdatePackets()
+    {
+        return PacketCommunicationCore::receiveAndUpdatePackets(*this, LowLevelComm);
+    }
+
+
+    template <class Transceiver>
+    DataBuffer PacketCommunicationT<Transceiver>::getSendingBuffer(size_t size)
+    {
+        if (!sendingBuffer.ensureAllocatedSize(size, false))
+            return DataBuffer();
+        return DataBuffer(sendingBuffer.buffer, sendingBuffer.AllocatedSize);
+    }
+
+
+    template <class Transceiver>
+    Packet* PacketCommunicationT<Transceiver>::getRegisteredReceivePacket(Packet::PacketIDType packetID, size_t packetSize)
+    {
+        for (size_t i = 0; i < registeredReceivePackets.size(); ++i)
+        {
+            Packet* curPacket = registeredReceivePackets[i];
+            if (curPacket->getID() == packetID)
+                return (packetSize == curPacket->getSize() || packetSize == (size_t)-1) ? curPacket : nullptr;
+        }
+
+        return nullptr;
+    }
+}
+
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file PacketRouter.cpp
+ * @author Jan Wielgus
+ * @date 2026-10-19
+ */
+
+#include "PacketRouter.h"
+
+using namespace PacketComm;
+
+
+PacketRouter::PacketRouter(bool useHopLimit)
+    : HopLimit_flag(useHopLimit),
+      IDOffset(useHopLimit ? HopHeaderSize : 0)
+{
+}
+
+
+bool PacketRouter::addInput(ITransceiver* input)
+{
+    for (size_t i = 0; i < inputs.size(); ++i)
+        if (inputs[i] == input)
+            return false;
+
+    return inputs.add(input);
+}
+
+
+bool PacketRouter::addRoute(Packet::PacketIDType firstID, Packet::PacketIDType lastID, ITransmitter* output)
+{
+    if (lastID < firstID || output == nullptr)
+        return false;
+
+    Route newRoute;
+    newRoute.firstID = firstID;
+    newRoute.lastID = lastID;
+    newRoute.output = output;
+    return routes.add(newRoute);
+}
+
+
+size_t PacketRouter::route()
+{
+    DataBuffer batch[PACKETCOMM_RECEIVE_BATCH_SIZE];
+    size_t forwarded = 0;
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        ITransceiver* input = inputs[i];
+        SharedFrame::Encoding framing = input->getReceivedFraming();
+
+        size_t received;
+        while ((received = input->receiveBatch(batch, PACKETCOMM_RECEIVE_BATCH_SIZE)) > 0)
+        {
+            for (size_t j = 0; j < received; ++j)
+                if (forward(input, batch[j], framing))
+                    forwarded++;
+        }
+    }
+
+    return forwarded;
+}
+
+
+bool PacketRouter::forward(ITransceiver* input, DataBuffer frame, SharedFrame::Encoding framing)
+{
+    Packet::Header header;
+    if (frame.size < IDOffset || !Packet::readHeader(DataBuffer(frame.buffer + IDOffset, frame.size - IDOffset), header))
+        return false; // invalid frame
+
+    if (HopLimit_flag)
+    {
+        HopLimitType hopLimit = frame.buffer[0];
+        if (hopLimit == 0)
+        {
+            hopLimitDrops++;
+            return false;
+        }
+
+        frame.buffer[0] = hopLimit - 1;
+
+        // XOR checksum after the frame is updated instead of calculated again
+        if (framing == SharedFrame::Encoding::COBS_XOR_CHECKSUM)
+            frame.buffer[frame.size] ^= hopLimit ^ frame.buffer[0];
+    }
+
+    Packet::PacketIDType packetID = header.id;
+    bool routed = false;
+    bool sent = false;
+
+    for (size_t i = 0; i < routes.size(); ++i)
+    {
+        const Route& current = routes[i];
+        if (packetID < current.firstID || packetID > current.lastID || current.output == input)
+            continue;
+
+        routed = true;
+        if (sendByRoute(current.output, frame, framing))
+            sent = true;
+        else
+            failedSends++;
+    }
+
+    if (!routed)
+        unroutedFrames++;
+    if (sent)
+        forwardedFrames++;
+    return sent;
+}
+
+
+bool PacketRouter::sendByRoute(ITransmitter* output, const DataBuffer& frame, SharedFrame::Encoding framing)
+{
+    if (framing != SharedFrame::Encoding::NONE && output->getFraming() == framing &&
+        output->sendWithTrailer(frame.buffer, frame.size))
+        return true;
+
+    return output->send(frame.buffer, frame.size);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file PacketRouter.h
+ * @author Jan Wielgus
+ * @brief Relay node that forwards received frames to other transceivers
+ * by packet ID, without deserializing packets.
+ * @date 2026-10-19
+ */
+
+#ifndef PACKETROUTER_H
+#define PACKETROUTER_H
+
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "DataBuffer.h"
+#include <GrowingArray.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Frames received by inputs are forwarded as they are (verified raw frame)
+     * to outputs of all routes that contain the packet ID (except the input it came from).
+     * If the input and output have the same framing (eg. two StreamComm),
+     * the verified checksum is reused instead of calculated again
+     * (ITransmitter::sendWithTrailer()).
+     *
+     * With hop limit enabled, each frame starts with the hop limit byte
+     * (amount of routers that can still forward it) before the packet ID.
+     * It is decremented by each router and frames with 0 are not forwarded,
+     * so loops in the mesh cannot circulate frames forever. Endpoints have to
+     * add and remove this byte (see LowLevelImpl/HopLimitComm.h).
+     */
+    class PacketRouter
+    {
+    public:
+        typedef uint8_t HopLimitType;
+        static const size_t HopHeaderSize = sizeof(HopLimitType);
+
+    private:
+        struct Route
+        {
+            Packet::PacketIDType firstID;
+            Packet::PacketIDType lastID;
+            ITransmitter* output;
+        };
+
+        SimpleDataStructures::GrowingArray<ITransceiver*> inputs;
+        SimpleDataStructures::GrowingArray<Route> routes;
+        const bool HopLimit_flag;
+        const size_t IDOffset;
+
+        // statistics
+        uint32_t forwardedFrames = 0;
+        uint32_t unroutedFrames = 0;
+        uint32_t hopLimitDrops = 0;
+        uint32_t failedSends = 0;
+
+    public:
+        /**
+         * @param useHopLimit true if frames start with the hop limit byte.
+         */
+        explicit PacketRouter(bool useHopLimit = false);
+
+        PacketRouter(const PacketRouter&) = delete;
+        PacketRouter& operator=(const PacketRouter&) = delete;
+
+        /**
+         * @brief Add transceiver which received frames will be forwarded.
+         * @return false if input was already added.
+         */
+        bool addInput(ITransceiver* input);
+
+        /**
+         * @brief Forward frames with packet ID from firstID to lastID (inclusive) by output.
+         * Many routes can contain the same ID (frame is sent by all of them).
+         * @return false if lastID is lower than firstID.
+         */
+        bool addRoute(Packet::PacketIDType firstID, Packet::PacketIDType lastID, ITransmitter* output);
+
+        size_t getInputsAmount() const { return inputs.size(); }
+        size_t getRoutesAmount() const { return routes.size(); }
+
+        /**
+         * @brief Receive all available frames from all inputs and forward them.
+         * Call this method regularly (like PacketCommunication::receive()).
+         * @return Amount of frames forwarded by at least one route.
+         */
+        size_t route();
+
+        uint32_t getForwardedFramesAmount() const { return forwardedFrames; }
+        uint32_t getUnroutedFramesAmount() const { return unroutedFrames; }
+        uint32_t getHopLimitDropsAmount() const { return hopLimitDrops; }
+
+        /**
+         * @return Amount of sends that failed (counted for each route).
+         */
+        uint32_t getFailedSendsAmount() const { return failedSends; }
+
+
+    private:
+        bool forward(ITransceiver* input, DataBuffer frame, SharedFrame::Encoding framing);
+        bool sendByRoute(ITransmitter* output, const DataBuffer& frame, SharedFrame::Encoding framing);
+    };
+}
+
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file SharedFrame.cpp
+ * @author Jan Wielgus
+ * @date 2026-10-19
+ */
+
+#include "SharedFrame.h"
+
+using namespace PacketComm;
+
+
+SharedFrame* SharedFrame::create(size_t size, IBufferAllocator* allocator)
+{
+    size_t capacity = PACKETCOMM_FRAME_HEADROOM + size + PACKETCOMM_FRAME_TAILROOM;
+    uint8_t* storage = allocator != nullptr ? allocator->allocate(capacity) : new uint8_t[capacity];
+    if (storage == nullptr)
+        return nullptr;
+
+    SharedFrame* sharedFrame = new SharedFrame(allocator, storage, capacity); // only buffers are taken from the allocator
+    sharedFrame->frame.pushBack(size);
+    return sharedFrame;
+}
+
+
+SharedFrame::SharedFrame(IBufferAllocator* allocator, uint8_t* storage, size_t capacity)
+    : Allocator(allocator),
+      Storage(storage),
+      Capacity(capacity),
+      frame(storage, capacity, PACKETCOMM_FRAME_HEADROOM)
+{
+}
+
+
+SharedFrame::~SharedFrame()
+{
+    if (encoded != nullptr)
+        deallocate(encoded, encodedCapacity);
+    deallocate(Storage, Capacity);
+}
+
+
+void SharedFrame::retain()
+{
+    references++;
+}
+
+
+void SharedFrame::release()
+{
+    if (--references == 0)
+        delete this;
+}
+
+
+DataBuffer SharedFrame::getEncoded(Encoding encoding) const
+{
+    if (this->encoding != encoding || encoded == nullptr || encodedSize == 0)
+        return DataBuffer();
+    return DataBuffer(encoded, encodedSize);
+}
+
+
+uint8_t* SharedFrame::allocateEncoded(Encoding encoding, size_t maxSize)
+{
+    if (maxSize > encodedCapacity)
+    {
+        if (encoded != nullptr)
+            deallocate(encoded, encodedCapacity);
+        encoded = allocate(maxSize);
+        encodedCapacity = encoded != nullptr ? maxSize : 0;
+    }
+
+    this->encoding = encoding;
+    encodedSize = 0;
+    return encoded;
+}
+
+
+void SharedFrame::setEncodedSize(size_t size)
+{
+    encodedSize = size <= encodedCapacity ? size : 0;
+}
+
+
+uint8_t* SharedFrame::allocate(size_t size)
+{
+    return Allocator != nullptr ? Allocator->allocate(size) : new uint8_t[size];
+}
+
+
+void SharedFrame::deallocate(uint8_t* buffer, size_t size)
+{
+    if (Allocator != nullptr)
+        Allocator->deallocate(buffer, size);
+    else
+        delete[] buffer;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file SharedFrame.h
+ * @author Jan Wielgus
+ * @brief Reference counted frame that is sent by many transmitters at once.
+ * @date 2026-10-19
+ */
+
+#ifndef SHAREDFRAME_H
+#define SHAREDFRAME_H
+
+#include "PacketCommConfig.h"
+#include "DataBuffer.h"
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Serialized packet (FrameBuffer with headroom and tailroom) shared
+     * by many transmitters (see PacketBroadcaster). Transmitters that use the same
+     * framing can also share the encoded frame (see getEncoded() and allocateEncoded()).
+     * Frame is deleted (and its buffers returned to the allocator) when the last
+     * reference is released. Not thread-safe.
+     */
+    class SharedFrame
+    {
+    public:
+        /**
+         * @brief Framing of the encoded frame. Transmitters with the same
+         * encoding produce the same bytes from the same frame.
+         */
+        enum class Encoding : uint8_t
+        {
+            NONE,
+            COBS_XOR_CHECKSUM // StreamComm
+        };
+
+    private:
+        IBufferAllocator* const Allocator;
+        uint8_t* const Storage;
+        const size_t Capacity;
+        FrameBuffer frame;
+        uint16_t references = 1;
+
+        Encoding encoding = Encoding::NONE;
+        uint8_t* encoded = nullptr;
+        size_t encodedSize = 0;
+        size_t encodedCapacity = 0;
+
+    public:
+        /**
+         * @brief Creates the frame of size bytes (with PACKETCOMM_FRAME_HEADROOM
+         * and PACKETCOMM_FRAME_TAILROOM) that has one reference.
+         * @param size Size of the frame (eg. size of the packet).
+         * @param allocator Allocator of the frame storage and the encoded frame buffer
+         * (new[] is used if nullptr). The SharedFrame object itself is always allocated by new.
+         * @return Pointer to the new frame or nullptr if the storage could not be allocated.
+         */
+        static SharedFrame* create(size_t size, IBufferAllocator* allocator = nullptr);
+
+        SharedFrame(const SharedFrame&) = delete;
+        SharedFrame& operator=(const SharedFrame&) = delete;
+
+        /**
+         * @brief Add reference (eg. when the frame is queued to be sent later).
+         */
+        void retain();
+
+        /**
+         * @brief Remove reference. Frame is deleted after the last one.
+         */
+        void release();
+
+        uint16_t getReferencesAmount() const { return references; }
+
+        /**
+         * @return Frame that can be modified by the transmitter (it has to be restored before returning).
+         */
+        FrameBuffer& getFrame() { return frame; }
+
+        DataBuffer getData() const { return frame.toDataBuffer(); }
+
+        /**
+         * @return Frame encoded by another transmitter or empty buffer if it was not encoded
+         * with this encoding.
+         */
+        DataBuffer getEncoded(Encoding encoding) const;
+
+        /**
+         * @brief Allocate buffer for the encoded frame (replaces the previous one).
+         * Set its size by setEncodedSize() after encoding.
+         * @param encoding Encoding of the frame that will be placed in the buffer.
+         * @param maxSize Max size of the encoded frame.
+         * @return Buffer of maxSize bytes or nullptr if memory could not be allocated.
+         */
+        uint8_t* allocateEncoded(Encoding encoding, size_t maxSize);
+
+        /**
+         * @param size Amount of bytes written to the buffer returned by allocateEncoded().
+         */
+        void setEncodedSize(size_t size);
+
+
+    private:
+        SharedFrame(IBufferAllocator* allocator, uint8_t* storage, size_t capacity);
+        ~SharedFrame();
+
+        uint8_t* allocate(size_t size);
+        void deallocate(uint8_t* buffer, size_t size);
+    };
+}
+
+
+#endif
@@ -0,0 +1,248 @@
+/**
+ * @file StaticPacketCommunication.h
+ * @author Jan Wielgus
+ * @brief Packet communication without any dynamic memory allocation.
+ * Capacity (amount of registered packets and max packet size) is set
+ * at compile time, so RAM usage is known after compilation.
+ * @date 2026-10-19
+ */
+
+#ifndef STATICPACKETCOMMUNICATION_H
+#define STATICPACKETCOMMUNICATION_H
+
+#include "PacketCommConfig.h"
+#include "PacketCommunicationCore.h"
+#include "IConnectionStatus.h"
+#include "ITransceiver.h"
+#include "Packet.h"
+#include "DataBuffer.h"
+#include <Arduino.h>
+#include <EVAFilter.h>
+
+
+namespace PacketComm
+{
+    /**
+     * @brief Heap-free alternative of PacketCommunicationT. Registered packets
+     * and the sending buffer are fixed size arrays.
+     * Transceiver methods are called non-virtually (see PacketCommunicationT).
+     * @tparam Transceiver Concrete transceiver class that defines MaxFrameSize
+     * (eg. StreamComm<64, HardwareSerial>).
+     * @tparam MaxRegisteredPackets Max amount of registered receive packets.
+     * @tparam MaxPacketSize Max size of sent and received packets (including the header).
+     * Has to fit the Transceiver::MaxFrameSize (checked at compile time).
+     */
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    class StaticPacketCommunication : public IConnectionStatus
+    {
+        static_assert(!__is_abstract(Transceiver), "Transceiver has to be a concrete class");
+        static_assert(MaxRegisteredPackets > 0, "At least one packet has to be registered");
+        static_assert(MaxPacketSize > Packet::MinHeaderSize, "Packet has to contain its header and some data");
+        static_assert(MaxPacketSize <= Transceiver::MaxFrameSize, "MaxPacketSize doesn't fit the transceiver MaxBufferSize");
+        friend class PacketCommunicationCore;
+
+        FL::EVAFilter connectionStabilityFilter;
+        Transceiver* const LowLevelComm;
+        Packet* registeredReceivePackets[MaxRegisteredPackets];
+        size_t registeredReceivePacketsAmount = 0;
+        uint8_t sendingBuffer[PACKETCOMM_FRAME_HEADROOM + MaxPacketSize + PACKETCOMM_FRAME_TAILROOM];
+        ITransmitter::SendStatus lastSendStatus = ITransmitter::SendStatus::SENT;
+        void (*packetReceivedCallback)(Packet* receivedPacket) = nullptr;
+#if PACKETCOMM_LATENCY_TRACING
+        LatencyTracer* latencyTracer = nullptr;
+#endif
+
+    public:
+        typedef uint8_t Percentage;
+        typedef ITransmitter::SendStatus SendStatus;
+        typedef void (*PacketReceivedCallback)(Packet* receivedPacket);
+
+        /**
+         * @param lowLevelComm pointer to the low level communication instance.
+         */
+        explicit StaticPacketCommunication(Transceiver* lowLevelComm);
+
+        StaticPacketCommunication(const StaticPacketCommunication&) = delete;
+        StaticPacketCommunication& operator=(const StaticPacketCommunication&) = delete;
+
+        /**
+         * @brief Adds pointer to the packet that may be received during communication.
+         * @return false if there is already MaxRegisteredPackets registered packets,
+         * packet is bigger than MaxPacketSize or packet with the same ID was already registered.
+         */
+        bool registerReceivePacket(Packet* receivePacket);
+
+        /**
+         * @return Amount of packets that can be still registered.
+         */
+        size_t getFreeRegistrationSlots() const
+        {
+            return MaxRegisteredPackets - registeredReceivePacketsAmount;
+        }
+
+        Percentage getConnectionStability() override;
+
+        /**
+         * @brief Same as PacketCommunication::adaptConnStabilityToFrequency().
+         */
+        void adaptConnStabilityToFrequency(float frequency_Hz);
+
+        /**
+         * @brief Same as PacketCommunication::setConnStabilitySmoothness().
+         */
+        void setConnStabilitySmoothness(float smoothness);
+
+        /**
+         * @brief Receive all available data and update registered packets
+         * (and call their received callbacks).
+         */
+        void receive();
+
+        /**
+         * @brief Send data packet passed in a parameter.
+         * @param packetToSend Pointer to the data packet that need to be sent.
+         * @return false if packet is bigger than MaxPacketSize or was not sent by the transceiver.
+         */
+        bool send(const Packet* packetToSend);
+
+        /**
+         * @brief Same as PacketCommunication::poll().
+         */
+        bool poll() { return LowLevelComm->Transceiver::poll(); }
+
+        /**
+         * @brief Same as PacketCommunication::getLastSendStatus().
+         */
+        SendStatus getLastSendStatus() const { return lastSendStatus; }
+
+        /**
+         * @brief Same as PacketCommunicationT::setPacketReceivedCallback().
+         */
+        void setPacketReceivedCallback(PacketReceivedCallback callback) { packetReceivedCallback = callback; }
+
+#if PACKETCOMM_LATENCY_TRACING
+        void setLatencyTracer(LatencyTracer* tracer);
+#endif
+
+
+    private:
+        Percentage receiveAndUpdatePackets();
+        Packet* getRegisteredReceivePacket(Packet::PacketIDType packetID, size_t packetSize = -1);
+
+        DataBuffer getSendingBuffer(size_t size)
+        {
+            return size <= sizeof(sendingBuffer) ? DataBuffer(sendingBuffer, sizeof(sendingBuffer)) : DataBuffer();
+        }
+
+        void onPacketReceived(Packet* receivedPacket)
+        {
+            if (packetReceivedCallback != nullptr)
+                packetReceivedCallback(receivedPacket);
+        }
+    };
+
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::StaticPacketCommunication(Transceiver* lowLevelComm)
+        : LowLevelComm(lowLevelComm)
+    {
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    bool StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::registerReceivePacket(Packet* receivePacket)
+    {
+        if (registeredReceivePacketsAmount >= MaxRegisteredPackets || receivePacket->getSize() > MaxPacketSize)
+            return false;
+
+        if (getRegisteredReceivePacket(receivePacket->getID()) != nullptr)
+            return false;
+
+        registeredReceivePackets[registeredReceivePacketsAmount++] = receivePacket;
+        return true;
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    typename StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::Percentage
+        StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::getConnectionStability()
+    {
+        return uint8_t(connectionStabilityFilter.getFilteredValue() + 0.5f);
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    void StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::adaptConnStabilityToFrequency(float frequency_Hz)
+    {
+        // The same linear function as in PacketCommunication
+        float interval_us = 1000000.f / frequency_Hz;
+        float filterBeta = -7.3e-7 * (float)interval_us + 0.86f;
+        filterBeta = constrain(filterBeta, 0.1f, 0.97f);
+        connectionStabilityFilter.setFilterBeta(filterBeta);
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    void StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::setConnStabilitySmoothness(float smoothness)
+    {
+        smoothness = constrain(smoothness, 0.0f, 0.995f);
+        connectionStabilityFilter.setFilterBeta(smoothness);
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    void StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::receive()
+    {
+        Percentage receivingResult = receiveAndUpdatePackets();
+        connectionStabilityFilter.update(receivingResult > 100 ? 100 : receivingResult);
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    bool StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::send(const Packet* packetToSend)
+    {
+        if (packetToSend->getSize() > MaxPacketSize)
+        {
+            lastSendStatus = SendStatus::FAILED;
+            return false;
+        }
+
+        return PacketCommunicationCore::send(*this, LowLevelComm, packetToSend);
+    }
+
+
+#if PACKETCOMM_LATENCY_TRACING
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    void StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::setLatencyTracer(LatencyTracer* tracer)
+    {
+        latencyTracer = tracer;
+        LowLevelComm->Transceiver::setLatencyTracer(tracer);
+    }
+#endif
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    typename StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::Percentage
+        StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::receiveAndUpdatePackets()
+    {
+        return PacketCommunicationCore::receiveAndUpdatePackets(*this, LowLevelComm);
+    }
+
+
+    template <class Transceiver, const size_t MaxRegisteredPackets, const size_t MaxPacketSize>
+    Packet* StaticPacketCommunication<Transceiver, MaxRegisteredPackets, MaxPacketSize>::getRegisteredReceivePacket(Packet::PacketIDType packetID, size_t packetSize)
+    {
+        for (size_t i = 0; i < registeredReceivePacketsAmount; ++i)
+        {
+            Packet* curPacket = registeredReceivePackets[i];
+            if (curPacket->getID() == packetID)
+                return (packetSize == curPacket->getSize() || packetSize == (size_t)-1) ? curPacket : nullptr;
+        }
+
+        return nullptr;
+    }
+}
+
+
+#endif
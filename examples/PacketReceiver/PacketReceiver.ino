@@ -8,16 +8,15 @@
  * @date 2020-11-03
  */
 
-#include <DataPacket.h>
 #include <StreamComm.h>
 #include <PacketCommunication.h>
 #include <SoftwareSerial.h>
 #include <SimpleTasker.h>
-#include <byteType.h>
+#include "TestPackets.h" // generated from TestPackets.packets
 
 using namespace PacketComm;
 
-const uint16_t MaxBufferSize = 20;
+const uint16_t MaxBufferSize = 20; // max frame size (packet header + data), StreamComm buffers take ~3 * MaxBufferSize B of RAM
 const float commReceivingFrequency = 1.f;
 
 void dataReceivedCallback();
@@ -37,36 +36,16 @@ SimpleTasker tasker(5);
 
 
 /**
- * Packet in sender code have to be constructed in the same way
- * (important parts are: order in which variables are added to this packet
- * using addVar() method and packet ID).
+ * Packet class is generated from TestPackets.packets (sender code has to use
+ * the same schema, check it by TestPacket::SchemaHash).
  * You can create many data packets. Remember that they have to have different ID!
  * This packet ID is 51.
- * 
- * After ID there is optional parameter where you can set void function
- * that will be called each time this packet will be received
- * (this is useless if packet is only sent).
- * At the end one instance of this class (packet) is created.
+ *
+ * Constructor parameter is void function that will be called
+ * each time this packet will be received.
  */
-class TestPacket : public DataPacket
-{
-public:
-    uint32Byte var1;
-    uint8Byte var2;
-    int16Byte var3;
-    floatByte var4;
-
-    uint16_t counter = 0; // used in received event
-
-    TestPacket()
-        : DataPacket(51, dataReceivedCallback)
-    {
-        addVar(var1);
-        addVar(var2);
-        addVar(var3);
-        addVar(var4);
-    }
-} testPacket;
+TestPacket testPacket(dataReceivedCallback);
+uint16_t receivedCounter = 0; // used in received event
 
 
 /**
@@ -105,7 +84,7 @@ void loop()
 
 void dataReceivedCallback() 
 {
-    Serial.print(testPacket.counter++);
+    Serial.print(receivedCounter++);
     Serial.print(" Data: ");
     Serial.print("\t1: ");
     Serial.print(testPacket.var1);
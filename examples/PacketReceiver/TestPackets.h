@@ -0,0 +1,71 @@
+/**
+ * @file TestPackets.h
+ * @brief Packets generated from TestPackets.packets by extras/codegen/packetgen.py.
+ * Do not edit, change the schema and generate this file again.
+ */
+
+#ifndef TESTPACKETS_H
+#define TESTPACKETS_H
+
+#include "Packet.h"
+#include "Encoding/LittleEndian.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+static_assert(PACKETCOMM_HEADER_ID_SIZE == 2, "Packets were generated for another PACKETCOMM_HEADER_ID_SIZE (see --id-size)");
+
+
+/**
+ * @brief Hash of IDs and layouts of all packets (both sides should have the same).
+ */
+const uint32_t TestPacketsSchemaHash = 0x58EC3B7Ful;
+
+
+/**
+ * @brief Packet 51 (11 bytes of data).
+ */
+class TestPacket : public PacketComm::Packet
+{
+public:
+    enum : PacketIDType { ID = 51 };
+    enum : size_t { DataSize = 11 };
+    enum : uint32_t { SchemaHash = 0x2339C1DEul };
+
+    uint32_t var1 = 0;
+    uint8_t var2 = 0;
+    int16_t var3 = 0;
+    float var4 = 0;
+
+    explicit TestPacket(Callback onReceiveCallback = nullptr)
+        : Packet(ID, Type::DATA, onReceiveCallback)
+    {
+    }
+
+
+protected:
+    size_t getDataOnly(uint8_t* outputBuffer) const override
+    {
+        PacketComm::LittleEndian::writeUInt32(outputBuffer + 0, var1);
+        PacketComm::LittleEndian::writeUInt8(outputBuffer + 4, var2);
+        PacketComm::LittleEndian::writeInt16(outputBuffer + 5, var3);
+        PacketComm::LittleEndian::writeFloat(outputBuffer + 7, var4);
+        return DataSize;
+    }
+
+    size_t getDataOnlySize() const override
+    {
+        return DataSize;
+    }
+
+    void updateDataOnly(const uint8_t* inputBuffer) override
+    {
+        var1 = PacketComm::LittleEndian::readUInt32(inputBuffer + 0);
+        var2 = PacketComm::LittleEndian::readUInt8(inputBuffer + 4);
+        var3 = PacketComm::LittleEndian::readInt16(inputBuffer + 5);
+        var4 = PacketComm::LittleEndian::readFloat(inputBuffer + 7);
+    }
+};
+
+
+#endif
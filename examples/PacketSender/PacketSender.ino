@@ -6,16 +6,15 @@
  * @date 2021-07-27
  */
 
-#include <DataPacket.h>
 #include <StreamComm.h>
 #include <PacketCommunication.h>
 #include <SoftwareSerial.h>
 #include <SimpleTasker.h>
-#include <byteType.h>
+#include "TestPackets.h" // generated from TestPackets.packets
 
 using namespace PacketComm;
 
-const uint16_t MaxBufferSize = 20;
+const uint16_t MaxBufferSize = 20; // max frame size (packet header + data), StreamComm buffers take ~3 * MaxBufferSize B of RAM
 const float commSendingFrequency = 1.f;
 
 
@@ -33,34 +32,18 @@ SimpleTasker tasker(5);
 
 
 /**
- * Packet in receiver code have to be constructed in the same way
- * (important parts are: order in which variables are added to this packet
- * using addVar() method and packet ID).
+ * Packet class is generated from TestPackets.packets (receiver code has to use
+ * the same schema, check it by TestPacket::SchemaHash). Fields are serialized
+ * in little-endian at fixed offsets, so devices with different architectures
+ * (eg. AVR and ESP) agree on the layout.
  * You can create many data packets. Remember that they have to have different ID!
  * This packet ID is 51.
- * 
- * After ID there is optional parameter where you can set void function
+ *
+ * Constructor has optional parameter where you can set void function
  * that will be called each time this packet will be received
  * (this is skipped here because it is useless if packet is only sent).
- * At the end one instance of this class (packet) is created.
  */
-class TestPacket : public DataPacket
-{
-public:
-    uint32Byte var1 = 1; // Some initial values
-    uint8Byte var2 = 2;
-    int16Byte var3 = -1234;
-    floatByte var4 = -5.f;
-
-    TestPacket()
-        : DataPacket(51)
-    {
-        addVar(var1);
-        addVar(var2);
-        addVar(var3);
-        addVar(var4);
-    }
-} testPacket;
+TestPacket testPacket;
 
 
 /**
@@ -76,7 +59,7 @@ class : public Task
         testPacket.var3 = 123;
         testPacket.var4 = testPacket.var4 + 2.5f;
 
-        // Sent are all variables added at the beginning to this data packet using addVar() method.
+        // Sent are all fields of this data packet (from the schema).
         comm.send(&testPacket);
     }
 } sendDataTask;
@@ -90,6 +73,12 @@ void setup()
 
     Serial.println("Program has just started!");
 
+    // Some initial values
+    testPacket.var1 = 1;
+    testPacket.var2 = 2;
+    testPacket.var3 = -1234;
+    testPacket.var4 = -5.f;
+
     tasker.addTask(&sendDataTask, commSendingFrequency); // 1Hz sending tasker
 }
 
@@ -0,0 +1,99 @@
+/**
+ * @file PingPackets.h
+ * @brief Packets generated from PingPackets.packets by extras/codegen/packetgen.py.
+ * Do not edit, change the schema and generate this file again.
+ */
+
+#ifndef PINGPACKETS_H
+#define PINGPACKETS_H
+
+#include "Packet.h"
+#include "Encoding/LittleEndian.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+static_assert(PACKETCOMM_HEADER_ID_SIZE == 2, "Packets were generated for another PACKETCOMM_HEADER_ID_SIZE (see --id-size)");
+
+
+/**
+ * @brief Hash of IDs and layouts of all packets (both sides should have the same).
+ */
+const uint32_t PingPacketsSchemaHash = 0xC5101198ul;
+
+
+/**
+ * @brief Packet 0 (4 bytes of data).
+ */
+class PingRequestPacket : public PacketComm::Packet
+{
+public:
+    enum : PacketIDType { ID = 0 };
+    enum : size_t { DataSize = 4 };
+    enum : uint32_t { SchemaHash = 0xDDCD49A4ul };
+
+    uint32_t pingRequestCounter = 0;
+
+    explicit PingRequestPacket(Callback onReceiveCallback = nullptr)
+        : Packet(ID, Type::DATA, onReceiveCallback)
+    {
+    }
+
+
+protected:
+    size_t getDataOnly(uint8_t* outputBuffer) const override
+    {
+        PacketComm::LittleEndian::writeUInt32(outputBuffer + 0, pingRequestCounter);
+        return DataSize;
+    }
+
+    size_t getDataOnlySize() const override
+    {
+        return DataSize;
+    }
+
+    void updateDataOnly(const uint8_t* inputBuffer) override
+    {
+        pingRequestCounter = PacketComm::LittleEndian::readUInt32(inputBuffer + 0);
+    }
+};
+
+
+/**
+ * @brief Packet 1 (4 bytes of data).
+ */
+class PingReplyPacket : public PacketComm::Packet
+{
+public:
+    enum : PacketIDType { ID = 1 };
+    enum : size_t { DataSize = 4 };
+    enum : uint32_t { SchemaHash = 0x9E9C994Bul };
+
+    uint32_t pingReplyCounter = 0;
+
+    explicit PingReplyPacket(Callback onReceiveCallback = nullptr)
+        : Packet(ID, Type::DATA, onReceiveCallback)
+    {
+    }
+
+
+protected:
+    size_t getDataOnly(uint8_t* outputBuffer) const override
+    {
+        PacketComm::LittleEndian::writeUInt32(outputBuffer + 0, pingReplyCounter);
+        return DataSize;
+    }
+
+    size_t getDataOnlySize() const override
+    {
+        return DataSize;
+    }
+
+    void updateDataOnly(const uint8_t* inputBuffer) override
+    {
+        pingReplyCounter = PacketComm::LittleEndian::readUInt32(inputBuffer + 0);
+    }
+};
+
+
+#endif
@@ -6,15 +6,14 @@
  * @date 2021-06-11
  */
 
-#include <DataPacket.h>
 #include <StreamComm.h>
 #include <PacketCommunication.h>
 #include <SoftwareSerial.h>
-#include <byteType.h>
+#include "PingPackets.h" // generated from PingPackets.packets
 
 using namespace PacketComm;
 
-const uint16_t MaxBufferSize = 20;
+const uint16_t MaxBufferSize = 20; // max frame size (packet header + data), StreamComm buffers take ~3 * MaxBufferSize B of RAM
 const float PingInterval_s = 2;
 
 uint32_t pingRequestTime_us;
@@ -30,30 +29,8 @@ StreamComm<MaxBufferSize> streamComm(&softSerial);
 PacketCommunication comm(&streamComm);
 
 
-class PingRequestPacket : public DataPacket
-{
-public:
-    uint32Byte pingRequestCounter = 0;
-
-    PingRequestPacket()
-        : DataPacket(0, pingRequestReceivedCallback)
-    {
-        addVar(pingRequestCounter);
-    }
-} pingRequestPacket;
-
-
-class PingReplyPacket : public DataPacket
-{
-public:
-    uint32Byte pingReplyCounter;
-
-    PingReplyPacket()
-        : DataPacket(1, pingReplyReceivedCallback)
-    {
-        addVar(pingReplyCounter);
-    }
-} pingReplyPacket;
+PingRequestPacket pingRequestPacket(pingRequestReceivedCallback);
+PingReplyPacket pingReplyPacket(pingReplyReceivedCallback);
 
 
 
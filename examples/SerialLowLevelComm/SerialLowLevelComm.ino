@@ -19,7 +19,7 @@ void send();
 void receive();
 
 // Config
-const uint16_t MaxBufferSize = 25;
+const uint16_t MaxBufferSize = 25; // max frame size (packet header + data), StreamComm buffers take ~3 * MaxBufferSize B of RAM
 
 // Used variables and other
 uint8_t toSendBuffer[2];
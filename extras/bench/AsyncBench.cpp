@@ -0,0 +1,122 @@
+/**
+ * @file AsyncBench.cpp
+ * @author Jan Wielgus
+ * @brief Coroutine API: thousands of concurrent request/response conversations
+ * (each awaits its own packet) driven by a single poll loop.
+ * Compiled as C++20 (other benchmarks are C++17).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "AsyncPacketCommunication.h"
+#include "LoopbackComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    /**
+     * @brief Passes LoopbackComm endpoint through (frames are sent without any framing).
+     */
+    class DirectLowLevel : public ITransceiver
+    {
+        ITransceiver* endpoint;
+
+    public:
+        explicit DirectLowLevel(ITransceiver* endpoint)
+            : endpoint(endpoint)
+        {
+        }
+
+        bool send(const uint8_t* buffer, size_t size) override { return endpoint->send(buffer, size); }
+        bool receive() override { return endpoint->receive(); }
+        const DataBuffer getReceived() override { return endpoint->getReceived(); }
+        size_t receiveBatch(DataBuffer* out, size_t max) override { return endpoint->receiveBatch(out, max); }
+    };
+
+
+    /**
+     * @brief Conversations on the A side, the B side echoes every frame.
+     */
+    struct AsyncConversations
+    {
+        LoopbackLink link;
+        DirectLowLevel lowLevel;
+        AsyncPacketCommunication comm;
+        std::vector<std::vector<uint8_t>> payloads;
+        std::vector<std::unique_ptr<DataPacket>> packets;
+        std::vector<AsyncTask<>> conversations;
+        size_t finishedExchanges = 0;
+
+        AsyncConversations(size_t conversationsAmount, size_t payloadSize)
+            : link(LinkImpairments()),
+              lowLevel(&link.getEndpointA()),
+              comm(&lowLevel)
+        {
+            for (size_t i = 0; i < conversationsAmount; ++i)
+            {
+                payloads.push_back(makePayload(payloadSize, (uint8_t)i));
+                packets.emplace_back(new DataPacket((Packet::PacketIDType)(100 + i), payloads.back().data(), payloadSize));
+                comm.registerReceivePacket(packets.back().get());
+            }
+
+            for (size_t i = 0; i < conversationsAmount; ++i)
+                conversations.push_back(converse(packets[i].get()));
+        }
+
+        ~AsyncConversations()
+        {
+            for (AsyncTask<>& conversation : conversations)
+                conversation.cancel();
+        }
+
+        AsyncTask<> converse(DataPacket* packet)
+        {
+            while (true)
+            {
+                bool sent = co_await comm.sendAsync(packet);
+                bool received = sent && co_await comm.next(packet, 100000);
+                if (received)
+                    finishedExchanges++;
+            }
+        }
+
+        /**
+         * @return Amount of finished request/response exchanges.
+         */
+        size_t run()
+        {
+            size_t before = finishedExchanges;
+
+            LoopbackComm& echo = link.getEndpointB();
+            while (echo.receive())
+            {
+                DataBuffer received = echo.getReceived();
+                echo.send(received.buffer, received.size);
+            }
+
+            comm.poll(); // resumes all conversations, they send next requests
+            return finishedExchanges - before;
+        }
+    };
+}
+
+
+void Bench::registerAsyncBenchmarks(Suite& suite)
+{
+    const size_t ConversationsAmounts[] = { 1, 100, 1000 };
+    const size_t PayloadSize = 16;
+
+    for (size_t amount : ConversationsAmounts)
+    {
+        auto fixture = std::make_shared<AsyncConversations>(amount, PayloadSize);
+        suite.addCounted("async_conversations/" + std::to_string(amount), PayloadSize, [=]() {
+            return fixture->run();
+        });
+    }
+}
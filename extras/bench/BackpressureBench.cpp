@@ -0,0 +1,105 @@
+/**
+ * @file BackpressureBench.cpp
+ * @author Jan Wielgus
+ * @brief Control loop (send one packet and receive) over a slow stream with
+ * a small output buffer (like HardwareSerial): blocking StreamComm waits in each
+ * send(), non-blocking StreamComm queues frames and continues them from poll().
+ * Loop cases report the time of one iteration, goodput cases delivered packets.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "LoopbackComm.h"
+#include "StreamComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 300;
+    const size_t SendQueueSize = 1024;
+    const Packet::PacketIDType TelemetryID = 60;
+
+    size_t receivedPackets = 0;
+
+    void onPacketReceived()
+    {
+        receivedPackets++;
+    }
+
+
+    template <class SenderComm>
+    struct LoopFixture
+    {
+        LoopbackStreamPair link;
+        SenderComm senderStream;
+        StreamComm<MaxBufferSize, LoopbackStream> receiverStream;
+        PacketCommunication sender;
+        PacketCommunication receiver;
+        std::vector<uint8_t> sendPayload;
+        std::vector<uint8_t> receivePayload;
+        DataPacket sendPacket;
+        DataPacket receivePacket;
+
+        LoopFixture(const LinkImpairments& impairments, size_t payloadSize)
+            : link(impairments),
+              senderStream(&link.getEndpointA()),
+              receiverStream(&link.getEndpointB()),
+              sender(&senderStream),
+              receiver(&receiverStream),
+              sendPayload(makePayload(payloadSize, 21)),
+              receivePayload(payloadSize),
+              sendPacket(TelemetryID, sendPayload.data(), sendPayload.size()),
+              receivePacket(TelemetryID, receivePayload.data(), receivePayload.size(), onPacketReceived)
+        {
+            receiver.registerReceivePacket(&receivePacket);
+        }
+
+        size_t runIteration()
+        {
+            receivedPackets = 0;
+            sender.send(&sendPacket); // WOULD_BLOCK is skipped, next iteration sends newer data
+            sender.poll();
+            receiver.receive();
+            return receivedPackets;
+        }
+    };
+
+
+    template <class SenderComm>
+    void addLoopBenchmarks(Suite& suite, const std::string& mode, const LinkImpairments& impairments, size_t payloadSize)
+    {
+        auto loop = std::make_shared<LoopFixture<SenderComm>>(impairments, payloadSize);
+        auto goodput = std::make_shared<LoopFixture<SenderComm>>(impairments, payloadSize);
+        std::string suffix = "/" + std::to_string(payloadSize) + "B_" + std::to_string(impairments.bandwidth_Bps / 1000)
+            + "kBps_" + std::to_string(impairments.txBufferSize) + "B_tx_buffer";
+
+        suite.add("backpressure_loop_" + mode + suffix, 1, 0, [=]() {
+            doNotOptimize(loop->runIteration());
+        });
+        suite.addCounted("backpressure_goodput_" + mode + suffix, payloadSize, [=]() {
+            return goodput->runIteration();
+        });
+    }
+}
+
+
+void Bench::registerBackpressureBenchmarks(Suite& suite)
+{
+    LinkImpairments impairments;
+    impairments.bandwidth_Bps = 1000000;
+    impairments.txBufferSize = 64; // default HardwareSerial TX buffer on AVR
+
+    const size_t PayloadSizes[] = { 32, 200 };
+    for (size_t payloadSize : PayloadSizes)
+    {
+        addLoopBenchmarks<StreamComm<MaxBufferSize, LoopbackStream>>(suite, "blocking", impairments, payloadSize);
+        addLoopBenchmarks<StreamComm<MaxBufferSize, LoopbackStream, SendQueueSize>>(suite, "nonblocking", impairments, payloadSize);
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file BenchData.h
+ * @author Jan Wielgus
+ * @brief Deterministic payloads used by benchmarks.
+ * @date 2026-10-19
+ */
+
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include "DataPacket.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+
+namespace Bench
+{
+    /**
+     * @brief Generate pseudo-random payload that looks like telemetry:
+     * mostly random bytes with some zeros and repeated values.
+     * @param size Size of the payload in bytes.
+     * @param seed Seed of the generator (the same seed - the same payload).
+     */
+    inline std::vector<uint8_t> makePayload(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> payload(size);
+        uint32_t state = seed * 2654435761u + 1;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            uint8_t value = (uint8_t)state;
+            if ((state >> 8) % 8 == 0)
+                value = 0;
+            payload[i] = value;
+        }
+
+        return payload;
+    }
+
+
+    /**
+     * @brief Serialized packet with payload from makePayload() (with the configured header).
+     */
+    inline std::vector<uint8_t> makeFrame(PacketComm::Packet::PacketIDType packetID, size_t payloadSize, uint32_t seed)
+    {
+        std::vector<uint8_t> payload = makePayload(payloadSize, seed);
+        PacketComm::DataPacket packet(packetID, payload.data(), payloadSize);
+        std::vector<uint8_t> frame(packet.getSize());
+        packet.getBuffer(frame.data());
+        return frame;
+    }
+}
+
+
+#endif
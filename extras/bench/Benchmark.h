@@ -0,0 +1,145 @@
+/**
+ * @file Benchmark.h
+ * @author Jan Wielgus
+ * @brief Tiny microbenchmark harness for the host build.
+ * Each case runs a body that processes a known amount of frames,
+ * iterations are calibrated to the minimum measurement time
+ * and results are reported as ns/frame and frames/s.
+ * @date 2026-10-19
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+
+namespace Bench
+{
+    /**
+     * @brief Prevents compiler from removing computation of the value.
+     */
+    template <class T>
+    inline void doNotOptimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Prevents compiler from caching memory contents across this point.
+     */
+    inline void clobberMemory()
+    {
+        asm volatile("" : : : "memory");
+    }
+
+
+    /**
+     * @brief Time stamp counter (reference cycles, constant rate on modern x86).
+     * @return 0 on architectures without accessible cycle counter.
+     */
+    inline uint64_t readCycleCounter()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+
+    struct Case
+    {
+        std::string name;
+        size_t bytesPerFrame; // 0 if throughput in bytes is not meaningful
+        std::function<size_t()> body; // returns amount of processed frames
+    };
+
+
+    struct Result
+    {
+        std::string name;
+        double nsPerFrame;
+        double cyclesPerFrame; // 0 if cycle counter is not available
+        double framesPerSecond;
+        double megabytesPerSecond; // 0 if bytesPerFrame is 0
+    };
+
+
+    class Suite
+    {
+        std::vector<Case> cases;
+
+    public:
+        /**
+         * @brief Add new benchmark case.
+         * @param name Unique name (used also for filtering).
+         * @param framesPerCall Amount of frames processed by one body call.
+         * @param bytesPerFrame Payload bytes of one frame (0 to skip MB/s).
+         * @param body Measured function.
+         */
+        void add(std::string name, size_t framesPerCall, size_t bytesPerFrame, std::function<void()> body)
+        {
+            cases.push_back(Case{ std::move(name), bytesPerFrame, [framesPerCall, body]() {
+                body();
+                return framesPerCall;
+            } });
+        }
+
+        /**
+         * @brief Add new benchmark case which body returns amount of frames
+         * that were really processed (eg. delivered through a lossy link).
+         * Results are then reported as goodput.
+         */
+        void addCounted(std::string name, size_t bytesPerFrame, std::function<size_t()> body)
+        {
+            cases.push_back(Case{ std::move(name), bytesPerFrame, std::move(body) });
+        }
+
+        /**
+         * @brief Run all cases whose name contains filter and print results.
+         * @param filter Substring of the case name (empty - all cases).
+         * @param minTime_s Minimum measurement time of one case.
+         * @return Results of all executed cases.
+         */
+        std::vector<Result> run(const std::string& filter, double minTime_s) const;
+
+        /**
+         * @brief Print single result line in the common format.
+         */
+        static void printResult(const Result& result);
+    };
+
+
+    void registerCodecBenchmarks(Suite& suite);
+    void registerPacketBenchmarks(Suite& suite);
+    void registerRoundTripBenchmarks(Suite& suite);
+    void registerImpairedLinkBenchmarks(Suite& suite);
+    void registerSerialBenchmarks(Suite& suite);
+    void registerUDPBenchmarks(Suite& suite);
+    void registerSharedMemoryBenchmarks(Suite& suite);
+    void registerEventLoopBenchmarks(Suite& suite);
+    void registerGatewayBenchmarks(Suite& suite);
+    void registerConcurrentBenchmarks(Suite& suite);
+    void registerDevirtualizedBenchmarks(Suite& suite);
+    void registerBufferBenchmarks(Suite& suite);
+    void registerSendPartsBenchmarks(Suite& suite);
+    void registerBroadcastBenchmarks(Suite& suite);
+    void registerBondingBenchmarks(Suite& suite);
+    void registerRouterBenchmarks(Suite& suite);
+    void registerReplayBenchmarks(Suite& suite);
+    void registerCompressionBenchmarks(Suite& suite);
+    void registerBackpressureBenchmarks(Suite& suite);
+    void registerSchemaBenchmarks(Suite& suite);
+    void registerAsyncBenchmarks(Suite& suite); // only if compiled with C++20
+}
+
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file BondingBench.cpp
+ * @author Jan Wielgus
+ * @brief Request -> echo through BondedComm with two loopback links:
+ * striped frames (overhead of bonding), redundant frames over lossy links
+ * (goodput compared with impaired_loopbackcomm_loss10) and failover
+ * after one link stops working.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "BondedComm.h"
+#include "LoopbackComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t FramesPerCall = 16;
+    const Packet::PacketIDType FrameID = 30;
+
+
+    struct BondingFixture
+    {
+        LoopbackLink firstLink;
+        LoopbackLink secondLink;
+        BondedComm<2> sideA;
+        BondedComm<2> sideB;
+        std::vector<uint8_t> frame;
+
+        BondingFixture(size_t payloadSize, const LinkImpairments& first, const LinkImpairments& second, bool redundant)
+            : firstLink(first),
+              secondLink(second),
+              frame(makeFrame(FrameID, payloadSize, 5))
+        {
+            sideA.addLink(&firstLink.getEndpointA(), 1);
+            sideA.addLink(&secondLink.getEndpointA(), 1);
+            sideB.addLink(&firstLink.getEndpointB(), 1);
+            sideB.addLink(&secondLink.getEndpointB(), 1);
+
+            if (redundant)
+            {
+                sideA.addRedundantPacket(FrameID);
+                sideB.addRedundantPacket(FrameID);
+            }
+        }
+
+        /**
+         * @return Amount of frames that came back to the side A.
+         */
+        size_t run()
+        {
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                sideA.send(frame.data(), frame.size());
+
+            while (sideB.receive())
+            {
+                DataBuffer received = sideB.getReceived();
+                sideB.send(received.buffer, received.size);
+            }
+
+            size_t echoed = 0;
+            while (sideA.receive())
+                echoed++;
+            return echoed;
+        }
+    };
+}
+
+
+void Bench::registerBondingBenchmarks(Suite& suite)
+{
+    const size_t PayloadSize = 32;
+    const std::string Suffix = "/" + std::to_string(PayloadSize);
+
+    LinkImpairments perfect;
+
+    LinkImpairments lossy;
+    lossy.lossProbability = 0.10f;
+    lossy.seed = 12345;
+
+    LinkImpairments otherLossy = lossy;
+    otherLossy.seed = 54321;
+
+    LinkImpairments dead;
+    dead.lossProbability = 1.0f;
+
+    auto striped = std::make_shared<BondingFixture>(PayloadSize, perfect, perfect, false);
+    suite.addCounted("bonding_striped" + Suffix, PayloadSize, [=]() {
+        return striped->run();
+    });
+
+    auto redundant = std::make_shared<BondingFixture>(PayloadSize, lossy, otherLossy, true);
+    suite.addCounted("bonding_redundant_loss10" + Suffix, PayloadSize, [=]() {
+        return redundant->run();
+    });
+
+    auto stripedLossy = std::make_shared<BondingFixture>(PayloadSize, lossy, otherLossy, false);
+    suite.addCounted("bonding_striped_loss10" + Suffix, PayloadSize, [=]() {
+        return stripedLossy->run();
+    });
+
+    auto failover = std::make_shared<BondingFixture>(PayloadSize, perfect, dead, false);
+    suite.addCounted("bonding_failover_deadlink" + Suffix, PayloadSize, [=]() {
+        return failover->run();
+    });
+}
@@ -0,0 +1,112 @@
+/**
+ * @file BroadcastBench.cpp
+ * @author Jan Wielgus
+ * @brief The same packet sent by N StreamComm links: one PacketCommunication
+ * per link (packet serialized and encoded N times) compared with
+ * PacketBroadcaster (serialized and encoded once).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "PacketBroadcaster.h"
+#include "BufferPool.h"
+#include "StreamComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 1100;
+
+
+    /**
+     * @brief Stream that drops everything written to it.
+     */
+    class NullStream : public Stream
+    {
+    public:
+        size_t write(uint8_t data) override
+        {
+            doNotOptimize(data);
+            return 1;
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            doNotOptimize(buffer[size - 1]);
+            return size;
+        }
+
+        int available() override { return 0; }
+        int read() override { return -1; }
+        int peek() override { return -1; }
+    };
+
+
+    struct FanOutFixture
+    {
+        std::vector<std::unique_ptr<NullStream>> streams;
+        std::vector<std::unique_ptr<StreamComm<MaxBufferSize>>> links;
+        std::vector<std::unique_ptr<PacketCommunication>> comms;
+        BufferPool<2 * MaxBufferSize, 4> pool;
+        PacketBroadcaster broadcaster;
+        std::vector<uint8_t> payload;
+        DataPacket packet;
+
+        FanOutFixture(size_t linksAmount, size_t payloadSize)
+            : broadcaster(&pool),
+              payload(makePayload(payloadSize, 16)),
+              packet(42, payload.data(), payloadSize)
+        {
+            for (size_t i = 0; i < linksAmount; ++i)
+            {
+                streams.emplace_back(new NullStream);
+                links.emplace_back(new StreamComm<MaxBufferSize>(streams.back().get()));
+                comms.emplace_back(new PacketCommunication(links.back().get()));
+                broadcaster.addLink(links.back().get());
+            }
+        }
+
+        void sendSeparately()
+        {
+            for (auto& comm : comms)
+                comm->send(&packet);
+        }
+
+        void sendBroadcast()
+        {
+            broadcaster.send(&packet);
+        }
+    };
+}
+
+
+void Bench::registerBroadcastBenchmarks(Suite& suite)
+{
+    const size_t LinksAmounts[] = { 2, 8 };
+    const size_t PayloadSizes[] = { 32, 1024 };
+
+    for (size_t links : LinksAmounts)
+    {
+        for (size_t size : PayloadSizes)
+        {
+            auto fixture = std::make_shared<FanOutFixture>(links, size);
+            std::string suffix = std::to_string(links) + "links/" + std::to_string(size);
+
+            // one frame = packet sent by all links
+            suite.add("fanout_separate/" + suffix, 1, size, [=]() {
+                fixture->sendSeparately();
+            });
+
+            suite.add("fanout_broadcast/" + suffix, 1, size, [=]() {
+                fixture->sendBroadcast();
+            });
+        }
+    }
+}
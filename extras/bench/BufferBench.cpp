@@ -0,0 +1,54 @@
+/**
+ * @file BufferBench.cpp
+ * @author Jan Wielgus
+ * @brief AutoDataBuffer lifetime of a received frame (allocate, fill, copy, release)
+ * with new[], with BufferPool and with inline storage of small buffers.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataBuffer.h"
+#include "BufferPool.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    typedef BufferPool<1024, 8> FramePool;
+
+
+    void handleFrame(const std::vector<uint8_t>& payload, IBufferAllocator* allocator)
+    {
+        AutoDataBuffer frame(payload.size(), allocator);
+        frame.size = payload.size();
+        memcpy(frame.buffer, payload.data(), payload.size());
+
+        AutoDataBuffer copy(frame); // eg. queued for another consumer
+        doNotOptimize(copy.buffer[copy.size - 1]);
+        clobberMemory();
+    }
+}
+
+
+void Bench::registerBufferBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 8, 64, 1024 };
+    auto pool = std::make_shared<FramePool>();
+
+    for (size_t size : PayloadSizes)
+    {
+        auto payload = std::make_shared<std::vector<uint8_t>>(makePayload(size, 14));
+
+        suite.add("autodatabuffer_frame_heap/" + std::to_string(size), 1, size, [=]() {
+            handleFrame(*payload, nullptr);
+        });
+
+        suite.add("autodatabuffer_frame_pool/" + std::to_string(size), 1, size, [=]() {
+            handleFrame(*payload, pool.get());
+        });
+    }
+}
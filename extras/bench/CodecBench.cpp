@@ -0,0 +1,56 @@
+/**
+ * @file CodecBench.cpp
+ * @author Jan Wielgus
+ * @brief COBS, SLIP and checksum benchmarks.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "Encoding/COBS.h"
+#include "Encoding/SLIP.h"
+#include "Encoding/XORChecksum.h"
+#include <memory>
+
+using namespace Bench;
+
+
+void Bench::registerCodecBenchmarks(Suite& suite)
+{
+    const size_t Sizes[] = { 8, 64, 250, 1024 };
+
+    for (size_t size : Sizes)
+    {
+        auto source = std::make_shared<std::vector<uint8_t>>(makePayload(size, 1));
+        auto encoded = std::make_shared<std::vector<uint8_t>>(SLIP::getEncodedBufferSize(size));
+        auto decoded = std::make_shared<std::vector<uint8_t>>(SLIP::getEncodedBufferSize(size));
+        std::string suffix = "/" + std::to_string(size);
+
+        size_t cobsSize = COBS::encode(source->data(), size, encoded->data());
+        auto cobsEncoded = std::make_shared<std::vector<uint8_t>>(encoded->begin(), encoded->begin() + cobsSize);
+        suite.add("cobs_encode" + suffix, 1, size, [=]() {
+            doNotOptimize(COBS::encode(source->data(), size, encoded->data()));
+            clobberMemory();
+        });
+        suite.add("cobs_decode" + suffix, 1, size, [=]() {
+            doNotOptimize(COBS::decode(cobsEncoded->data(), cobsEncoded->size(), decoded->data()));
+            clobberMemory();
+        });
+
+        size_t slipSize = SLIP::encode(source->data(), size, encoded->data());
+        auto slipEncoded = std::make_shared<std::vector<uint8_t>>(encoded->begin(), encoded->begin() + slipSize);
+        suite.add("slip_encode" + suffix, 1, size, [=]() {
+            doNotOptimize(SLIP::encode(source->data(), size, encoded->data()));
+            clobberMemory();
+        });
+        suite.add("slip_decode" + suffix, 1, size, [=]() {
+            doNotOptimize(SLIP::decode(slipEncoded->data(), slipEncoded->size(), decoded->data()));
+            clobberMemory();
+        });
+
+        suite.add("xor_checksum" + suffix, 1, size, [=]() {
+            doNotOptimize(PacketComm::XORChecksum::calculate(source->data(), size));
+            clobberMemory();
+        });
+    }
+}
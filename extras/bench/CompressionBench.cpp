@@ -0,0 +1,193 @@
+/**
+ * @file CompressionBench.cpp
+ * @author Jan Wielgus
+ * @brief LZ4 compression ratio (compressed size is in the name) and speed on configuration
+ * text, occupancy map and telemetry-like payloads, and StreamComm send and receive
+ * with and without CompressionComm.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "CompressionComm.h"
+#include "LoopbackComm.h"
+#include "StreamComm.h"
+#include "Encoding/LZ4.h"
+#include <memory>
+#include <stdio.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxPayloadSize = 4096;
+    const size_t MaxBufferSize = MaxPayloadSize + 64;
+    const Packet::PacketIDType PayloadID = 50;
+    typedef StreamComm<MaxBufferSize, LoopbackStream> LinkComm;
+    typedef CompressionComm<MaxPayloadSize> Compression;
+
+    size_t receivedPackets = 0;
+
+    void onPacketReceived()
+    {
+        receivedPackets++;
+    }
+
+
+    /**
+     * @brief Configuration as text lines, eg. "motor2.pid.kd=0.0123".
+     */
+    std::vector<uint8_t> makeConfigPayload(size_t size)
+    {
+        const char* Groups[] = { "motor", "servo", "imu", "baro", "gps" };
+        const char* Keys[] = { "pid.kp", "pid.ki", "pid.kd", "offset", "scale", "rate" };
+        std::vector<uint8_t> values = makePayload(size, 11);
+        std::string text;
+
+        for (size_t i = 0; text.size() < size; ++i)
+        {
+            char line[64];
+            snprintf(line, sizeof(line), "%s%u.%s=%u.%04u\n", Groups[i / 6 % 5], (unsigned)(i / 30 % 4), Keys[i % 6],
+                     (unsigned)(values[i % size] % 4), (unsigned)(values[(i * 7) % size] * 37 % 10000));
+            text += line;
+        }
+
+        return std::vector<uint8_t>(text.begin(), text.begin() + size);
+    }
+
+    /**
+     * @brief Occupancy grid (64 cells in a row): free and unknown areas, walls and some noise.
+     */
+    std::vector<uint8_t> makeMapPayload(size_t size)
+    {
+        const uint8_t Free = 0;
+        const uint8_t Occupied = 100;
+        const uint8_t Unknown = 255;
+        std::vector<uint8_t> noise = makePayload(size, 12);
+        std::vector<uint8_t> map(size);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            size_t row = i / 64;
+            size_t column = i % 64;
+            uint8_t cell = column < 8 + row % 5 ? Unknown : Free;
+            if (column == 40 || row % 16 == 0)
+                cell = Occupied;
+            if (noise[i] % 23 == 1)
+                cell = noise[i] % 101; // measurement noise
+            map[i] = cell;
+        }
+
+        return map;
+    }
+
+
+    /**
+     * @brief PacketCommunication over StreamComm (loopback), optionally with CompressionComm.
+     */
+    struct LinkFixture
+    {
+        LoopbackStreamPair link;
+        LinkComm senderStream;
+        LinkComm receiverStream;
+        std::unique_ptr<Compression> senderCompression;
+        std::unique_ptr<Compression> receiverCompression;
+        std::unique_ptr<PacketCommunication> sender;
+        std::unique_ptr<PacketCommunication> receiver;
+        std::vector<uint8_t> sendPayload;
+        std::vector<uint8_t> receivePayload;
+        DataPacket sendPacket;
+        DataPacket receivePacket;
+
+        LinkFixture(const std::vector<uint8_t>& payload, bool compressed)
+            : senderStream(&link.getEndpointA()),
+              receiverStream(&link.getEndpointB()),
+              sendPayload(payload),
+              receivePayload(payload.size()),
+              sendPacket(PayloadID, sendPayload.data(), sendPayload.size()),
+              receivePacket(PayloadID, receivePayload.data(), receivePayload.size(), onPacketReceived)
+        {
+            if (compressed)
+            {
+                senderCompression.reset(new Compression(&senderStream));
+                receiverCompression.reset(new Compression(&receiverStream));
+                senderCompression->addCompressedPacket(PayloadID);
+                receiverCompression->addCompressedPacket(PayloadID);
+                sender.reset(new PacketCommunication(senderCompression.get()));
+                receiver.reset(new PacketCommunication(receiverCompression.get()));
+            }
+            else
+            {
+                sender.reset(new PacketCommunication(&senderStream));
+                receiver.reset(new PacketCommunication(&receiverStream));
+            }
+            receiver->registerReceivePacket(&receivePacket);
+        }
+
+        size_t run()
+        {
+            receivedPackets = 0;
+            sender->send(&sendPacket);
+            receiver->receive();
+            return receivedPackets;
+        }
+    };
+
+
+    void addPayloadBenchmarks(Suite& suite, const std::string& name, const std::vector<uint8_t>& payload)
+    {
+        auto source = std::make_shared<std::vector<uint8_t>>(payload);
+        auto compressed = std::make_shared<std::vector<uint8_t>>(LZ4::getMaxCompressedSize(payload.size()));
+        auto decompressed = std::make_shared<std::vector<uint8_t>>(payload.size());
+        auto compressor = std::make_shared<LZ4Compressor<10>>();
+        auto smallCompressor = std::make_shared<LZ4Compressor<8>>();
+        size_t size = payload.size();
+
+        size_t compressedSize = compressor->compress(source->data(), size, compressed->data(), compressed->size());
+        size_t smallCompressedSize = smallCompressor->compress(source->data(), size, compressed->data(), compressed->size());
+        std::string suffix = "/" + name + "_" + std::to_string(size) + "B_to_";
+
+        suite.add("lz4_compress_hash10" + suffix + std::to_string(compressedSize) + "B", 1, size, [=]() {
+            doNotOptimize(compressor->compress(source->data(), size, compressed->data(), compressed->size()));
+            clobberMemory();
+        });
+        suite.add("lz4_compress_hash8" + suffix + std::to_string(smallCompressedSize) + "B", 1, size, [=]() {
+            doNotOptimize(smallCompressor->compress(source->data(), size, compressed->data(), compressed->size()));
+            clobberMemory();
+        });
+
+        compressedSize = compressor->compress(source->data(), size, compressed->data(), compressed->size());
+        suite.add("lz4_decompress" + suffix + std::to_string(compressedSize) + "B", 1, size, [=]() {
+            doNotOptimize(LZ4::decompress(compressed->data(), compressedSize, decompressed->data(), decompressed->size()));
+            clobberMemory();
+        });
+
+        auto raw = std::make_shared<LinkFixture>(payload, false);
+        auto withCompression = std::make_shared<LinkFixture>(payload, true);
+        std::string linkSuffix = "/" + name + "_" + std::to_string(size) + "B";
+
+        suite.addCounted("streamcomm_send_receive" + linkSuffix, size, [=]() {
+            return raw->run();
+        });
+        suite.addCounted("streamcomm_send_receive_compressed" + linkSuffix, size, [=]() {
+            return withCompression->run();
+        });
+    }
+}
+
+
+void Bench::registerCompressionBenchmarks(Suite& suite)
+{
+    const size_t Sizes[] = { 1024, MaxPayloadSize };
+
+    for (size_t size : Sizes)
+    {
+        addPayloadBenchmarks(suite, "config", makeConfigPayload(size));
+        addPayloadBenchmarks(suite, "map", makeMapPayload(size));
+        addPayloadBenchmarks(suite, "telemetry", makePayload(size, 13));
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * @file ConcurrentBench.cpp
+ * @author Jan Wielgus
+ * @brief Thread-safe host mode: seqlock packet access cost and packets sent
+ * by the application thread through two I/O threads (shared memory between them).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "ConcurrentDataPacket.h"
+#include "ConcurrentPacketCommunication.h"
+#include "SharedMemoryComm.h"
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <sys/eventfd.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t FramesPerCall = 64;
+
+    typedef ConcurrentPacketCommunication<256> ConcurrentComm;
+
+
+    struct ConcurrentRoundTrip
+    {
+        SharedMemoryComm lowLevelA;
+        SharedMemoryComm lowLevelB;
+        int doorbellA;
+        int doorbellB;
+        std::unique_ptr<ConcurrentComm> commA;
+        std::unique_ptr<ConcurrentComm> commB;
+        std::vector<uint8_t> payload;
+        DataPacket sendPacket;
+        ConcurrentDataPacket receivePacket;
+        bool ready = false;
+
+        explicit ConcurrentRoundTrip(size_t payloadSize)
+            : doorbellA(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+              doorbellB(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+              payload(makePayload(payloadSize, 11)),
+              sendPacket(50, payload.data(), payloadSize),
+              receivePacket(50, payloadSize)
+        {
+            std::string name = "/packetcomm_bench_concurrent_" + std::to_string(getpid()) + "_" + std::to_string(payloadSize);
+            bool connected = lowLevelA.create(name.c_str(), 1 << 20) && lowLevelB.open(name.c_str());
+            SharedMemoryComm::unlink(name.c_str());
+            if (!connected || doorbellA < 0 || doorbellB < 0)
+                return;
+
+            lowLevelA.setWakeupEventFds(doorbellA, doorbellB);
+            lowLevelB.setWakeupEventFds(doorbellB, doorbellA);
+
+            commA.reset(new ConcurrentComm(&lowLevelA, 1024));
+            commB.reset(new ConcurrentComm(&lowLevelB, 1024));
+            commB->registerReceivePacket(&receivePacket);
+            ready = commA->startIOThread(doorbellA) && commB->startIOThread(doorbellB);
+        }
+
+        ~ConcurrentRoundTrip()
+        {
+            commA.reset(); // stop I/O threads before shared memory is closed
+            commB.reset();
+            ::close(doorbellA);
+            ::close(doorbellB);
+        }
+
+        /**
+         * @return Amount of updates of the received packet seen by the application thread.
+         */
+        size_t run()
+        {
+            uint32_t versionBefore = receivePacket.getVersion();
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                while (!commA->send(&sendPacket))
+                    std::this_thread::yield(); // send queue is full
+
+            for (int attempt = 0; attempt < 100000 && receivePacket.getVersion() - versionBefore < FramesPerCall; ++attempt)
+                std::this_thread::yield();
+
+            return receivePacket.getVersion() - versionBefore;
+        }
+    };
+}
+
+
+void Bench::registerConcurrentBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 4, 32, 250 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto packet = std::make_shared<ConcurrentDataPacket>(1, size);
+        auto input = std::make_shared<std::vector<uint8_t>>(makePayload(size, 12));
+        auto output = std::make_shared<std::vector<uint8_t>>(size);
+
+        suite.add("concurrent_datapacket_write/" + std::to_string(size), 1, size, [=]() {
+            packet->write(input->data());
+            clobberMemory();
+        });
+
+        suite.add("concurrent_datapacket_read/" + std::to_string(size), 1, size, [=]() {
+            doNotOptimize(packet->read(output->data()));
+            clobberMemory();
+        });
+    }
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<ConcurrentRoundTrip>(size);
+        if (!fixture->ready)
+        {
+            fprintf(stderr, "shared memory is not available, skipping concurrent round trip benchmarks\n");
+            return;
+        }
+
+        suite.addCounted("concurrent_roundtrip_threads/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+}
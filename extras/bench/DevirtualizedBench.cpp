@@ -0,0 +1,145 @@
+/**
+ * @file DevirtualizedBench.cpp
+ * @author Jan Wielgus
+ * @brief Send -> receive through StreamComm over an in-memory stream:
+ * PacketCommunication with StreamComm<N> (virtual calls) compared with
+ * PacketCommunicationT with StreamComm<N, ConcreteStream> (inlined calls)
+ * and heap-free StaticPacketCommunication.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "PacketCommunicationT.h"
+#include "StaticPacketCommunication.h"
+#include "StreamComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 512;
+    const size_t FramesPerCall = 16;
+    size_t receivedCounter = 0;
+
+    void onReceive()
+    {
+        receivedCounter++;
+    }
+
+
+    /**
+     * @brief Stream that reads back bytes written to it (fixed size ring,
+     * big enough for all frames sent in one benchmark call).
+     */
+    class MemoryStream : public Stream
+    {
+        static const size_t Capacity = 16384; // power of 2
+        uint8_t ring[Capacity];
+        size_t head = 0;
+        size_t tail = 0;
+
+    public:
+        size_t write(uint8_t data) override
+        {
+            ring[head++ & (Capacity - 1)] = data;
+            return 1;
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            for (size_t i = 0; i < size; ++i)
+                ring[head++ & (Capacity - 1)] = buffer[i];
+            return size;
+        }
+
+        int available() override
+        {
+            return (int)(head - tail);
+        }
+
+        int read() override
+        {
+            return head != tail ? ring[tail++ & (Capacity - 1)] : -1;
+        }
+
+        int peek() override
+        {
+            return head != tail ? ring[tail & (Capacity - 1)] : -1;
+        }
+    };
+
+
+    template <class LowLevelType, class CommType>
+    struct LoopFixture
+    {
+        MemoryStream stream;
+        LowLevelType lowLevel;
+        CommType comm;
+        std::vector<uint8_t> payload;
+        DataPacket packet;
+
+        explicit LoopFixture(size_t payloadSize)
+            : lowLevel(&stream),
+              comm(&lowLevel),
+              payload(makePayload(payloadSize, 13)),
+              packet(40, payload.data(), payloadSize, onReceive)
+        {
+            // stream is read back, so the sent packet is also the received one
+            comm.registerReceivePacket(&packet);
+        }
+
+        /**
+         * @return Amount of frames that were successfully received.
+         */
+        size_t run()
+        {
+            size_t receivedBefore = receivedCounter;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                comm.send(&packet);
+            comm.receive();
+            return receivedCounter - receivedBefore;
+        }
+    };
+
+    typedef StreamComm<MaxBufferSize> VirtualStreamComm;
+    typedef StreamComm<MaxBufferSize, MemoryStream> ConcreteStreamComm;
+    typedef LoopFixture<VirtualStreamComm, PacketCommunication> VirtualFixture;
+    typedef LoopFixture<ConcreteStreamComm, PacketCommunicationT<ConcreteStreamComm>> DevirtualizedFixture;
+    typedef LoopFixture<ConcreteStreamComm, StaticPacketCommunication<ConcreteStreamComm, 4, MaxBufferSize>> StaticFixture;
+}
+
+
+void Bench::registerDevirtualizedBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 4, 32, 250 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<VirtualFixture>(size);
+        suite.addCounted("streamcomm_loop_virtual/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<DevirtualizedFixture>(size);
+        suite.addCounted("streamcomm_loop_devirtualized/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<StaticFixture>(size);
+        suite.addCounted("streamcomm_loop_static/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+}
@@ -0,0 +1,205 @@
+/**
+ * @file EventLoopBench.cpp
+ * @author Jan Wielgus
+ * @brief LinuxEventLoop wake-up latency: echo server thread sleeps in epoll
+ * and answers every frame (UDP socket and shared memory doorbell).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "LinuxEventLoop.h"
+#include "LinuxUDPComm.h"
+#include "SharedMemoryComm.h"
+#include <memory>
+#include <poll.h>
+#include <stdio.h>
+#include <thread>
+#include <sys/eventfd.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t FramesPerCall = 16;
+
+
+    /**
+     * @brief Event loop running in its own thread. Stopped by the eventfd.
+     */
+    struct EchoServerThread
+    {
+        LinuxEventLoop loop;
+        int stopFd;
+        std::thread thread;
+
+        EchoServerThread()
+            : stopFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+        {
+            loop.addFileDescriptor(stopFd, [this]() { loop.stop(); });
+        }
+
+        ~EchoServerThread()
+        {
+            stopThread();
+            if (stopFd >= 0)
+                ::close(stopFd);
+        }
+
+        void start()
+        {
+            thread = std::thread([this]() { loop.run(); });
+        }
+
+        void stopThread()
+        {
+            if (!thread.joinable())
+                return;
+            uint64_t one = 1;
+            ssize_t ignored = ::write(stopFd, &one, sizeof(one));
+            (void)ignored;
+            thread.join();
+        }
+    };
+
+
+    struct UDPEcho
+    {
+        LinuxUDPComm server;
+        LinuxUDPComm client;
+        EchoServerThread serverThread;
+        std::vector<uint8_t> payload;
+        bool ready = false;
+
+        explicit UDPEcho(size_t payloadSize)
+            : server(1472, 16),
+              client(1472, 16),
+              payload(makePayload(payloadSize, 8))
+        {
+            if (!server.begin(0, "127.0.0.1") || !client.begin(0, "127.0.0.1"))
+                return;
+            client.setTargetPeer(client.addPeer("127.0.0.1", server.getLocalPort()));
+            client.setSendBatching(false);
+
+            ready = serverThread.loop.addFileDescriptor(server.getFileDescriptor(), [this]() {
+                while (server.receive())
+                {
+                    DataBuffer received = server.getReceived();
+                    server.send(received.buffer, received.size);
+                }
+                server.flush();
+            });
+            if (ready)
+                serverThread.start();
+        }
+
+        ~UDPEcho()
+        {
+            serverThread.stopThread(); // before transceivers are destroyed
+        }
+
+        size_t run()
+        {
+            size_t echoes = 0;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+            {
+                if (!client.send(payload.data(), payload.size()))
+                    break;
+                while (!client.receive())
+                {
+                    pollfd pfd = { client.getFileDescriptor(), POLLIN, 0 };
+                    if (::poll(&pfd, 1, 100) <= 0)
+                        return echoes;
+                }
+                echoes++;
+            }
+            return echoes;
+        }
+    };
+
+
+    struct SharedMemoryEcho
+    {
+        SharedMemoryComm server;
+        SharedMemoryComm client;
+        int serverDoorbell;
+        EchoServerThread serverThread;
+        std::vector<uint8_t> payload;
+        bool ready = false;
+
+        explicit SharedMemoryEcho(size_t payloadSize)
+            : serverDoorbell(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+              payload(makePayload(payloadSize, 9))
+        {
+            std::string name = "/packetcomm_bench_loop_" + std::to_string(getpid());
+            bool connected = server.create(name.c_str(), 1 << 16) && client.open(name.c_str());
+            SharedMemoryComm::unlink(name.c_str());
+            if (!connected || serverDoorbell < 0)
+                return;
+
+            // client sleeps on the futex (waitForData()), server waits in epoll
+            server.setWakeupEventFds(serverDoorbell, -1);
+            client.setWakeupEventFds(-1, serverDoorbell);
+
+            ready = serverThread.loop.addFileDescriptor(server.getFileDescriptor(), [this]() {
+                while (server.receive())
+                {
+                    DataBuffer received = server.getReceived();
+                    server.send(received.buffer, received.size);
+                }
+            });
+            if (ready)
+                serverThread.start();
+        }
+
+        ~SharedMemoryEcho()
+        {
+            serverThread.stopThread();
+            if (serverDoorbell >= 0)
+                ::close(serverDoorbell);
+        }
+
+        size_t run()
+        {
+            size_t echoes = 0;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+            {
+                if (!client.send(payload.data(), payload.size()))
+                    break;
+                while (!client.receive())
+                    if (!client.waitForData(100))
+                        return echoes;
+                echoes++;
+            }
+            return echoes;
+        }
+    };
+}
+
+
+void Bench::registerEventLoopBenchmarks(Suite& suite)
+{
+    const size_t PayloadSize = 32;
+
+    auto udpFixture = std::make_shared<UDPEcho>(PayloadSize);
+    if (udpFixture->ready)
+    {
+        suite.addCounted("eventloop_udp_echo/" + std::to_string(PayloadSize), PayloadSize, [=]() {
+            return udpFixture->run();
+        });
+    }
+    else
+        fprintf(stderr, "UDP sockets are not available, skipping event loop UDP benchmark\n");
+
+    auto shmFixture = std::make_shared<SharedMemoryEcho>(PayloadSize);
+    if (shmFixture->ready)
+    {
+        suite.addCounted("eventloop_sharedmemory_echo/" + std::to_string(PayloadSize), PayloadSize, [=]() {
+            return shmFixture->run();
+        });
+    }
+    else
+        fprintf(stderr, "shared memory is not available, skipping event loop shared memory benchmark\n");
+}
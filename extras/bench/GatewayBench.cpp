@@ -0,0 +1,149 @@
+/**
+ * @file GatewayBench.cpp
+ * @author Jan Wielgus
+ * @brief ShardedGateway scaling over 1..N cores: many UDP links on the loopback
+ * interface, frames are passed to the application thread.
+ * Also traffic concentrated on one shard (with and without work stealing).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "LinuxUDPComm.h"
+#include "ShardedGateway.h"
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <sys/resource.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t LinksAmount = 128;
+    const size_t FramesPerLink = 4;
+    const size_t PayloadSize = 32;
+
+    typedef ShardedGateway<256> Gateway;
+
+
+    struct GatewayFixture
+    {
+        std::vector<std::unique_ptr<LinuxUDPComm>> links;
+        std::vector<LinuxUDPComm::PeerID> loadedLinks; // peers of the driver that receive traffic
+        LinuxUDPComm driver;
+        std::unique_ptr<Gateway> gateway;
+        std::vector<uint8_t> payload;
+        bool ready = false;
+
+        /**
+         * @param hotShardOnly Send only to links of the first shard.
+         */
+        GatewayFixture(size_t shardsAmount, bool hotShardOnly, bool workStealing)
+            : driver(1472, 64),
+              payload(makePayload(PayloadSize, 10))
+        {
+            ShardedGatewayConfig config;
+            config.shardsAmount = shardsAmount;
+            config.workStealing = workStealing;
+            config.stealThreshold = 1;
+            config.maxFramesPerBatch = 16;
+            gateway.reset(new Gateway(config));
+
+            if (!driver.begin(0, "127.0.0.1"))
+                return;
+
+            for (size_t i = 0; i < LinksAmount; ++i)
+            {
+                links.emplace_back(new LinuxUDPComm(1472, 16));
+                LinuxUDPComm& link = *links.back();
+                if (!link.begin(0, "127.0.0.1"))
+                    return;
+
+                // links are assigned to shards in turn
+                Gateway::LinkID id = gateway->addLink(&link, link.getFileDescriptor());
+                LinuxUDPComm::PeerID peer = driver.addPeer("127.0.0.1", link.getLocalPort());
+                if (!hotShardOnly || id % shardsAmount == 0)
+                    loadedLinks.push_back(peer);
+            }
+
+            ready = gateway->start();
+        }
+
+        ~GatewayFixture()
+        {
+            gateway->stop(); // before links are closed
+        }
+
+        size_t run()
+        {
+            size_t framesToReceive = 0;
+            for (size_t frame = 0; frame < FramesPerLink; ++frame)
+                for (LinuxUDPComm::PeerID peer : loadedLinks)
+                    if (driver.sendTo(peer, payload.data(), payload.size()))
+                        framesToReceive++;
+            driver.flush();
+
+            size_t received = 0;
+            while (received < framesToReceive)
+            {
+                size_t polled = gateway->pollReceived([&](const Gateway::ReceivedFrame& frame) {
+                    doNotOptimize(frame.data[0]);
+                });
+                received += polled;
+                if (polled == 0 && !gateway->waitForFrames(100))
+                    break; // lost datagrams
+            }
+            return received;
+        }
+    };
+
+
+    /**
+     * @brief Many sockets are opened, raise the limit of file descriptors.
+     */
+    void raiseFileDescriptorsLimit()
+    {
+        rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+        {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+}
+
+
+void Bench::registerGatewayBenchmarks(Suite& suite)
+{
+    raiseFileDescriptorsLimit();
+
+    size_t cores = std::thread::hardware_concurrency();
+    size_t maxShards = cores > 2 ? cores : 2;
+
+    for (size_t shards = 1; shards <= maxShards; shards *= 2)
+    {
+        auto fixture = std::make_shared<GatewayFixture>(shards, false, true);
+        if (!fixture->ready)
+        {
+            fprintf(stderr, "UDP sockets are not available, skipping gateway benchmarks\n");
+            return;
+        }
+
+        suite.addCounted("gateway_udp_scaling/" + std::to_string(shards) + "shards", PayloadSize, [=]() {
+            return fixture->run();
+        });
+    }
+
+    for (bool stealing : { false, true })
+    {
+        auto fixture = std::make_shared<GatewayFixture>(maxShards, true, stealing);
+        std::string name = std::string("gateway_udp_hotshard_") + (stealing ? "stealing" : "nostealing")
+            + "/" + std::to_string(maxShards) + "shards";
+        suite.addCounted(name, PayloadSize, [=]() {
+            return fixture->run();
+        });
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file PacketBench.cpp
+ * @author Jan Wielgus
+ * @brief Packet serialization and registered packets lookup benchmarks.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    /**
+     * @brief Exposes protected lookup of PacketCommunication.
+     */
+    class LookupComm : public PacketCommunication
+    {
+    public:
+        explicit LookupComm(ITransceiver* lowLevelComm)
+            : PacketCommunication(lowLevelComm)
+        {
+        }
+
+        using PacketCommunication::getRegisteredReceivePacket;
+    };
+
+
+    struct PacketFixture
+    {
+        std::vector<uint8_t> payload;
+        DataPacket packet;
+        std::vector<uint8_t> buffer;
+
+        explicit PacketFixture(size_t payloadSize)
+            : payload(makePayload(payloadSize, 2)),
+              packet(7, payload.data(), payload.size()),
+              buffer(packet.getSize())
+        {
+            packet.getBuffer(buffer.data());
+        }
+    };
+
+
+    struct RegistryFixture
+    {
+        std::vector<std::vector<uint8_t>> payloads;
+        std::vector<std::unique_ptr<DataPacket>> packets;
+        LookupComm comm;
+        std::vector<uint8_t> lastPacketBuffer;
+
+        explicit RegistryFixture(size_t registeredAmount)
+            : comm(nullptr)
+        {
+            payloads.resize(registeredAmount);
+            for (size_t i = 0; i < registeredAmount; ++i)
+            {
+                payloads[i] = makePayload(8, (uint32_t)i);
+                packets.emplace_back(new DataPacket((Packet::PacketIDType)(i * 3 + 10), payloads[i].data(), payloads[i].size()));
+                comm.registerReceivePacket(packets.back().get());
+            }
+
+            lastPacketBuffer.resize(packets.back()->getSize());
+            packets.back()->getBuffer(lastPacketBuffer.data());
+        }
+    };
+}
+
+
+void Bench::registerPacketBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 4, 32, 250, 1024 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<PacketFixture>(size);
+        std::string suffix = "/" + std::to_string(size);
+
+        suite.add("packet_getBuffer" + suffix, 1, size, [=]() {
+            doNotOptimize(fixture->packet.getBuffer(fixture->buffer.data()));
+            clobberMemory();
+        });
+        suite.add("packet_updatePacketBuffer" + suffix, 1, size, [=]() {
+            doNotOptimize(fixture->packet.updatePacketBuffer(fixture->buffer.data()));
+            clobberMemory();
+        });
+    }
+
+
+    const size_t RegisteredAmounts[] = { 4, 32, 128 };
+
+    for (size_t amount : RegisteredAmounts)
+    {
+        auto fixture = std::make_shared<RegistryFixture>(amount);
+        std::string suffix = "/" + std::to_string(amount);
+
+        // worst case: the last registered packet
+        suite.add("registry_lookup_last" + suffix, 1, 0, [=]() {
+            DataBuffer buffer(fixture->lastPacketBuffer.data(), fixture->lastPacketBuffer.size());
+            doNotOptimize(fixture->comm.getRegisteredReceivePacket(buffer));
+            clobberMemory();
+        });
+        suite.add("registry_lookup_missing" + suffix, 1, 0, [=]() {
+            doNotOptimize(fixture->comm.getRegisteredReceivePacket((Packet::PacketIDType)1));
+            clobberMemory();
+        });
+    }
+}
@@ -0,0 +1,178 @@
+/**
+ * @file ReplayBench.cpp
+ * @author Jan Wielgus
+ * @brief Recorded traffic (mix of packet sizes captured by CaptureComm and CaptureStream)
+ * replayed as fast as possible into PacketCommunication: decoded frames (ReplayComm)
+ * and raw bytes decoded by StreamComm (ReplayStream).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "CaptureComm.h"
+#include "ReplayComm.h"
+#include "LoopbackComm.h"
+#include "StreamComm.h"
+#include <memory>
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 300;
+    const size_t RecordedFrames = 1024;
+    const size_t PacketSizes[] = { 8, 32, 64, 250 }; // packet i has ID i + 1
+    const size_t PacketsAmount = sizeof(PacketSizes) / sizeof(PacketSizes[0]);
+    const uint8_t FramesChannel = 0;
+    const uint8_t RawChannel = 1;
+
+    size_t receivedPackets = 0;
+
+    void onPacketReceived()
+    {
+        receivedPackets++;
+    }
+
+
+    /**
+     * @brief Set of packets registered in PacketCommunication (or sent by it).
+     */
+    struct PacketSet
+    {
+        std::vector<std::vector<uint8_t>> payloads;
+        std::vector<std::unique_ptr<DataPacket>> packets;
+
+        PacketSet()
+        {
+            for (size_t i = 0; i < PacketsAmount; ++i)
+            {
+                payloads.push_back(makePayload(PacketSizes[i], i));
+                packets.emplace_back(new DataPacket(i + 1, payloads.back().data(), PacketSizes[i], onPacketReceived));
+            }
+        }
+
+        void registerIn(PacketCommunication& comm)
+        {
+            for (auto& packet : packets)
+                comm.registerReceivePacket(packet.get());
+        }
+    };
+
+
+    /**
+     * @brief Record the trace: the same packets received as frames (channel 0)
+     * and as raw bytes of StreamComm (channel 1).
+     * @return false if the trace could not be written.
+     */
+    bool recordTrace(const char* path)
+    {
+        TraceWriter writer;
+        if (!writer.open(path))
+            return false;
+
+        LoopbackLink frameLink;
+        CaptureComm frameCapture(&frameLink.getEndpointB(), &writer, FramesChannel);
+        PacketCommunication frameSender(&frameLink.getEndpointA());
+
+        LoopbackStreamPair streamLink;
+        CaptureStream rawCapture(&streamLink.getEndpointB(), &writer, RawChannel);
+        StreamComm<MaxBufferSize> streamSender(&streamLink.getEndpointA());
+        StreamComm<MaxBufferSize> streamReceiver(&rawCapture);
+        PacketCommunication rawSender(&streamSender);
+
+        PacketSet sent;
+        DataBuffer batch[PACKETCOMM_RECEIVE_BATCH_SIZE];
+        for (size_t i = 0; i < RecordedFrames; ++i)
+        {
+            // small packets are more frequent
+            const DataPacket* packet = sent.packets[(i * 7) % 11 % PacketsAmount].get();
+            frameSender.send(packet);
+            rawSender.send(packet);
+
+            while (frameCapture.receiveBatch(batch, PACKETCOMM_RECEIVE_BATCH_SIZE) > 0)
+                ;
+            while (streamReceiver.receiveBatch(batch, PACKETCOMM_RECEIVE_BATCH_SIZE) > 0)
+                ;
+        }
+
+        return writer.getFailedRecordsAmount() == 0;
+    }
+
+
+    struct ReplayFixture
+    {
+        TraceReader reader;
+        PacketSet packets;
+        std::unique_ptr<ReplayComm> frameReplay;
+        std::unique_ptr<ReplayStream> rawReplay;
+        std::unique_ptr<StreamComm<MaxBufferSize, ReplayStream>> rawComm;
+        std::unique_ptr<PacketCommunication> comm;
+
+        ReplayFixture(const char* path, bool raw)
+        {
+            if (!reader.open(path))
+                return;
+
+            if (raw)
+            {
+                rawReplay.reset(new ReplayStream(&reader, RawChannel, ReplayTiming::AS_FAST_AS_POSSIBLE));
+                rawComm.reset(new StreamComm<MaxBufferSize, ReplayStream>(rawReplay.get()));
+                comm.reset(new PacketCommunication(rawComm.get()));
+            }
+            else
+            {
+                frameReplay.reset(new ReplayComm(&reader, FramesChannel, ReplayTiming::AS_FAST_AS_POSSIBLE));
+                comm.reset(new PacketCommunication(frameReplay.get()));
+            }
+            packets.registerIn(*comm);
+        }
+
+        /**
+         * @return Amount of received packets (whole trace).
+         */
+        size_t run()
+        {
+            if (comm == nullptr)
+                return 0;
+
+            receivedPackets = 0;
+            comm->receive();
+
+            if (rawReplay != nullptr)
+                rawReplay->rewind();
+            else
+                frameReplay->rewind();
+            return receivedPackets;
+        }
+    };
+}
+
+
+void Bench::registerReplayBenchmarks(Suite& suite)
+{
+    std::string path = "/tmp/packetcomm_bench_" + std::to_string(getpid()) + ".trace";
+    if (!recordTrace(path.c_str()))
+    {
+        fprintf(stderr, "Could not record the trace to %s\n", path.c_str());
+        unlink(path.c_str());
+        return;
+    }
+
+    auto frames = std::make_shared<ReplayFixture>(path.c_str(), false);
+    auto raw = std::make_shared<ReplayFixture>(path.c_str(), true);
+    unlink(path.c_str()); // files stay mapped
+
+    suite.addCounted("replay_frames_packetcomm", 0, [=]() {
+        return frames->run();
+    });
+
+    suite.addCounted("replay_raw_streamcomm", 0, [=]() {
+        return raw->run();
+    });
+}
@@ -0,0 +1,168 @@
+/**
+ * @file RoundTripBench.cpp
+ * @author Jan Wielgus
+ * @brief Full send -> loopback -> receive benchmark
+ * (PacketCommunication and StreamComm on both sides).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "StreamComm.h"
+#include "LoopbackComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 2048;
+    const size_t FramesPerCall = 16;
+    size_t receivedCounter = 0;
+
+    void onReceive()
+    {
+        receivedCounter++;
+    }
+
+
+    /**
+     * @brief Two PacketCommunication instances connected by the loopback
+     * of LowLevelType (StreamComm over LoopbackStreamPair or LoopbackLink).
+     */
+    template <class PairType, class LowLevelType>
+    struct RoundTripFixture
+    {
+        PairType pair;
+        LowLevelType senderLowLevel;
+        LowLevelType receiverLowLevel;
+        PacketCommunication sender;
+        PacketCommunication receiver;
+        std::vector<uint8_t> sendPayload;
+        std::vector<uint8_t> receivePayload;
+        DataPacket sendPacket;
+        DataPacket receivePacket;
+
+        RoundTripFixture(size_t payloadSize, const LinkImpairments& impairments)
+            : pair(impairments),
+              senderLowLevel(&pair.getEndpointA()),
+              receiverLowLevel(&pair.getEndpointB()),
+              sender(&senderLowLevel),
+              receiver(&receiverLowLevel),
+              sendPayload(makePayload(payloadSize, 3)),
+              receivePayload(payloadSize),
+              sendPacket(20, sendPayload.data(), payloadSize),
+              receivePacket(20, receivePayload.data(), payloadSize, onReceive)
+        {
+            receiver.registerReceivePacket(&receivePacket);
+        }
+
+        /**
+         * @return Amount of frames that were successfully received.
+         */
+        size_t run()
+        {
+            size_t receivedBefore = receivedCounter;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                sender.send(&sendPacket);
+            receiver.receive();
+            return receivedCounter - receivedBefore;
+        }
+    };
+
+
+    /**
+     * @brief Passes LoopbackComm endpoint through (frames are sent without any framing).
+     */
+    class DirectLowLevel : public ITransceiver
+    {
+        ITransceiver* endpoint;
+
+    public:
+        explicit DirectLowLevel(ITransceiver* endpoint)
+            : endpoint(endpoint)
+        {
+        }
+
+        bool send(const uint8_t* buffer, size_t size) override { return endpoint->send(buffer, size); }
+        bool receive() override { return endpoint->receive(); }
+        const DataBuffer getReceived() override { return endpoint->getReceived(); }
+        size_t receiveBatch(DataBuffer* out, size_t max) override { return endpoint->receiveBatch(out, max); }
+    };
+
+    typedef RoundTripFixture<LoopbackStreamPair, StreamComm<MaxBufferSize>> StreamRoundTrip;
+    typedef RoundTripFixture<LoopbackLink, DirectLowLevel> FrameRoundTrip;
+}
+
+
+void Bench::registerRoundTripBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 4, 32, 250, 1024 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<StreamRoundTrip>(size, LinkImpairments());
+        suite.addCounted("roundtrip_streamcomm/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<FrameRoundTrip>(size, LinkImpairments());
+        suite.addCounted("roundtrip_loopbackcomm/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+}
+
+
+void Bench::registerImpairedLinkBenchmarks(Suite& suite)
+{
+    struct Scenario
+    {
+        const char* name;
+        float loss;
+        float corruption;
+        float duplication;
+        float reorder;
+        size_t maxFragmentSize;
+    };
+
+    const Scenario Scenarios[] = {
+        { "loss1", 0.01f, 0, 0, 0, 0 },
+        { "loss10", 0.10f, 0, 0, 0, 0 },
+        { "corrupt1", 0, 0.01f, 0, 0, 0 },
+        { "dup1_reorder1", 0, 0, 0.01f, 0.01f, 0 },
+        { "frag8", 0, 0, 0, 0, 8 },
+        { "all", 0.01f, 0.01f, 0.01f, 0.01f, 8 },
+    };
+    const size_t PayloadSize = 32;
+
+    for (const Scenario& scenario : Scenarios)
+    {
+        LinkImpairments impairments;
+        impairments.lossProbability = scenario.loss;
+        impairments.corruptionProbability = scenario.corruption;
+        impairments.duplicationProbability = scenario.duplication;
+        impairments.reorderProbability = scenario.reorder;
+        impairments.reorderDelay_us = 0; // only order changes, don't wait
+        impairments.maxFragmentSize = scenario.maxFragmentSize;
+        impairments.seed = 12345;
+
+        // goodput: only correctly received frames are counted
+        auto streamFixture = std::make_shared<StreamRoundTrip>(PayloadSize, impairments);
+        suite.addCounted(std::string("impaired_streamcomm_") + scenario.name + "/" + std::to_string(PayloadSize), PayloadSize, [=]() {
+            return streamFixture->run();
+        });
+
+        auto frameFixture = std::make_shared<FrameRoundTrip>(PayloadSize, impairments);
+        suite.addCounted(std::string("impaired_loopbackcomm_") + scenario.name + "/" + std::to_string(PayloadSize), PayloadSize, [=]() {
+            return frameFixture->run();
+        });
+    }
+}
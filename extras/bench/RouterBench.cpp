@@ -0,0 +1,181 @@
+/**
+ * @file RouterBench.cpp
+ * @author Jan Wielgus
+ * @brief Relay between two StreamComm links: PacketCommunication that updates
+ * the registered packet and sends it again compared with PacketRouter
+ * (cut-through forwarding with the reused checksum, also with the hop limit).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "PacketRouter.h"
+#include "HopLimitComm.h"
+#include "LoopbackComm.h"
+#include "StreamComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 300;
+    const size_t FramesPerCall = 16;
+    const Packet::PacketIDType FrameID = 40;
+
+    typedef StreamComm<MaxBufferSize, LoopbackStream> LinkComm;
+
+
+    /**
+     * @brief source -> (first link) -> relay -> (second link) -> sink
+     */
+    struct RelayFixture
+    {
+        LoopbackStreamPair firstLink;
+        LoopbackStreamPair secondLink;
+        LinkComm source;
+        LinkComm relayInput;
+        LinkComm relayOutput;
+        LinkComm sink;
+        std::vector<uint8_t> frame;
+
+        explicit RelayFixture(size_t payloadSize)
+            : source(&firstLink.getEndpointA()),
+              relayInput(&firstLink.getEndpointB()),
+              relayOutput(&secondLink.getEndpointA()),
+              sink(&secondLink.getEndpointB()),
+              frame(makeFrame(FrameID, payloadSize, 7))
+        {
+        }
+
+        void sendFrames(ITransmitter& transmitter)
+        {
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                transmitter.send(frame.data(), frame.size());
+        }
+
+        size_t receiveFrames(IReceiver& receiver)
+        {
+            DataBuffer batch[PACKETCOMM_RECEIVE_BATCH_SIZE];
+            size_t received = 0;
+            size_t count;
+            while ((count = receiver.receiveBatch(batch, PACKETCOMM_RECEIVE_BATCH_SIZE)) > 0)
+                received += count;
+            return received;
+        }
+    };
+
+
+    /**
+     * @brief Relay made of PacketCommunication instances (packet updated and serialized again).
+     */
+    struct ReserializeFixture : RelayFixture
+    {
+        std::vector<uint8_t> relayPayload;
+        DataPacket relayPacket;
+        PacketCommunication relayReceiving;
+        PacketCommunication relaySending;
+
+        static ReserializeFixture* active; // packet callback has no context
+
+        explicit ReserializeFixture(size_t payloadSize)
+            : RelayFixture(payloadSize),
+              relayPayload(payloadSize),
+              relayPacket(FrameID, relayPayload.data(), payloadSize, onRelayPacket),
+              relayReceiving(&relayInput),
+              relaySending(&relayOutput)
+        {
+            relayReceiving.registerReceivePacket(&relayPacket);
+        }
+
+        size_t run()
+        {
+            active = this;
+            sendFrames(source);
+            relayReceiving.receive();
+            return receiveFrames(sink);
+        }
+
+        static void onRelayPacket()
+        {
+            active->relaySending.send(&active->relayPacket);
+        }
+    };
+
+    ReserializeFixture* ReserializeFixture::active = nullptr;
+
+
+    struct CutThroughFixture : RelayFixture
+    {
+        PacketRouter router;
+
+        explicit CutThroughFixture(size_t payloadSize)
+            : RelayFixture(payloadSize)
+        {
+            router.addInput(&relayInput);
+            router.addRoute(FrameID, FrameID, &relayOutput);
+        }
+
+        size_t run()
+        {
+            sendFrames(source);
+            router.route();
+            return receiveFrames(sink);
+        }
+    };
+
+
+    struct HopLimitFixture : RelayFixture
+    {
+        HopLimitComm sourceHops;
+        HopLimitComm sinkHops;
+        PacketRouter router;
+
+        explicit HopLimitFixture(size_t payloadSize)
+            : RelayFixture(payloadSize),
+              sourceHops(&source, 4),
+              sinkHops(&sink, 4),
+              router(true)
+        {
+            router.addInput(&relayInput);
+            router.addRoute(FrameID, FrameID, &relayOutput);
+        }
+
+        size_t run()
+        {
+            sendFrames(sourceHops);
+            router.route();
+            return receiveFrames(sinkHops);
+        }
+    };
+}
+
+
+void Bench::registerRouterBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 32, 250 };
+
+    for (size_t size : PayloadSizes)
+    {
+        const std::string Suffix = "/" + std::to_string(size);
+
+        auto reserialize = std::make_shared<ReserializeFixture>(size);
+        suite.addCounted("relay_reserialize" + Suffix, size, [=]() {
+            return reserialize->run();
+        });
+
+        auto cutThrough = std::make_shared<CutThroughFixture>(size);
+        suite.addCounted("relay_cut_through" + Suffix, size, [=]() {
+            return cutThrough->run();
+        });
+
+        auto hopLimit = std::make_shared<HopLimitFixture>(size);
+        suite.addCounted("relay_cut_through_hoplimit" + Suffix, size, [=]() {
+            return hopLimit->run();
+        });
+    }
+}
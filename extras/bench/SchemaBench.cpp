@@ -0,0 +1,179 @@
+/**
+ * @file SchemaBench.cpp
+ * @author Jan Wielgus
+ * @brief Serialization of packets generated from BenchPackets.packets
+ * (explicit little-endian fields) compared with DataPacket over a packed struct
+ * of the same layout (memcpy, layout depends on the platform), and the telemetry
+ * encoded by bit-packed, quantized and varint fields (CompactTelemetryPacket).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "BenchPackets.h"
+#include "PacketCommunication.h"
+#include "LoopbackComm.h"
+#include "StreamComm.h"
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    struct __attribute__((packed)) TelemetryStruct
+    {
+        uint32_t timestamp;
+        int16_t acceleration[3];
+        int16_t rotation[3];
+        float altitude;
+        float temperature;
+        uint8_t flags;
+        bool armed;
+    };
+
+    struct __attribute__((packed)) WaypointsStruct
+    {
+        int32_t latitude[16];
+        int32_t longitude[16];
+        uint16_t altitude[16];
+        uint8_t name[16];
+    };
+
+    static_assert(sizeof(TelemetryStruct) == BenchPackets::TelemetryPacket::DataSize, "Layouts differ");
+    static_assert(sizeof(WaypointsStruct) == BenchPackets::WaypointsPacket::DataSize, "Layouts differ");
+
+
+    template <class GeneratedPacket, class Struct>
+    struct SchemaFixture
+    {
+        GeneratedPacket generated;
+        Struct data;
+        DataPacket structPacket;
+        std::vector<uint8_t> buffer;
+
+        SchemaFixture()
+            : structPacket(GeneratedPacket::ID, (uint8_t*)&data, sizeof(Struct)),
+              buffer(generated.getSize())
+        {
+            std::vector<uint8_t> payload = makePayload(buffer.size(), 3);
+            memcpy(buffer.data(), payload.data(), buffer.size());
+            structPacket.getBuffer(buffer.data()); // valid ID
+            generated.updatePacketBuffer(buffer.data());
+        }
+    };
+
+
+    template <class GeneratedPacket, class Struct>
+    void addSchemaBenchmarks(Suite& suite, const std::string& name)
+    {
+        auto fixture = std::make_shared<SchemaFixture<GeneratedPacket, Struct>>();
+        size_t size = GeneratedPacket::DataSize;
+
+        suite.add("schema_getBuffer/" + name, 1, size, [=]() {
+            doNotOptimize(fixture->generated.getBuffer(fixture->buffer.data()));
+            clobberMemory();
+        });
+        suite.add("schema_updatePacketBuffer/" + name, 1, size, [=]() {
+            doNotOptimize(fixture->generated.updatePacketBuffer(fixture->buffer.data()));
+            clobberMemory();
+        });
+        suite.add("struct_getBuffer/" + name, 1, size, [=]() {
+            doNotOptimize(fixture->structPacket.getBuffer(fixture->buffer.data()));
+            clobberMemory();
+        });
+        suite.add("struct_updatePacketBuffer/" + name, 1, size, [=]() {
+            doNotOptimize(fixture->structPacket.updatePacketBuffer(fixture->buffer.data()));
+            clobberMemory();
+        });
+    }
+
+
+    /**
+     * @brief Telemetry encoded by CompactTelemetryPacket (its data size and the size
+     * of TelemetryPacket are in the name).
+     */
+    void addCompactBenchmarks(Suite& suite)
+    {
+        auto packet = std::make_shared<BenchPackets::CompactTelemetryPacket>();
+        for (size_t i = 0; i < 3; ++i)
+        {
+            packet->acceleration[i] = (int16_t)(i * 300 - 400);
+            packet->rotation[i] = (int16_t)(i * 50 - 50);
+        }
+        packet->altitude = 123.4f;
+        packet->temperature = 21.5f;
+        packet->flags = 5;
+        packet->armed = true;
+        packet->mode = BenchPackets::FlightMode::FLYING;
+        packet->timestamp = 3600000;
+
+        auto buffer = std::make_shared<std::vector<uint8_t>>(packet->getSize());
+        packet->getBuffer(buffer->data());
+        size_t size = packet->getSize() - packet->getHeaderSize();
+        std::string name = "compact_telemetry_" + std::to_string(size) + "B_vs_"
+            + std::to_string(BenchPackets::TelemetryPacket::DataSize) + "B";
+
+        suite.add("schema_getBuffer/" + name, 1, size, [=]() {
+            doNotOptimize(packet->getBuffer(buffer->data()));
+            clobberMemory();
+        });
+        suite.add("schema_updatePacketBuffer/" + name, 1, size, [=]() {
+            doNotOptimize(packet->updatePacketBuffer(buffer->data()));
+            clobberMemory();
+        });
+    }
+}
+
+
+#if PACKETCOMM_HEADER_SEQUENCE
+namespace
+{
+    /**
+     * @brief Host check: generated packets sent by StreamComm (scatter-gather sending
+     * is tried first) are received with consecutive sequence numbers.
+     */
+    bool checkConsecutiveSequences()
+    {
+        LoopbackStreamPair link;
+        StreamComm<300, LoopbackStream> senderStream(&link.getEndpointA());
+        StreamComm<300, LoopbackStream> receiverStream(&link.getEndpointB());
+        PacketCommunication sender(&senderStream);
+        PacketCommunication receiver(&receiverStream);
+        BenchPackets::TelemetryPacket sent;
+        BenchPackets::TelemetryPacket received;
+        receiver.registerReceivePacket(&received);
+
+        for (size_t i = 0; i < 300; ++i) // sequence numbers wrap around
+        {
+            uint8_t previous = received.getSequence();
+            if (!sender.send(&sent))
+                return false;
+            receiver.receive();
+            if (received.getSequence() != sent.getSequence() || (i > 0 && received.getSequence() != (uint8_t)(previous + 1)))
+                return false;
+        }
+        return true;
+    }
+}
+#endif
+
+
+void Bench::registerSchemaBenchmarks(Suite& suite)
+{
+#if PACKETCOMM_HEADER_SEQUENCE
+    if (!checkConsecutiveSequences())
+    {
+        fprintf(stderr, "generated packets were received with a gap in sequence numbers\n");
+        exit(1);
+    }
+#endif
+
+    addSchemaBenchmarks<BenchPackets::TelemetryPacket, TelemetryStruct>(suite, "telemetry");
+    addSchemaBenchmarks<BenchPackets::WaypointsPacket, WaypointsStruct>(suite, "waypoints");
+    addCompactBenchmarks(suite);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file SendPartsBench.cpp
+ * @author Jan Wielgus
+ * @brief StreamComm send of a DataPacket: packet serialized to a frame buffer
+ * (PacketCommunication path without sendParts) compared with the packet
+ * passed as ID + payload parts (ITransmitter::sendParts()).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "StreamComm.h"
+#include <memory>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 2048;
+
+
+    /**
+     * @brief Stream that drops everything written to it.
+     */
+    class NullStream : public Stream
+    {
+    public:
+        size_t write(uint8_t data) override
+        {
+            doNotOptimize(data);
+            return 1;
+        }
+
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            doNotOptimize(buffer[size - 1]);
+            return size;
+        }
+
+        int available() override { return 0; }
+        int read() override { return -1; }
+        int peek() override { return -1; }
+    };
+
+
+    struct SendFixture
+    {
+        NullStream stream;
+        StreamComm<MaxBufferSize> lowLevel;
+        std::vector<uint8_t> payload;
+        DataPacket packet;
+        std::vector<uint8_t> frameStorage;
+
+        explicit SendFixture(size_t payloadSize)
+            : lowLevel(&stream),
+              payload(makePayload(payloadSize, 15)),
+              packet(41, payload.data(), payloadSize),
+              frameStorage(PACKETCOMM_FRAME_HEADROOM + packet.getSize() + PACKETCOMM_FRAME_TAILROOM)
+        {
+        }
+
+        void sendCopied()
+        {
+            FrameBuffer frame(frameStorage.data(), frameStorage.size(), PACKETCOMM_FRAME_HEADROOM);
+            packet.getBuffer(frame.pushBack(packet.getSize()));
+            lowLevel.sendFrame(frame);
+        }
+
+        void sendParts()
+        {
+            uint8_t headerBuffer[Packet::MaxHeaderSize];
+            DataBuffer parts[2];
+            size_t partsAmount = packet.getBufferParts(headerBuffer, parts);
+            lowLevel.sendParts(parts, partsAmount);
+        }
+    };
+}
+
+
+void Bench::registerSendPartsBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 32, 250, 1024 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<SendFixture>(size);
+
+        suite.add("streamcomm_send_copied/" + std::to_string(size), 1, size, [=]() {
+            fixture->sendCopied();
+        });
+
+        suite.add("streamcomm_send_parts/" + std::to_string(size), 1, size, [=]() {
+            fixture->sendParts();
+        });
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file SerialBench.cpp
+ * @author Jan Wielgus
+ * @brief LinuxSerialComm round trip over a pseudo terminal pair.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "LinuxSerialComm.h"
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 2048;
+    const size_t FramesPerCall = 16;
+    size_t receivedCounter = 0;
+
+    void onReceive()
+    {
+        receivedCounter++;
+    }
+
+
+    struct PtyRoundTrip
+    {
+        int masterFd = -1;
+        LinuxSerialComm<MaxBufferSize> masterSide;
+        LinuxSerialComm<MaxBufferSize> slaveSide;
+        PacketCommunication sender;
+        PacketCommunication receiver;
+        std::vector<uint8_t> sendPayload;
+        std::vector<uint8_t> receivePayload;
+        DataPacket sendPacket;
+        DataPacket receivePacket;
+
+        explicit PtyRoundTrip(size_t payloadSize)
+            : sender(&masterSide),
+              receiver(&slaveSide),
+              sendPayload(makePayload(payloadSize, 4)),
+              receivePayload(payloadSize),
+              sendPacket(30, sendPayload.data(), payloadSize),
+              receivePacket(30, receivePayload.data(), payloadSize, onReceive)
+        {
+            receiver.registerReceivePacket(&receivePacket);
+
+            masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+            if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+                return;
+
+            SerialConfig config;
+            config.baudRate = 4000000;
+            masterSide.adopt(masterFd, config);
+            slaveSide.open(ptsname(masterFd), config);
+        }
+
+        ~PtyRoundTrip()
+        {
+            masterSide.close();
+            slaveSide.close();
+            if (masterFd >= 0)
+                ::close(masterFd);
+        }
+
+        bool isReady() const
+        {
+            return masterSide.isOpen() && slaveSide.isOpen();
+        }
+
+        size_t run()
+        {
+            size_t receivedBefore = receivedCounter;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                sender.send(&sendPacket);
+
+            // pty delivers bytes asynchronously, wait for them (at most ~10ms)
+            for (int attempt = 0; attempt < 100 && receivedCounter - receivedBefore < FramesPerCall; ++attempt)
+            {
+                receiver.receive();
+                if (receivedCounter - receivedBefore < FramesPerCall)
+                {
+                    pollfd pfd = { slaveSide.getFileDescriptor(), POLLIN, 0 };
+                    ::poll(&pfd, 1, 1);
+                }
+            }
+
+            return receivedCounter - receivedBefore;
+        }
+    };
+}
+
+
+void Bench::registerSerialBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 4, 32, 250 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<PtyRoundTrip>(size);
+        if (!fixture->isReady())
+        {
+            fprintf(stderr, "pseudo terminal is not available, skipping serial benchmarks\n");
+            return;
+        }
+
+        suite.addCounted("roundtrip_linuxserial_pty/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+}
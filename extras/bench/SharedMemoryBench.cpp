@@ -0,0 +1,173 @@
+/**
+ * @file SharedMemoryBench.cpp
+ * @author Jan Wielgus
+ * @brief SharedMemoryComm benchmarks: round trip with PacketCommunication
+ * on both sides (zero-copy path) and ping-pong between two threads
+ * (sleeping consumer woken up by the futex).
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "DataPacket.h"
+#include "PacketCommunication.h"
+#include "SharedMemoryComm.h"
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t RingCapacity = 1 << 20;
+    const size_t FramesPerCall = 16;
+    size_t receivedCounter = 0;
+    int segmentCounter = 0;
+
+    void onReceive()
+    {
+        receivedCounter++;
+    }
+
+
+    /**
+     * @brief Create connected pair of SharedMemoryComm (segment name is removed
+     * immediately, memory lives as long as both sides are open).
+     */
+    bool connectPair(SharedMemoryComm& sideA, SharedMemoryComm& sideB)
+    {
+        std::string name = "/packetcomm_bench_" + std::to_string(getpid()) + "_" + std::to_string(segmentCounter++);
+        bool result = sideA.create(name.c_str(), RingCapacity) && sideB.open(name.c_str());
+        SharedMemoryComm::unlink(name.c_str());
+        return result;
+    }
+
+
+    struct SharedMemoryRoundTrip
+    {
+        SharedMemoryComm senderLowLevel;
+        SharedMemoryComm receiverLowLevel;
+        PacketCommunication sender;
+        PacketCommunication receiver;
+        std::vector<uint8_t> sendPayload;
+        std::vector<uint8_t> receivePayload;
+        DataPacket sendPacket;
+        DataPacket receivePacket;
+        bool ready;
+
+        explicit SharedMemoryRoundTrip(size_t payloadSize)
+            : sender(&senderLowLevel),
+              receiver(&receiverLowLevel),
+              sendPayload(makePayload(payloadSize, 6)),
+              receivePayload(payloadSize),
+              sendPacket(40, sendPayload.data(), payloadSize),
+              receivePacket(40, receivePayload.data(), payloadSize, onReceive)
+        {
+            receiver.registerReceivePacket(&receivePacket);
+            ready = connectPair(senderLowLevel, receiverLowLevel);
+        }
+
+        size_t run()
+        {
+            size_t receivedBefore = receivedCounter;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+                sender.send(&sendPacket);
+            receiver.receive();
+            return receivedCounter - receivedBefore;
+        }
+    };
+
+
+    /**
+     * @brief Echo thread sleeps in waitForData() and sends back every frame.
+     * Each frame is sent after the echo of the previous one, so this measures
+     * one-way latency including the wake-up of the sleeping thread.
+     */
+    struct SharedMemoryPingPong
+    {
+        SharedMemoryComm local;
+        SharedMemoryComm remote;
+        std::vector<uint8_t> payload;
+        std::atomic<bool> running;
+        std::thread echoThread;
+        bool ready;
+
+        explicit SharedMemoryPingPong(size_t payloadSize)
+            : payload(makePayload(payloadSize, 7)),
+              running(true)
+        {
+            ready = connectPair(local, remote);
+            if (ready)
+                echoThread = std::thread([this]() { echo(); });
+        }
+
+        ~SharedMemoryPingPong()
+        {
+            running = false;
+            if (echoThread.joinable())
+                echoThread.join();
+        }
+
+        void echo()
+        {
+            while (running.load(std::memory_order_relaxed))
+            {
+                if (!remote.waitForData(10))
+                    continue;
+                while (remote.receive())
+                {
+                    DataBuffer received = remote.getReceived();
+                    remote.send(received.buffer, received.size);
+                }
+            }
+        }
+
+        size_t run()
+        {
+            size_t echoes = 0;
+            for (size_t i = 0; i < FramesPerCall; ++i)
+            {
+                if (!local.send(payload.data(), payload.size()))
+                    break;
+                while (!local.receive())
+                    if (!local.waitForData(100))
+                        return echoes;
+                echoes++;
+            }
+            return echoes;
+        }
+    };
+}
+
+
+void Bench::registerSharedMemoryBenchmarks(Suite& suite)
+{
+    const size_t PayloadSizes[] = { 4, 32, 250, 1024 };
+
+    for (size_t size : PayloadSizes)
+    {
+        auto fixture = std::make_shared<SharedMemoryRoundTrip>(size);
+        if (!fixture->ready)
+        {
+            fprintf(stderr, "shared memory is not available, skipping shared memory benchmarks\n");
+            return;
+        }
+
+        suite.addCounted("roundtrip_sharedmemory/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+
+    for (size_t size : { (size_t)32, (size_t)1024 })
+    {
+        auto fixture = std::make_shared<SharedMemoryPingPong>(size);
+        suite.addCounted("pingpong_sharedmemory_threads/" + std::to_string(size), size, [=]() {
+            return fixture->run();
+        });
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file UDPBench.cpp
+ * @author Jan Wielgus
+ * @brief LinuxUDPComm benchmarks over the loopback interface:
+ * aggregator that echoes datagrams of many peers, with and without batching.
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include "BenchData.h"
+#include "LinuxUDPComm.h"
+#include <memory>
+#include <stdio.h>
+
+using namespace Bench;
+using namespace PacketComm;
+
+
+namespace
+{
+    struct EchoAggregator
+    {
+        LinuxUDPComm aggregator;
+        std::vector<std::unique_ptr<LinuxUDPComm>> nodes;
+        std::vector<uint8_t> payload;
+        bool ready = false;
+
+        EchoAggregator(size_t nodesAmount, size_t payloadSize, bool batching)
+            : aggregator(1472, 64),
+              payload(makePayload(payloadSize, 5))
+        {
+            if (!aggregator.begin(0, "127.0.0.1"))
+                return;
+            aggregator.setSendBatching(batching);
+            aggregator.setReceiveBufferSize(4 * 1024 * 1024);
+            uint16_t aggregatorPort = aggregator.getLocalPort();
+
+            for (size_t i = 0; i < nodesAmount; ++i)
+            {
+                nodes.emplace_back(new LinuxUDPComm(1472, 4));
+                if (!nodes.back()->begin(0, "127.0.0.1"))
+                    return;
+                nodes.back()->setTargetPeer(nodes.back()->addPeer("127.0.0.1", aggregatorPort));
+                nodes.back()->setSendBatching(false);
+                nodes.back()->setReceiveBufferSize(64 * 1024);
+            }
+            ready = true;
+        }
+
+        /**
+         * @return Amount of echoes received by nodes.
+         * Datagrams sent over the loopback interface are delivered
+         * before send returns, so there is no need to wait for them.
+         */
+        size_t run()
+        {
+            for (auto& node : nodes)
+                node->send(payload.data(), payload.size());
+
+            while (aggregator.receive())
+            {
+                DataBuffer received = aggregator.getReceived();
+                aggregator.send(received.buffer, received.size); // to the sender
+            }
+            aggregator.flush();
+
+            size_t received = 0;
+            for (auto& node : nodes)
+                while (node->receive())
+                    received++;
+
+            return received;
+        }
+    };
+}
+
+
+void Bench::registerUDPBenchmarks(Suite& suite)
+{
+    const size_t NodesAmounts[] = { 16, 300 };
+    const size_t PayloadSize = 32;
+
+    for (size_t nodes : NodesAmounts)
+    {
+        for (bool batching : { false, true })
+        {
+            auto fixture = std::make_shared<EchoAggregator>(nodes, PayloadSize, batching);
+            if (!fixture->ready)
+            {
+                fprintf(stderr, "UDP sockets are not available, skipping UDP benchmarks\n");
+                return;
+            }
+
+            std::string name = std::string("udp_echo_aggregator_") + (batching ? "batched" : "unbatched")
+                + "/" + std::to_string(nodes) + "nodes";
+            suite.addCounted(name, PayloadSize, [=]() {
+                return fixture->run();
+            });
+        }
+    }
+}
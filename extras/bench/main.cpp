@@ -0,0 +1,129 @@
+/**
+ * @file main.cpp
+ * @author Jan Wielgus
+ * @brief Host microbenchmarks of the library.
+ * Usage: packetcomm_bench [name filter] [--min-time seconds]
+ * @date 2026-10-19
+ */
+
+#include "Benchmark.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Bench;
+
+
+std::vector<Result> Suite::run(const std::string& filter, double minTime_s) const
+{
+    typedef std::chrono::steady_clock Clock;
+    std::vector<Result> results;
+
+    for (const Case& c : cases)
+    {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos)
+            continue;
+
+        // warm up and calibrate amount of calls
+        size_t calls = 1;
+        double elapsed_s = 0;
+        double frames = 0;
+        double cycles = 0;
+        while (true)
+        {
+            frames = 0;
+            auto start = Clock::now();
+            uint64_t startCycles = readCycleCounter();
+            for (size_t i = 0; i < calls; ++i)
+                frames += c.body();
+            cycles = (double)(readCycleCounter() - startCycles);
+            elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+            if (elapsed_s >= minTime_s)
+                break;
+
+            double factor = elapsed_s > 0 ? (minTime_s * 1.2 / elapsed_s) : 10.0;
+            factor = factor > 10.0 ? 10.0 : (factor < 2.0 ? 2.0 : factor);
+            calls = (size_t)(calls * factor);
+        }
+
+        Result result;
+        result.name = c.name;
+        result.nsPerFrame = frames > 0 ? elapsed_s * 1e9 / frames : 0;
+        result.cyclesPerFrame = frames > 0 ? cycles / frames : 0;
+        result.framesPerSecond = frames / elapsed_s;
+        result.megabytesPerSecond = c.bytesPerFrame ? frames * c.bytesPerFrame / elapsed_s / 1e6 : 0;
+
+        printResult(result);
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+
+void Suite::printResult(const Result& result)
+{
+    if (result.framesPerSecond == 0)
+    {
+        printf("%-48s %21s\n", result.name.c_str(), "no frames processed");
+        fflush(stdout);
+        return;
+    }
+
+    printf("%-48s %12.1f ns/frame", result.name.c_str(), result.nsPerFrame);
+    if (result.cyclesPerFrame > 0)
+        printf(" %12.0f cycles/frame", result.cyclesPerFrame);
+    printf(" %14.0f frames/s", result.framesPerSecond);
+    if (result.megabytesPerSecond > 0)
+        printf(" %10.1f MB/s", result.megabytesPerSecond);
+    printf("\n");
+    fflush(stdout);
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    double minTime_s = 0.2;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            minTime_s = atof(argv[++i]);
+        else
+            filter = argv[i];
+    }
+
+    Suite suite;
+    registerCodecBenchmarks(suite);
+    registerPacketBenchmarks(suite);
+    registerRoundTripBenchmarks(suite);
+    registerImpairedLinkBenchmarks(suite);
+    registerSerialBenchmarks(suite);
+    registerUDPBenchmarks(suite);
+    registerSharedMemoryBenchmarks(suite);
+    registerEventLoopBenchmarks(suite);
+    registerGatewayBenchmarks(suite);
+    registerConcurrentBenchmarks(suite);
+    registerDevirtualizedBenchmarks(suite);
+    registerBufferBenchmarks(suite);
+    registerSendPartsBenchmarks(suite);
+    registerBroadcastBenchmarks(suite);
+    registerBondingBenchmarks(suite);
+    registerRouterBenchmarks(suite);
+    registerReplayBenchmarks(suite);
+    registerCompressionBenchmarks(suite);
+    registerBackpressureBenchmarks(suite);
+#if PACKETCOMM_BENCH_SCHEMA
+    registerSchemaBenchmarks(suite);
+#endif
+#if PACKETCOMM_BENCH_COROUTINES
+    registerAsyncBenchmarks(suite);
+#endif
+
+    suite.run(filter, minTime_s);
+    return 0;
+}
@@ -0,0 +1,608 @@
+#!/usr/bin/env python3
+"""
+@file packetgen.py
+@author Jan Wielgus
+@brief Generates Packet subclasses with explicit little-endian serializers
+from a packet schema, so AVR, ESP and x86 peers agree on the layout.
+@date 2026-10-19
+
+Schema format (// comments):
+
+    namespace Telemetry;            // optional C++ namespace of generated packets
+
+    enum FlightMode { IDLE, ARMED, FLYING }
+
+    packet ImuPacket 51 {           // class name and packet ID
+        uint32 timestamp;
+        int16 acceleration[3];      // fixed size arrays
+        float temperature;
+        bool calibrated;
+    }
+
+    packet StatePacket 53 {         // compact encodings for slow links
+        float altitude : quantized(-100, 5000, 0.1);  // min, max, resolution
+        float heading : quantized(0, 360, 0.5);
+        bool armed : bits;
+        uint8 satellites : bits(5);
+        int16 climbRate : bits(10);
+        FlightMode mode;            // enums are always bit-packed
+        int32 deltaTime : varint;   // zig-zag varint for signed types
+    }
+
+    packet PingPacket 52 {}         // packet without data
+
+Field types: uint8, uint16, uint32, uint64, int8, int16, int32, int64, float, bool
+and declared enums (no double, it has only 4 bytes on AVR).
+
+Field encodings:
+    (none)                  little-endian, whole bytes
+    bits, bits(N)           N bits (bool: 1), integers are saturated to N bits
+    quantized(min, max, r)  float as an integer of the smallest width with resolution r
+                            (at most 24 bits), saturated to [min, max]
+    varint                  1..5 bytes, 7 bits per byte (zig-zag for signed types, up to 32 bits)
+
+Layout: bit-packed fields first (LSB first, in schema order), then byte fields
+at fixed offsets, varint fields last. Sizes and offsets are computed by the generator,
+only packets with varint fields have variable size (MinDataSize..MaxDataSize).
+
+Each packet has SchemaHash (FNV-1a of its ID and layout, field names are not included)
+and the namespace has SchemaHash of all packets (<file name>SchemaHash
+if there is no namespace), send them to check
+if both sides were generated from a compatible schema.
+
+Packet IDs have to fit PACKETCOMM_HEADER_ID_SIZE (--id-size, the generated header
+checks it at compile time) without its highest bit, which is the CompressedFlag
+of CompressionComm (eg. IDs 0..127 for 1-byte IDs, 0..32767 for 2-byte and varint IDs).
+
+Usage:
+    packetgen.py schema.packets -o GeneratedPackets.h [--id-size 1]
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+
+FieldTypes = {
+    # schema type: (C++ type, size, LittleEndian method suffix)
+    "uint8": ("uint8_t", 1, "UInt8"),
+    "uint16": ("uint16_t", 2, "UInt16"),
+    "uint32": ("uint32_t", 4, "UInt32"),
+    "uint64": ("uint64_t", 8, "UInt64"),
+    "int8": ("int8_t", 1, "Int8"),
+    "int16": ("int16_t", 2, "Int16"),
+    "int32": ("int32_t", 4, "Int32"),
+    "int64": ("int64_t", 8, "Int64"),
+    "float": ("float", 4, "Float"),
+    "bool": ("bool", 1, "Bool"),
+}
+
+IDSizes = (0, 1, 2, 4) # PACKETCOMM_HEADER_ID_SIZE, 0 - varint ID (Packet::PacketIDType is uint16_t)
+DefaultIDSize = 2
+MaxQuantizedBits = 24 # float mantissa
+MaxVarintSize = 5
+
+Identifier = r"[A-Za-z_][A-Za-z0-9_]*"
+Number = r"[-+]?[0-9.]+(?:[eE][-+]?[0-9]+)?"
+NamespaceRegex = re.compile(r"namespace\s+(%s(?:::%s)*)\s*;" % (Identifier, Identifier))
+EnumRegex = re.compile(r"enum\s+(%s)\s*\{([^{}]*)\}" % Identifier)
+PacketRegex = re.compile(r"packet\s+(%s)\s+(\w+)\s*\{([^{}]*)\}" % Identifier)
+FieldRegex = re.compile(r"^(\w+)\s+(%s)\s*(?:\[\s*(\w+)\s*\])?\s*(?::\s*(.+))?$" % Identifier)
+BitsRegex = re.compile(r"^bits\s*(?:\(\s*(\w+)\s*\))?$")
+QuantizedRegex = re.compile(r"^quantized\s*\(\s*(%s)\s*,\s*(%s)\s*,\s*(%s)\s*\)$" % (Number, Number, Number))
+
+
+class SchemaError(Exception):
+    pass
+
+
+class Field:
+    # encodings
+    BYTES = "bytes"
+    BITS = "bits"
+    QUANTIZED = "quantized"
+    VARINT = "varint"
+
+    def __init__(self, typeName, name, count, enumValues=None):
+        self.typeName = typeName
+        self.name = name
+        self.count = count # 0 - not an array
+        self.enumValues = enumValues # None - not an enum
+        if enumValues is None:
+            self.cppType, self.typeSize, self.method = FieldTypes[typeName]
+        else:
+            self.cppType, self.typeSize, self.method = typeName, 1, None
+        self.encoding = Field.BYTES
+        self.bits = 0 # width of one value (BITS and QUANTIZED)
+        self.minimum = 0.0 # QUANTIZED range
+        self.maximum = 0.0
+        self.offset = 0 # in bytes (BYTES) or bits (BITS and QUANTIZED)
+
+    def isSigned(self):
+        return self.typeName.startswith("int")
+
+    def getValuesAmount(self):
+        return max(self.count, 1)
+
+    def getSize(self):
+        return self.typeSize * self.getValuesAmount()
+
+    def getLayout(self):
+        layout = "%s[%d]" % ("enum%d" % len(self.enumValues) if self.enumValues else self.typeName, self.count)
+        if self.encoding == Field.BITS:
+            layout += "@b%d" % self.bits
+        elif self.encoding == Field.QUANTIZED:
+            layout += "@q(%r,%r,%d)" % (self.minimum, self.maximum, self.bits)
+        elif self.encoding == Field.VARINT:
+            layout += "@v"
+        return layout
+
+
+class PacketSchema:
+    def __init__(self, name, packetID, fields):
+        self.name = name
+        self.packetID = packetID
+        self.fields = fields
+
+        self.bitFields = [field for field in fields if field.encoding in (Field.BITS, Field.QUANTIZED)]
+        self.byteFields = [field for field in fields if field.encoding == Field.BYTES]
+        self.varintFields = [field for field in fields if field.encoding == Field.VARINT]
+
+        bitOffset = 0
+        for field in self.bitFields:
+            field.offset = bitOffset
+            bitOffset += field.bits * field.getValuesAmount()
+
+        self.bitDataSize = (bitOffset + 7) // 8
+        offset = self.bitDataSize
+        for field in self.byteFields:
+            field.offset = offset
+            offset += field.getSize()
+
+        self.fixedDataSize = offset
+        self.minDataSize = offset + sum(field.getValuesAmount() for field in self.varintFields)
+        self.maxDataSize = offset + sum(MaxVarintSize * field.getValuesAmount() for field in self.varintFields)
+
+    def isSizeVariable(self):
+        return len(self.varintFields) > 0
+
+    def getLayout(self):
+        """Wire layout used for the schema hash."""
+        fields = ",".join(field.getLayout() for field in self.fields)
+        return "%d:%s" % (self.packetID, fields)
+
+
+def fnv1a(text, hashValue=0x811C9DC5):
+    for byte in text.encode("ascii"):
+        hashValue ^= byte
+        hashValue = (hashValue * 0x01000193) & 0xFFFFFFFF
+    return hashValue
+
+
+def parseInteger(text, what):
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise SchemaError("invalid %s: %s" % (what, text))
+
+
+def parseEncoding(field, encoding, where):
+    bitsMatch = BitsRegex.match(encoding)
+    quantizedMatch = QuantizedRegex.match(encoding)
+
+    if encoding == "varint":
+        if field.typeName not in ("uint8", "uint16", "uint32", "int8", "int16", "int32"):
+            raise SchemaError("%s: varint requires an integer type of up to 32 bits" % where)
+        field.encoding = Field.VARINT
+
+    elif bitsMatch:
+        maxBits = 32 if field.enumValues else min(field.typeSize * 8, 32)
+        if field.typeName == "float" or field.typeSize > 4:
+            raise SchemaError("%s: bits requires bool, enum or integer type of up to 32 bits" % where)
+        if bitsMatch.group(1):
+            field.bits = parseInteger(bitsMatch.group(1), "amount of bits")
+        elif field.typeName == "bool":
+            field.bits = 1
+        elif not field.enumValues:
+            raise SchemaError("%s: amount of bits is required" % where)
+        if field.enumValues and field.bits < getEnumBits(field.enumValues):
+            raise SchemaError("%s: enum needs at least %d bits" % (where, getEnumBits(field.enumValues)))
+        if not 1 <= field.bits <= maxBits or (field.typeName == "bool" and field.bits != 1):
+            raise SchemaError("%s: invalid amount of bits" % where)
+        field.encoding = Field.BITS
+
+    elif quantizedMatch:
+        if field.typeName != "float":
+            raise SchemaError("%s: quantized requires float type" % where)
+        try:
+            field.minimum, field.maximum, resolution = (float(value) for value in quantizedMatch.groups())
+        except ValueError:
+            raise SchemaError("%s: invalid quantization range" % where)
+        if not field.minimum < field.maximum or not resolution > 0:
+            raise SchemaError("%s: invalid quantization range" % where)
+        steps = math.ceil((field.maximum - field.minimum) / resolution - 1e-9)
+        field.bits = max(1, math.ceil(math.log2(steps + 1)))
+        if field.bits > MaxQuantizedBits:
+            raise SchemaError("%s: quantization needs %d bits (at most %d)" % (where, field.bits, MaxQuantizedBits))
+        field.encoding = Field.QUANTIZED
+
+    else:
+        raise SchemaError("%s: unknown encoding %s" % (where, encoding))
+
+
+def getEnumBits(values):
+    return max(1, math.ceil(math.log2(len(values))))
+
+
+def parseEnums(text):
+    enums = {}
+    for match in EnumRegex.finditer(text):
+        name = match.group(1)
+        values = [value.strip() for value in match.group(2).split(",") if value.strip()]
+        if name in enums or name in FieldTypes:
+            raise SchemaError("duplicated type %s" % name)
+        if not values or any(not re.match("^%s$" % Identifier, value) for value in values):
+            raise SchemaError("enum %s: invalid values" % name)
+        if len(set(values)) != len(values):
+            raise SchemaError("enum %s: duplicated values" % name)
+        enums[name] = values
+    return enums, EnumRegex.sub("", text)
+
+
+def getMaxPacketID(idSize):
+    bits = 16 if idSize == 0 else idSize * 8
+    return (1 << (bits - 1)) - 1 # the highest bit is CompressionComm::CompressedFlag
+
+
+def parseSchema(text, idSize=DefaultIDSize):
+    text = re.sub(r"//[^\n]*", "", text)
+
+    namespace = None
+    match = NamespaceRegex.search(text)
+    if match:
+        namespace = match.group(1)
+        text = text[:match.start()] + text[match.end():]
+
+    enums, text = parseEnums(text)
+
+    packets = []
+    position = 0
+    for match in PacketRegex.finditer(text):
+        if text[position:match.start()].strip():
+            raise SchemaError("unexpected text: %s" % text[position:match.start()].strip().split("\n")[0])
+        position = match.end()
+
+        name = match.group(1)
+        packetID = parseInteger(match.group(2), "packet ID")
+        if not 0 <= packetID <= getMaxPacketID(idSize):
+            raise SchemaError("packet %s: ID out of range 0..%d (PACKETCOMM_HEADER_ID_SIZE %d, the highest bit is reserved)"
+                              % (name, getMaxPacketID(idSize), idSize))
+
+        fields = []
+        for declaration in match.group(3).split(";"):
+            declaration = " ".join(declaration.split())
+            if not declaration:
+                continue
+
+            fieldMatch = FieldRegex.match(declaration)
+            if not fieldMatch:
+                raise SchemaError("packet %s: invalid field: %s" % (name, declaration))
+
+            typeName, fieldName, count, encoding = fieldMatch.groups()
+            where = "packet %s, field %s" % (name, fieldName)
+            if typeName not in FieldTypes and typeName not in enums:
+                raise SchemaError("%s: unknown type %s" % (where, typeName))
+            count = parseInteger(count, "array size") if count else 0
+            if fieldMatch.group(3) and count <= 0:
+                raise SchemaError("%s: invalid array size" % where)
+            if any(field.name == fieldName for field in fields):
+                raise SchemaError("%s: duplicated field" % where)
+
+            field = Field(typeName, fieldName, count, enums.get(typeName))
+            if encoding:
+                parseEncoding(field, encoding.strip(), where)
+            elif field.enumValues:
+                field.encoding = Field.BITS
+                field.bits = getEnumBits(field.enumValues)
+            fields.append(field)
+
+        packets.append(PacketSchema(name, packetID, fields))
+
+    if text[position:].strip():
+        raise SchemaError("unexpected text: %s" % text[position:].strip().split("\n")[0])
+
+    for i, packet in enumerate(packets):
+        for other in packets[:i]:
+            if packet.name == other.name:
+                raise SchemaError("duplicated packet %s" % packet.name)
+            if packet.packetID == other.packetID:
+                raise SchemaError("packets %s and %s have the same ID" % (other.name, packet.name))
+
+    return namespace, enums, packets
+
+
+def formatFloat(value):
+    return repr(float(value)) + "f"
+
+
+def generateArrayLoop(field, statement):
+    """Statement for each value (value and offset of it are in {value} and {offset})."""
+    if field.count == 0:
+        return [statement.format(value=field.name, offset=field.offset)]
+
+    step = field.bits if field.encoding in (Field.BITS, Field.QUANTIZED) else field.typeSize
+    offset = "%d + i * %d" % (field.offset, step) if field.offset else "i * %d" % step
+    return [
+        "for (size_t i = 0; i < %d; ++i)" % field.count,
+        "    " + statement.format(value=field.name + "[i]", offset=offset),
+    ]
+
+
+def generateBytesSerializer(field, writing):
+    if field.count and field.typeSize == 1 and field.typeName != "bool":
+        if writing:
+            return ["memcpy(outputBuffer + %d, %s, %d);" % (field.offset, field.name, field.count)]
+        return ["memcpy(%s, inputBuffer + %d, %d);" % (field.name, field.offset, field.count)]
+
+    if writing:
+        return generateArrayLoop(field, "PacketComm::LittleEndian::write%s(outputBuffer + {offset}, {value});" % field.method)
+    return generateArrayLoop(field, "{value} = PacketComm::LittleEndian::read%s(inputBuffer + {offset});" % field.method)
+
+
+def generateBitsSerializer(field, writing):
+    bits = field.bits
+    if field.encoding == Field.QUANTIZED:
+        arguments = "%s, %s, %d" % (formatFloat(field.minimum), formatFloat(field.maximum), bits)
+        if writing:
+            statement = "PacketComm::BitPacking::write(outputBuffer, {offset}, PacketComm::Quantization::encode({value}, %s), %d);" % (arguments, bits)
+        else:
+            statement = "{value} = PacketComm::Quantization::decode(PacketComm::BitPacking::read(inputBuffer, {offset}, %d), %s);" % (bits, arguments)
+    elif field.typeName == "bool":
+        if writing:
+            statement = "PacketComm::BitPacking::write(outputBuffer, {offset}, {value} ? 1 : 0, 1);"
+        else:
+            statement = "{value} = PacketComm::BitPacking::read(inputBuffer, {offset}, 1) != 0;"
+    elif field.isSigned():
+        if writing:
+            statement = "PacketComm::BitPacking::writeSigned(outputBuffer, {offset}, {value}, %d);" % bits
+        else:
+            statement = "{value} = (%s)PacketComm::BitPacking::readSigned(inputBuffer, {offset}, %d);" % (field.cppType, bits)
+    else:
+        if writing:
+            statement = "PacketComm::BitPacking::writeUnsigned(outputBuffer, {offset}, (uint32_t){value}, %d);" % bits
+        else:
+            statement = "{value} = (%s)PacketComm::BitPacking::read(inputBuffer, {offset}, %d);" % (field.cppType, bits)
+    return generateArrayLoop(field, statement)
+
+
+def generateVarintSerializer(field, action):
+    value = field.name + ("[i]" if field.count else "")
+    encoded = "PacketComm::ZigZag::encode(%s)" % value if field.isSigned() else value
+    if action == "size":
+        statement = "size += PacketComm::Varint::getSize(%s);" % encoded
+    elif action == "write":
+        statement = "position += PacketComm::Varint::write(position, %s);" % encoded
+    else:
+        decoded = "PacketComm::ZigZag::decode(value)" if field.isSigned() else "value"
+        statement = "position += PacketComm::Varint::read(position, value);\n%s = (%s)%s;" % (value, field.cppType, decoded)
+
+    lines = statement.split("\n")
+    if field.count == 0:
+        return lines
+    if len(lines) == 1:
+        return ["for (size_t i = 0; i < %d; ++i)" % field.count, "    " + lines[0]]
+    return ["for (size_t i = 0; i < %d; ++i)" % field.count, "{"] + ["    " + line for line in lines] + ["}"]
+
+
+def generateSerializer(field, writing):
+    if field.encoding == Field.BYTES:
+        return generateBytesSerializer(field, writing)
+    return generateBitsSerializer(field, writing)
+
+
+def generatePacket(packet, indent):
+    hashValue = fnv1a(packet.getLayout())
+    variable = packet.isSizeVariable()
+    sizeName = "FixedDataSize" if variable else "DataSize"
+    bufferName = "outputBuffer" if packet.fields else ""
+    inputName = "inputBuffer" if packet.fields else ""
+    fixedFields = packet.bitFields + packet.byteFields
+
+    lines = []
+    lines.append("/**")
+    if variable:
+        lines.append(" * @brief Packet %d (%d..%d bytes of data)." % (packet.packetID, packet.minDataSize, packet.maxDataSize))
+    else:
+        lines.append(" * @brief Packet %d (%d bytes of data)." % (packet.packetID, packet.fixedDataSize))
+    lines.append(" */")
+    lines.append("class %s : public PacketComm::Packet" % packet.name)
+    lines.append("{")
+    lines.append("public:")
+    # enums can be used by reference without out-of-class definitions (header only)
+    lines.append("    enum : PacketIDType { ID = %d };" % packet.packetID)
+    lines.append("    enum : size_t { %s = %d };" % (sizeName, packet.fixedDataSize))
+    if variable:
+        lines.append("    enum : size_t { MinDataSize = %d, MaxDataSize = %d };" % (packet.minDataSize, packet.maxDataSize))
+    lines.append("    enum : uint32_t { SchemaHash = 0x%08Xul };" % hashValue)
+    if packet.fields:
+        lines.append("")
+    for field in packet.fields:
+        array = "[%d]" % field.count if field.count else ""
+        if field.count:
+            initializer = ""
+        elif field.enumValues:
+            initializer = " = %s::%s" % (field.cppType, field.enumValues[0])
+        else:
+            initializer = " = false" if field.typeName == "bool" else " = 0"
+        lines.append("    %s %s%s%s;" % (field.cppType, field.name, array, initializer))
+    lines.append("")
+    lines.append("    explicit %s(Callback onReceiveCallback = nullptr)" % packet.name)
+    lines.append("        : Packet(ID, Type::DATA, onReceiveCallback)")
+    lines.append("    {")
+    for field in packet.fields:
+        if field.count:
+            lines.append("        memset(%s, 0, sizeof(%s));" % (field.name, field.name))
+    lines.append("    }")
+    lines.append("")
+    lines.append("")
+    lines.append("protected:")
+    lines.append("    size_t getDataOnly(uint8_t* %s) const override" % bufferName)
+    lines.append("    {")
+    if packet.bitDataSize > 0:
+        # BitPacking::write() keeps other bits, so padding of the last byte is not left uninitialized
+        lines.append("        memset(%s, 0, %d); // bit-packed fields" % (bufferName, packet.bitDataSize))
+    for field in fixedFields:
+        lines.extend("        " + line for line in generateSerializer(field, True))
+    if variable:
+        lines.append("")
+        lines.append("        uint8_t* position = outputBuffer + FixedDataSize;")
+        for field in packet.varintFields:
+            lines.extend("        " + line for line in generateVarintSerializer(field, "write"))
+        lines.append("        return position - outputBuffer;")
+    else:
+        lines.append("        return DataSize;")
+    lines.append("    }")
+    lines.append("")
+    lines.append("    size_t getDataOnlySize() const override")
+    lines.append("    {")
+    if variable:
+        lines.append("        size_t size = FixedDataSize;")
+        for field in packet.varintFields:
+            lines.extend("        " + line for line in generateVarintSerializer(field, "size"))
+        lines.append("        return size;")
+    else:
+        lines.append("        return DataSize;")
+    lines.append("    }")
+    lines.append("")
+    lines.append("    void updateDataOnly(const uint8_t* %s) override" % inputName)
+    lines.append("    {")
+    for field in fixedFields:
+        lines.extend("        " + line for line in generateSerializer(field, False))
+    if variable:
+        lines.append("")
+        lines.append("        const uint8_t* position = inputBuffer + FixedDataSize;")
+        lines.append("        uint32_t value;")
+        for field in packet.varintFields:
+            lines.extend("        " + line for line in generateVarintSerializer(field, "read"))
+    lines.append("    }")
+    if variable:
+        varintsAmount = sum(field.getValuesAmount() for field in packet.varintFields)
+        lines.append("")
+        lines.append("    bool isDataValid(const uint8_t* inputBuffer, size_t size) const override")
+        lines.append("    {")
+        lines.append("        if (size < MinDataSize || size > MaxDataSize)")
+        lines.append("            return false;")
+        lines.append("")
+        lines.append("        size_t position = FixedDataSize;")
+        lines.append("        for (size_t i = 0; i < %d; ++i)" % varintsAmount)
+        lines.append("        {")
+        lines.append("            size_t varintSize = PacketComm::Varint::getEncodedSize(inputBuffer + position, size - position);")
+        lines.append("            if (varintSize == 0)")
+        lines.append("                return false;")
+        lines.append("            position += varintSize;")
+        lines.append("        }")
+        lines.append("        return position == size;")
+        lines.append("    }")
+    lines.append("};")
+
+    return [(indent + line).rstrip() for line in lines]
+
+
+def generateEnum(name, values, indent):
+    lines = []
+    lines.append("enum class %s : uint8_t" % name)
+    lines.append("{")
+    for i, value in enumerate(values):
+        lines.append("    %s%s" % (value, "," if i + 1 < len(values) else ""))
+    lines.append("};")
+    return [indent + line for line in lines]
+
+
+def generateHeader(schemaName, outputName, namespace, enums, packets, idSize=DefaultIDSize):
+    baseName = os.path.splitext(os.path.basename(outputName))[0]
+    guard = re.sub(r"\W", "_", baseName).upper() + "_H"
+    schemaHash = 0x811C9DC5
+    for packet in sorted(packets, key=lambda packet: packet.packetID):
+        schemaHash = fnv1a(packet.getLayout() + ";", schemaHash)
+    compact = any(field.encoding != Field.BYTES for packet in packets for field in packet.fields)
+
+    lines = []
+    lines.append("/**")
+    lines.append(" * @file %s" % os.path.basename(outputName))
+    lines.append(" * @brief Packets generated from %s by extras/codegen/packetgen.py." % os.path.basename(schemaName))
+    lines.append(" * Do not edit, change the schema and generate this file again.")
+    lines.append(" */")
+    lines.append("")
+    lines.append("#ifndef %s" % guard)
+    lines.append("#define %s" % guard)
+    lines.append("")
+    lines.append("#include \"Packet.h\"")
+    lines.append("#include \"Encoding/LittleEndian.h\"")
+    if compact:
+        lines.append("#include \"Encoding/FieldCodecs.h\"")
+    lines.append("#include <stdint.h>")
+    lines.append("#include <stddef.h>")
+    lines.append("#include <string.h>")
+    lines.append("")
+    lines.append("static_assert(PACKETCOMM_HEADER_ID_SIZE == %d, \"Packets were generated for another PACKETCOMM_HEADER_ID_SIZE (see --id-size)\");" % idSize)
+    lines.append("")
+    lines.append("")
+
+    indent = ""
+    if namespace:
+        lines.append("namespace %s" % namespace)
+        lines.append("{")
+        indent = "    "
+
+    lines.append(indent + "/**")
+    lines.append(indent + " * @brief Hash of IDs and layouts of all packets (both sides should have the same).")
+    lines.append(indent + " */")
+    hashName = "SchemaHash" if namespace else baseName + "SchemaHash"
+    lines.append(indent + "const uint32_t %s = 0x%08Xul;" % (hashName, schemaHash))
+
+    for name, values in enums.items():
+        lines.append("")
+        lines.append("")
+        lines.extend(generateEnum(name, values, indent))
+
+    for packet in packets:
+        lines.append("")
+        lines.append("")
+        lines.extend(generatePacket(packet, indent))
+
+    if namespace:
+        lines.append("}")
+
+    lines.append("")
+    lines.append("")
+    lines.append("#endif")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate PacketCommunication packets from a schema.")
+    parser.add_argument("schema", help="schema file")
+    parser.add_argument("-o", "--output", help="output header (default: schema name with .h extension)")
+    parser.add_argument("--id-size", type=int, choices=IDSizes, default=DefaultIDSize,
+                        help="PACKETCOMM_HEADER_ID_SIZE of the library (default: %d)" % DefaultIDSize)
+    arguments = parser.parse_args()
+
+    output = arguments.output or os.path.splitext(arguments.schema)[0] + ".h"
+
+    try:
+        with open(arguments.schema) as schemaFile:
+            namespace, enums, packets = parseSchema(schemaFile.read(), arguments.id_size)
+    except (OSError, SchemaError) as error:
+        print("%s: %s" % (arguments.schema, error), file=sys.stderr)
+        return 1
+
+    header = generateHeader(arguments.schema, output, namespace, enums, packets, arguments.id_size)
+    with open(output, "w") as outputFile:
+        outputFile.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
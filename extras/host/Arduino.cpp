@@ -0,0 +1,40 @@
+/**
+ * @file Arduino.cpp
+ * @author Jan Wielgus
+ * @date 2026-10-19
+ */
+
+#include "Arduino.h"
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+}
+
+
+unsigned long millis()
+{
+    auto elapsed = std::chrono::steady_clock::now() - StartTime;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+
+unsigned long micros()
+{
+    auto elapsed = std::chrono::steady_clock::now() - StartTime;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
@@ -0,0 +1,99 @@
+/**
+ * @file Arduino.h
+ * @author Jan Wielgus
+ * @brief Minimal subset of the Arduino core used by this library,
+ * so that it can be compiled and benchmarked on a host machine.
+ * Only for the host build (see CMakeLists.txt in the repository root).
+ * @date 2026-10-19
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+
+template <class T, class L, class H>
+inline T constrain(T amt, L low, H high)
+{
+    return amt < low ? (T)low : (amt > high ? (T)high : amt);
+}
+
+
+
+/**
+ * @brief Base class for all byte outputs (as in Arduino core).
+ */
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t data) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size-- && write(*buffer++))
+            n++;
+        return n;
+    }
+
+    /**
+     * @return Amount of bytes that can be written without blocking.
+     */
+    virtual int availableForWrite()
+    {
+        return 0;
+    }
+
+    virtual void flush()
+    {
+    }
+};
+
+
+
+/**
+ * @brief Base class for all byte streams (as in Arduino core).
+ */
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    using Print::write;
+
+    /**
+     * @brief Read bytes that are already available (host shim never waits).
+     * @return Amount of bytes placed in the buffer.
+     */
+    virtual size_t readBytes(uint8_t* buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length)
+        {
+            int c = read();
+            if (c < 0)
+                break;
+            buffer[count++] = (uint8_t)c;
+        }
+        return count;
+    }
+};
+
+
+#endif
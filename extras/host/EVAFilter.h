@@ -0,0 +1,53 @@
+/**
+ * @file EVAFilter.h
+ * @author Jan Wielgus
+ * @brief Host build replacement of the exponentially weighted
+ * moving average filter from the Filters library.
+ * @date 2026-10-19
+ */
+
+#ifndef HOST_EVAFILTER_H
+#define HOST_EVAFILTER_H
+
+
+namespace FL
+{
+    class EVAFilter
+    {
+        float filterBeta;
+        float filteredValue = 0.f;
+
+    public:
+        /**
+         * @param filterBeta [0.0, 1.0) closer to 1 - smoother output.
+         */
+        explicit EVAFilter(float filterBeta = 0.5f)
+            : filterBeta(filterBeta)
+        {
+        }
+
+        float update(float newValue)
+        {
+            filteredValue = filterBeta * filteredValue + (1.f - filterBeta) * newValue;
+            return filteredValue;
+        }
+
+        float getFilteredValue() const
+        {
+            return filteredValue;
+        }
+
+        void setFilterBeta(float filterBeta)
+        {
+            this->filterBeta = filterBeta;
+        }
+
+        void reset()
+        {
+            filteredValue = 0.f;
+        }
+    };
+}
+
+
+#endif
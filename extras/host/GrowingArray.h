@@ -0,0 +1,96 @@
+/**
+ * @file GrowingArray.h
+ * @author Jan Wielgus
+ * @brief Host build replacement of the array from SimpleDataStructures library
+ * that grows (reallocates) when a new element doesn't fit.
+ * @date 2026-10-19
+ */
+
+#ifndef HOST_GROWINGARRAY_H
+#define HOST_GROWINGARRAY_H
+
+#include <stddef.h>
+
+
+namespace SimpleDataStructures
+{
+    template <class T>
+    class GrowingArray
+    {
+        T* array = nullptr;
+        size_t allocated = 0;
+        size_t elements = 0;
+
+    public:
+        GrowingArray() = default;
+
+        GrowingArray(const GrowingArray&) = delete;
+        GrowingArray& operator=(const GrowingArray&) = delete;
+
+        ~GrowingArray()
+        {
+            delete[] array;
+        }
+
+        bool add(const T& element)
+        {
+            if (elements == allocated)
+            {
+                size_t newAllocated = allocated == 0 ? 4 : allocated * 2;
+                T* newArray = new T[newAllocated];
+                for (size_t i = 0; i < elements; ++i)
+                    newArray[i] = array[i];
+                delete[] array;
+                array = newArray;
+                allocated = newAllocated;
+            }
+
+            array[elements++] = element;
+            return true;
+        }
+
+        bool remove(size_t index)
+        {
+            if (index >= elements)
+                return false;
+
+            for (size_t i = index + 1; i < elements; ++i)
+                array[i - 1] = array[i];
+            elements--;
+            return true;
+        }
+
+        void clear()
+        {
+            elements = 0;
+        }
+
+        size_t size() const
+        {
+            return elements;
+        }
+
+        bool isEmpty() const
+        {
+            return elements == 0;
+        }
+
+        T& operator[](size_t index)
+        {
+            return array[index];
+        }
+
+        const T& operator[](size_t index) const
+        {
+            return array[index];
+        }
+
+        T& get(size_t index)
+        {
+            return array[index];
+        }
+    };
+}
+
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file BondingTest.cpp
+ * @author Jan Wielgus
+ * @brief BondedComm: redundant frames are received once, striped frames
+ * are received by any link, reordered frames are accepted within the window.
+ * @date 2026-10-19
+ */
+
+#include "Test.h"
+#include "BenchData.h"
+#include "BondedComm.h"
+#include "LoopbackComm.h"
+#include "Encoding/LittleEndian.h"
+#include <set>
+
+using namespace Test;
+using namespace PacketComm;
+
+
+namespace
+{
+    typedef BondedComm<2, 256> Bond;
+    const Packet::PacketIDType RedundantID = 10;
+    const Packet::PacketIDType StripedID = 20;
+    const size_t FramesAmount = 100;
+
+
+    /**
+     * @brief Two bonds connected by two loopback links.
+     */
+    struct BondedPair
+    {
+        LoopbackLink linkA;
+        LoopbackLink linkB;
+        Bond sender;
+        Bond receiver;
+
+        BondedPair()
+        {
+            sender.addLink(&linkA.getEndpointA(), 1);
+            sender.addLink(&linkB.getEndpointA(), 1);
+            receiver.addLink(&linkA.getEndpointB(), 1);
+            receiver.addLink(&linkB.getEndpointB(), 1);
+            sender.addRedundantPacket(RedundantID);
+        }
+    };
+
+
+    /**
+     * @brief Frame with the BondedComm header written by hand (one byte of data).
+     */
+    void sendWithSequence(LoopbackComm& link, uint16_t sequence)
+    {
+        uint8_t frame[Bond::HeaderSize + 1];
+        LittleEndian::writeUInt16(frame, sequence);
+        frame[Bond::HeaderSize] = (uint8_t)sequence;
+        link.send(frame, sizeof(frame));
+    }
+
+    /**
+     * @brief Receive all frames and check that each data is the low byte of its sequence.
+     */
+    bool receiveAll(Bond& receiver, std::vector<uint8_t>& received)
+    {
+        while (receiver.receive())
+        {
+            DataBuffer frame = receiver.getReceived();
+            TEST_CHECK(frame.size == 1);
+            received.push_back(frame.buffer[0]);
+        }
+        return true;
+    }
+
+
+    bool redundantReceivedOnce()
+    {
+        BondedPair bond;
+
+        std::set<std::vector<uint8_t>> sent;
+        for (size_t i = 0; i < FramesAmount; ++i)
+        {
+            std::vector<uint8_t> frame = Bench::makeFrame(RedundantID, 8 + i, i);
+            TEST_CHECK(bond.sender.send(frame.data(), frame.size()));
+            sent.insert(frame);
+        }
+        TEST_CHECK(bond.sender.getLinkSentFramesAmount(0) == FramesAmount);
+        TEST_CHECK(bond.sender.getLinkSentFramesAmount(1) == FramesAmount);
+
+        std::set<std::vector<uint8_t>> received;
+        while (bond.receiver.receive())
+        {
+            DataBuffer frame = bond.receiver.getReceived();
+            TEST_CHECK(received.insert(std::vector<uint8_t>(frame.buffer, frame.buffer + frame.size)).second);
+        }
+
+        TEST_CHECK(received == sent);
+        TEST_CHECK(bond.receiver.getDuplicatesAmount() == FramesAmount);
+        TEST_CHECK(bond.receiver.getTooOldAmount() == 0);
+        return true;
+    }
+
+
+    bool stripedReceivedOnce()
+    {
+        BondedPair bond;
+
+        std::set<std::vector<uint8_t>> sent;
+        for (size_t i = 0; i < FramesAmount; ++i)
+        {
+            std::vector<uint8_t> frame = Bench::makeFrame(StripedID, 8 + i, i);
+            TEST_CHECK(bond.sender.send(frame.data(), frame.size()));
+            sent.insert(frame);
+        }
+        TEST_CHECK(bond.sender.getLinkSentFramesAmount(0) > 0 && bond.sender.getLinkSentFramesAmount(1) > 0);
+        TEST_CHECK(bond.sender.getLinkSentFramesAmount(0) + bond.sender.getLinkSentFramesAmount(1) == FramesAmount);
+
+        std::set<std::vector<uint8_t>> received;
+        while (bond.receiver.receive())
+        {
+            DataBuffer frame = bond.receiver.getReceived();
+            received.insert(std::vector<uint8_t>(frame.buffer, frame.buffer + frame.size));
+        }
+
+        TEST_CHECK(received == sent);
+        TEST_CHECK(bond.receiver.getDuplicatesAmount() == 0);
+        return true;
+    }
+
+
+    /**
+     * @brief Slow link delivers frames that the fast link delivered long ago.
+     */
+    bool reorderWindow()
+    {
+        BondedPair bond;
+        LoopbackComm& fast = bond.linkA.getEndpointA();
+        LoopbackComm& slow = bond.linkB.getEndpointA();
+        std::vector<uint8_t> received;
+
+        // fast link is 50 frames ahead, both links carry frames 50..99
+        for (uint16_t sequence = 50; sequence < 150; ++sequence)
+            sendWithSequence(fast, sequence);
+        TEST_CHECK(receiveAll(bond.receiver, received));
+        for (uint16_t sequence = 0; sequence < 100; ++sequence)
+            sendWithSequence(slow, sequence);
+        TEST_CHECK(receiveAll(bond.receiver, received));
+
+        TEST_CHECK(received.size() == 150);
+        TEST_CHECK(bond.receiver.getDuplicatesAmount() == 50);
+        std::set<uint8_t> unique(received.begin(), received.end());
+        TEST_CHECK(unique.size() == 150);
+
+        // 300 moves the window, 100 behind is still checked, 270 behind is too old
+        sendWithSequence(fast, 300);
+        received.clear();
+        TEST_CHECK(receiveAll(bond.receiver, received));
+        sendWithSequence(slow, 200);
+        sendWithSequence(slow, 200);
+        sendWithSequence(slow, 30);
+        TEST_CHECK(receiveAll(bond.receiver, received));
+        TEST_CHECK(received.size() == 2);
+        TEST_CHECK(received[0] == (uint8_t)300 && received[1] == (uint8_t)200);
+        TEST_CHECK(bond.receiver.getDuplicatesAmount() == 51);
+        TEST_CHECK(bond.receiver.getTooOldAmount() == 1);
+
+        // sequence far from the newest one means that the other side was restarted (0x8000 and 0xFFF0),
+        // then sequence numbers wrap around
+        sendWithSequence(fast, 0x8000);
+        for (uint32_t sequence = 0xFFF0; sequence < 0x10010; ++sequence)
+            sendWithSequence(fast, (uint16_t)sequence);
+        received.clear();
+        TEST_CHECK(receiveAll(bond.receiver, received));
+        TEST_CHECK(received.size() == 1 + 0x20);
+
+        sendWithSequence(slow, 0xFFFF);
+        TEST_CHECK(receiveAll(bond.receiver, received));
+        TEST_CHECK(received.size() == 1 + 0x20);
+        TEST_CHECK(bond.receiver.getDuplicatesAmount() == 52);
+        TEST_CHECK(bond.receiver.getTooOldAmount() == 1);
+        return true;
+    }
+}
+
+
+void Test::registerBondingTests(Suite& suite)
+{
+    suite.add("bonding/redundant_received_once", redundantReceivedOnce);
+    suite.add("bonding/striped_received_once", stripedReceivedOnce);
+    suite.add("bonding/reorder_window", reorderWindow);
+}
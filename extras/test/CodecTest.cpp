@@ -0,0 +1,229 @@
+/**
+ * @file CodecTest.cpp
+ * @author Jan Wielgus
+ * @brief COBS with XOR checksum: direct round trip and StreamComm
+ * over LoopbackStream with fragmented, corrupted and garbage input.
+ * @date 2026-10-19
+ */
+
+#include "Test.h"
+#include "BenchData.h"
+#include "Encoding/COBS.h"
+#include "Encoding/XORChecksum.h"
+#include "LoopbackComm.h"
+#include "StreamComm.h"
+#include <string.h>
+
+using namespace Test;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 300;
+    const size_t FramesAmount = 300;
+
+    uint32_t simulatedTime_us = 0;
+
+    uint32_t getSimulatedTime()
+    {
+        return simulatedTime_us;
+    }
+
+
+    /**
+     * @brief Frame that starts with its number, so the receiver knows what it should contain.
+     */
+    std::vector<uint8_t> makeNumberedFrame(uint16_t number)
+    {
+        size_t size = 2 + (number * 37u) % (MaxBufferSize - 2);
+        std::vector<uint8_t> frame = Bench::makePayload(size, number);
+        frame[0] = (uint8_t)number;
+        frame[1] = (uint8_t)(number >> 8);
+        return frame;
+    }
+
+    /**
+     * @return Number of the frame or -1 if its content is not what was sent.
+     */
+    int checkNumberedFrame(const DataBuffer& frame)
+    {
+        if (frame.size < 2)
+            return -1;
+
+        uint16_t number = frame.buffer[0] | (uint16_t)frame.buffer[1] << 8;
+        std::vector<uint8_t> expected = makeNumberedFrame(number);
+        if (expected.size() != frame.size || memcmp(expected.data(), frame.buffer, frame.size) != 0)
+            return -1;
+        return number;
+    }
+
+
+    bool cobsXorRoundTrip()
+    {
+        const size_t Sizes[] = { 1, 2, 253, 254, 255, 256, 600, 1000 };
+
+        for (size_t size : Sizes)
+        {
+            std::vector<std::vector<uint8_t>> sources = {
+                Bench::makePayload(size, 3),
+                std::vector<uint8_t>(size, 0),
+                std::vector<uint8_t>(size, 0x5A)
+            };
+
+            for (std::vector<uint8_t>& source : sources)
+            {
+                source.push_back(XORChecksum::calculate(source.data(), size));
+
+                std::vector<uint8_t> encoded(COBS::getEncodedBufferSize(source.size()));
+                size_t encodedSize = COBS::encode(source.data(), source.size(), encoded.data());
+                TEST_CHECK(encodedSize > source.size() && encodedSize <= encoded.size());
+                TEST_CHECK(memchr(encoded.data(), 0, encodedSize) == nullptr);
+
+                std::vector<uint8_t> decoded(encodedSize);
+                size_t decodedSize = COBS::decode(encoded.data(), encodedSize, decoded.data());
+                TEST_CHECK(decodedSize == source.size());
+                TEST_CHECK(memcmp(decoded.data(), source.data(), decodedSize) == 0);
+                TEST_CHECK(XORChecksum::check(decoded.data(), size, decoded[size]));
+
+                decoded[size / 2] ^= 0x10;
+                TEST_CHECK(!XORChecksum::check(decoded.data(), size, decoded[size]));
+            }
+        }
+        return true;
+    }
+
+
+    /**
+     * @brief Bytes become available in random chunks (1..7 bytes) spread over the transmission time.
+     */
+    bool streamFragmented()
+    {
+        LinkImpairments impairments;
+        impairments.bandwidth_Bps = 1000000;
+        impairments.maxFragmentSize = 7;
+        impairments.seed = 5;
+
+        LoopbackStreamPair link(impairments);
+        link.getChannelAtoB().setClock(getSimulatedTime);
+        link.getChannelBtoA().setClock(getSimulatedTime);
+        StreamComm<MaxBufferSize, LoopbackStream> sender(&link.getEndpointA());
+        StreamComm<MaxBufferSize, LoopbackStream> receiver(&link.getEndpointB());
+
+        DataBuffer batch[4];
+        size_t received = 0;
+        for (uint16_t i = 0; i < FramesAmount; ++i)
+        {
+            std::vector<uint8_t> frame = makeNumberedFrame(i);
+            TEST_CHECK(sender.send(frame.data(), frame.size()));
+
+            for (size_t step = 0; step < 1000 && received <= i; ++step)
+            {
+                simulatedTime_us += 3;
+                size_t count = receiver.receiveBatch(batch, 4);
+                for (size_t j = 0; j < count; ++j)
+                    TEST_CHECK(checkNumberedFrame(batch[j]) == (int)received++);
+            }
+            TEST_CHECK(received == i + 1u);
+        }
+
+        TEST_CHECK(link.getChannelAtoB().getStatistics().delivered > FramesAmount * 2); // really fragmented
+        return true;
+    }
+
+
+    /**
+     * @brief One random bit of some written chunks is flipped. Corrupted frames are dropped
+     * and the receiver synchronizes on the next marker. The checksum doesn't detect
+     * some changes (eg. of COBS code bytes that only move zeros), they have to be rare.
+     */
+    bool streamCorrupted()
+    {
+        LinkImpairments impairments;
+        impairments.corruptionProbability = 0.05f;
+        impairments.seed = 7;
+
+        LoopbackStreamPair link(impairments);
+        StreamComm<MaxBufferSize, LoopbackStream> sender(&link.getEndpointA());
+        StreamComm<MaxBufferSize, LoopbackStream> receiver(&link.getEndpointB());
+
+        DataBuffer batch[4];
+        size_t received = 0;
+        size_t undetected = 0;
+        int lastNumber = -1;
+        for (uint16_t i = 0; i < FramesAmount; ++i)
+        {
+            std::vector<uint8_t> frame = makeNumberedFrame(i);
+            TEST_CHECK(sender.send(frame.data(), frame.size()));
+
+            size_t count;
+            while ((count = receiver.receiveBatch(batch, 4)) > 0)
+            {
+                for (size_t j = 0; j < count; ++j)
+                {
+                    int number = checkNumberedFrame(batch[j]);
+                    if (number < 0)
+                    {
+                        undetected++;
+                        continue;
+                    }
+
+                    TEST_CHECK(number > lastNumber);
+                    lastNumber = number;
+                    received++;
+                }
+            }
+        }
+
+        const LinkStatistics& statistics = link.getChannelAtoB().getStatistics();
+        TEST_CHECK(statistics.corrupted > 0);
+        TEST_CHECK(received < FramesAmount);
+        TEST_CHECK(received + 2 * statistics.corrupted >= FramesAmount); // corrupted marker joins two frames
+        TEST_CHECK(undetected * 4 <= statistics.corrupted);
+        return true;
+    }
+
+
+    /**
+     * @brief Garbage, empty frames and a frame too big for the receiver are dropped
+     * and don't break the next frame.
+     */
+    bool streamGarbage()
+    {
+        LoopbackStreamPair link;
+        LoopbackStream& wire = link.getEndpointA();
+        StreamComm<MaxBufferSize, LoopbackStream> sender(&wire);
+        StreamComm<MaxBufferSize, LoopbackStream> receiver(&link.getEndpointB());
+
+        std::vector<uint8_t> garbage = Bench::makePayload(50, 11);
+        for (uint8_t& byte : garbage)
+            byte |= 1; // no markers inside
+        wire.write(garbage.data(), garbage.size());
+        wire.write((uint8_t)0);
+        wire.write((uint8_t)0);
+
+        std::vector<uint8_t> tooBig(3 * MaxBufferSize, 0x33);
+        wire.write(tooBig.data(), tooBig.size());
+        wire.write((uint8_t)0);
+
+        std::vector<uint8_t> frame = makeNumberedFrame(42);
+        TEST_CHECK(sender.send(frame.data(), frame.size()));
+
+        DataBuffer batch[4];
+        size_t count = 0;
+        for (size_t attempt = 0; attempt < 10; ++attempt)
+            count += receiver.receiveBatch(batch + count, 4 - count);
+        TEST_CHECK(count == 1);
+        TEST_CHECK(checkNumberedFrame(batch[0]) == 42);
+        return true;
+    }
+}
+
+
+void Test::registerCodecTests(Suite& suite)
+{
+    suite.add("codec/cobs_xor_round_trip", cobsXorRoundTrip);
+    suite.add("codec/stream_fragmented", streamFragmented);
+    suite.add("codec/stream_corrupted", streamCorrupted);
+    suite.add("codec/stream_garbage", streamGarbage);
+}
@@ -0,0 +1,145 @@
+/**
+ * @file DecodeTest.cpp
+ * @author Jan Wielgus
+ * @brief Malformed input to LZ4::decompress() and Packet::readHeader()
+ * (for the configured header format).
+ * @date 2026-10-19
+ */
+
+#include "Test.h"
+#include "BenchData.h"
+#include "Packet.h"
+#include "Encoding/LZ4.h"
+#include <string.h>
+
+using namespace Test;
+using namespace PacketComm;
+
+
+namespace
+{
+    bool lz4RoundTrip()
+    {
+        std::vector<uint8_t> source = Bench::makePayload(1000, 2);
+        memcpy(source.data() + 500, source.data(), 400); // something to match
+
+        LZ4Compressor<8> compressor;
+        std::vector<uint8_t> compressed(LZ4::getMaxCompressedSize(source.size()));
+        size_t compressedSize = compressor.compress(source.data(), source.size(), compressed.data(), compressed.size());
+        TEST_CHECK(compressedSize > 0 && compressedSize < source.size());
+
+        std::vector<uint8_t> decompressed(source.size());
+        TEST_CHECK(LZ4::decompress(compressed.data(), compressedSize, decompressed.data(), decompressed.size()) == source.size());
+        TEST_CHECK(decompressed == source);
+
+        // output buffer too small
+        TEST_CHECK(LZ4::decompress(compressed.data(), compressedSize, decompressed.data(), source.size() - 1) == 0);
+        return true;
+    }
+
+
+    bool lz4Malformed()
+    {
+        uint8_t output[64];
+
+        const uint8_t literalsPastEnd[] = { 0x50, 'a', 'b' };
+        TEST_CHECK(LZ4::decompress(literalsPastEnd, sizeof(literalsPastEnd), output, sizeof(output)) == 0);
+
+        const uint8_t unterminatedLength[] = { 0xF0, 0xFF, 0xFF };
+        TEST_CHECK(LZ4::decompress(unterminatedLength, sizeof(unterminatedLength), output, sizeof(output)) == 0);
+
+        const uint8_t zeroOffset[] = { 0x10, 'a', 0x00, 0x00, 0x00 };
+        TEST_CHECK(LZ4::decompress(zeroOffset, sizeof(zeroOffset), output, sizeof(output)) == 0);
+
+        const uint8_t offsetBeforeOutput[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+        TEST_CHECK(LZ4::decompress(offsetBeforeOutput, sizeof(offsetBeforeOutput), output, sizeof(output)) == 0);
+
+        const uint8_t truncatedOffset[] = { 0x10, 'a', 0x01 };
+        TEST_CHECK(LZ4::decompress(truncatedOffset, sizeof(truncatedOffset), output, sizeof(output)) == 0);
+
+        const uint8_t matchPastCapacity[] = { 0x1F, 'a', 0x01, 0x00, 0xFF, 0x00 }; // 'a' repeated 4 + 15 + 255 times
+        TEST_CHECK(LZ4::decompress(matchPastCapacity, sizeof(matchPastCapacity), output, sizeof(output)) == 0);
+
+        const uint8_t overlappingMatch[] = { 0x15, 'a', 0x01, 0x00, 0x10, 'b' }; // 'a' repeated 1 + 9 times, then 'b'
+        TEST_CHECK(LZ4::decompress(overlappingMatch, sizeof(overlappingMatch), output, sizeof(output)) == 11);
+        TEST_CHECK(output[0] == 'a' && output[9] == 'a' && output[10] == 'b');
+
+        // random changes of a valid block never write past the output buffer
+        std::vector<uint8_t> source = Bench::makePayload(200, 9);
+        memcpy(source.data() + 100, source.data(), 80);
+        LZ4Compressor<8> compressor;
+        std::vector<uint8_t> compressed(LZ4::getMaxCompressedSize(source.size()));
+        size_t compressedSize = compressor.compress(source.data(), source.size(), compressed.data(), compressed.size());
+        TEST_CHECK(compressedSize > 0);
+
+        std::vector<uint8_t> random = Bench::makePayload(3 * 2000, 10);
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            std::vector<uint8_t> changed(compressed.begin(), compressed.begin() + compressedSize);
+            changed[random[3 * i] % compressedSize] ^= random[3 * i + 1] | 1;
+            size_t cut = random[3 * i + 2] % 4 == 0 ? random[3 * i + 2] % compressedSize : compressedSize;
+
+            std::vector<uint8_t> decompressed(source.size());
+            size_t decompressedSize = LZ4::decompress(changed.data(), cut, decompressed.data(), decompressed.size());
+            TEST_CHECK(decompressedSize <= decompressed.size());
+        }
+        return true;
+    }
+
+
+    bool packetHeaderMalformed()
+    {
+        uint8_t buffer[Packet::MaxHeaderSize + 16] = {};
+        Packet::Header header;
+        Packet::PacketIDType id;
+
+        TEST_CHECK(!Packet::readHeader(DataBuffer(buffer, 0), header));
+        TEST_CHECK(!Packet::getIDFromBuffer(buffer, 0, id));
+        if (Packet::MinHeaderSize > 1)
+            TEST_CHECK(!Packet::readHeader(DataBuffer(buffer, Packet::MinHeaderSize - 1), header));
+
+        // valid header with data
+        Packet::Header written;
+        written.id = 200;
+        written.dataSize = 5;
+        written.sequence = 7;
+        size_t headerSize = Packet::writeHeader(buffer, written);
+        TEST_CHECK(headerSize >= Packet::MinHeaderSize && headerSize <= Packet::MaxHeaderSize);
+        TEST_CHECK(Packet::readHeader(DataBuffer(buffer, headerSize + 5), header));
+        TEST_CHECK(header.id == 200 && header.size == headerSize && header.dataSize == 5);
+        TEST_CHECK(Packet::getIDFromBuffer(buffer, headerSize, id) && id == header.id);
+#if PACKETCOMM_HEADER_SEQUENCE
+        TEST_CHECK(header.sequence == 7);
+#endif
+
+#if PACKETCOMM_HEADER_LENGTH
+        // data shorter or longer than the length in the header
+        TEST_CHECK(!Packet::readHeader(DataBuffer(buffer, headerSize + 4), header));
+        TEST_CHECK(!Packet::readHeader(DataBuffer(buffer, headerSize + 6), header));
+#endif
+
+#if PACKETCOMM_HEADER_ID_SIZE == 0
+        // varint ID that doesn't end or is bigger than 16 bits
+        const uint8_t endlessID[] = { 0x80, 0x80, 0x80, 0x80, 0x80 };
+        TEST_CHECK(!Packet::readHeader(DataBuffer(const_cast<uint8_t*>(endlessID), sizeof(endlessID)), header));
+        TEST_CHECK(!Packet::getIDFromBuffer(endlessID, sizeof(endlessID), id));
+        TEST_CHECK(!Packet::getIDFromBuffer(endlessID, 1, id));
+
+        const uint8_t tooBigID[] = { 0xFF, 0xFF, 0x7F, 0, 0, 0 };
+        TEST_CHECK(!Packet::readHeader(DataBuffer(const_cast<uint8_t*>(tooBigID), sizeof(tooBigID)), header));
+#endif
+
+        // header cut at every position
+        for (size_t size = 0; size < headerSize; ++size)
+            TEST_CHECK(!Packet::readHeader(DataBuffer(buffer, size), header));
+        return true;
+    }
+}
+
+
+void Test::registerDecodeTests(Suite& suite)
+{
+    suite.add("decode/lz4_round_trip", lz4RoundTrip);
+    suite.add("decode/lz4_malformed", lz4Malformed);
+    suite.add("decode/packet_header_malformed", packetHeaderMalformed);
+}
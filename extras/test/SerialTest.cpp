@@ -0,0 +1,155 @@
+/**
+ * @file SerialTest.cpp
+ * @author Jan Wielgus
+ * @brief LinuxSerialComm over a pseudo terminal pair: frames in both directions
+ * and bounded waiting for a port that doesn't accept bytes.
+ * @date 2026-10-19
+ */
+
+#include "Test.h"
+#include "BenchData.h"
+#include "LinuxSerialComm.h"
+#include <chrono>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Test;
+using namespace PacketComm;
+
+
+namespace
+{
+    const size_t MaxBufferSize = 256;
+    typedef LinuxSerialComm<MaxBufferSize> SerialComm;
+
+
+    /**
+     * @brief Master side adopts the pty master, slave side opens the pty slave.
+     */
+    struct PtyPair
+    {
+        int masterFd = -1;
+        SerialComm masterSide;
+        SerialComm slaveSide;
+
+        explicit PtyPair(const SerialConfig& config = SerialConfig())
+        {
+            masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+            if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0)
+                return;
+
+            masterSide.adopt(masterFd, config);
+            slaveSide.open(ptsname(masterFd), config);
+        }
+
+        ~PtyPair()
+        {
+            masterSide.close();
+            slaveSide.close();
+            if (masterFd >= 0)
+                ::close(masterFd);
+        }
+
+        bool isReady() const
+        {
+            return masterSide.isOpen() && slaveSide.isOpen();
+        }
+    };
+
+
+    std::vector<uint8_t> makeFrame(size_t number)
+    {
+        return Bench::makePayload(1 + number * 41 % MaxBufferSize, number);
+    }
+
+    /**
+     * @brief Receive frames number first..first+amount-1 (waits up to 1 s for each).
+     */
+    bool receiveFrames(SerialComm& receiver, size_t first, size_t amount)
+    {
+        DataBuffer batch[PACKETCOMM_RECEIVE_BATCH_SIZE];
+        size_t received = 0;
+        while (received < amount)
+        {
+            size_t count = receiver.receiveBatch(batch, PACKETCOMM_RECEIVE_BATCH_SIZE);
+            if (count == 0)
+            {
+                pollfd pfd = { receiver.getFileDescriptor(), POLLIN, 0 };
+                TEST_CHECK(::poll(&pfd, 1, 1000) > 0);
+                continue;
+            }
+
+            for (size_t i = 0; i < count; ++i, ++received)
+            {
+                std::vector<uint8_t> expected = makeFrame(first + received);
+                TEST_CHECK(batch[i].size == expected.size());
+                TEST_CHECK(memcmp(batch[i].buffer, expected.data(), expected.size()) == 0);
+            }
+        }
+        return true;
+    }
+
+
+    bool ptyRoundTrip()
+    {
+        PtyPair pty;
+        TEST_CHECK(pty.isReady());
+
+        const size_t Bursts = 20;
+        const size_t BurstFrames = 16;
+        size_t number = 0;
+        for (size_t burst = 0; burst < Bursts; ++burst)
+        {
+            SerialComm& sender = burst % 2 == 0 ? pty.masterSide : pty.slaveSide;
+            SerialComm& receiver = burst % 2 == 0 ? pty.slaveSide : pty.masterSide;
+
+            for (size_t i = 0; i < BurstFrames; ++i)
+            {
+                std::vector<uint8_t> frame = makeFrame(number + i);
+                TEST_CHECK(sender.send(frame.data(), frame.size()));
+            }
+            TEST_CHECK(sender.getPendingSendSize() == 0);
+
+            TEST_CHECK(receiveFrames(receiver, number, BurstFrames));
+            number += BurstFrames;
+        }
+
+        DataBuffer frame;
+        TEST_CHECK(pty.masterSide.receiveBatch(&frame, 1) == 0);
+        TEST_CHECK(pty.slaveSide.receiveBatch(&frame, 1) == 0);
+        return true;
+    }
+
+
+    /**
+     * @brief Slave side never reads, so sending fails after writeTimeout_ms
+     * when the pty buffer is full (instead of blocking forever).
+     */
+    bool writeTimeout()
+    {
+        SerialConfig config;
+        config.writeTimeout_ms = 20;
+        config.writeBufferSize = 1024;
+        PtyPair pty(config);
+        TEST_CHECK(pty.isReady());
+
+        std::vector<uint8_t> frame = makeFrame(MaxBufferSize - 1);
+        auto start = std::chrono::steady_clock::now();
+        size_t sentFrames = 0;
+        while (pty.masterSide.send(frame.data(), frame.size()))
+            TEST_CHECK(++sentFrames < 100000);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        TEST_CHECK(sentFrames > 0);
+        TEST_CHECK(elapsed < std::chrono::seconds(5));
+        return true;
+    }
+}
+
+
+void Test::registerSerialTests(Suite& suite)
+{
+    suite.add("serial/pty_round_trip", ptyRoundTrip);
+    suite.add("serial/write_timeout", writeTimeout);
+}
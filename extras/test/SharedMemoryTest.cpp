@@ -0,0 +1,139 @@
+/**
+ * @file SharedMemoryTest.cpp
+ * @author Jan Wielgus
+ * @brief SharedMemoryComm: records that don't fit before the end of the ring
+ * are placed after padding at its beginning, full ring rejects frames.
+ * @date 2026-10-19
+ */
+
+#include "Test.h"
+#include "BenchData.h"
+#include "SharedMemoryComm.h"
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+using namespace Test;
+using namespace PacketComm;
+
+
+namespace
+{
+    int segmentCounter = 0;
+
+    /**
+     * @brief Create connected pair of SharedMemoryComm (segment name is removed immediately).
+     */
+    bool connectPair(SharedMemoryComm& sideA, SharedMemoryComm& sideB, size_t ringCapacity)
+    {
+        std::string name = "/packetcomm_test_" + std::to_string(getpid()) + "_" + std::to_string(segmentCounter++);
+        bool result = sideA.create(name.c_str(), ringCapacity) && sideB.open(name.c_str());
+        SharedMemoryComm::unlink(name.c_str());
+        return result;
+    }
+
+    bool isFrame(const DataBuffer& received, const std::vector<uint8_t>& expected)
+    {
+        return received.size == expected.size() && memcmp(received.buffer, expected.data(), expected.size()) == 0;
+    }
+
+
+    bool paddingAtRingEnd()
+    {
+        SharedMemoryComm sideA, sideB;
+        TEST_CHECK(connectPair(sideA, sideB, 256));
+        TEST_CHECK(sideA.getMaxFrameSize() == 120);
+
+        // two records of 112 bytes, 32 bytes are left before the end of the ring
+        std::vector<uint8_t> first = Bench::makePayload(100, 1);
+        std::vector<uint8_t> second = Bench::makePayload(100, 2);
+        TEST_CHECK(sideA.send(first.data(), first.size()));
+        TEST_CHECK(sideA.send(second.data(), second.size()));
+
+        TEST_CHECK(sideB.receive() && isFrame(sideB.getReceived(), first));
+        const uint8_t* ringStart = sideB.getReceived().buffer;
+        TEST_CHECK(sideB.receive() && isFrame(sideB.getReceived(), second));
+
+        // third record doesn't fit before the end, it is placed at the beginning (first one was released)
+        std::vector<uint8_t> third = Bench::makePayload(100, 3);
+        TEST_CHECK(sideA.send(third.data(), third.size()));
+        TEST_CHECK(isFrame(sideB.getReceived(), second));
+
+        TEST_CHECK(sideB.receive() && isFrame(sideB.getReceived(), third));
+        TEST_CHECK(sideB.getReceived().buffer == ringStart); // padding was skipped
+
+        // ring is full until the third one is released
+        std::vector<uint8_t> fourth = Bench::makePayload(120, 4);
+        TEST_CHECK(sideA.reserveSendBuffer(fourth.size()).buffer == nullptr);
+        TEST_CHECK(!sideB.receive());
+
+        // zero-copy record after the third one
+        DataBuffer reserved = sideA.reserveSendBuffer(fourth.size());
+        TEST_CHECK(reserved.buffer != nullptr && reserved.size >= fourth.size());
+        memcpy(reserved.buffer, fourth.data(), fourth.size());
+        TEST_CHECK(sideA.commitSendBuffer(fourth.size()));
+        TEST_CHECK(sideB.receive() && isFrame(sideB.getReceived(), fourth));
+
+        TEST_CHECK(!sideA.send(fourth.data(), sideA.getMaxFrameSize() + 1));
+        TEST_CHECK(sideB.getInvalidRecordsAmount() == 0);
+        return true;
+    }
+
+
+    /**
+     * @brief Frames of many sizes are sent until the ring is full, then received
+     * (in batches and one by one), many times around the ring.
+     */
+    bool ringWrap()
+    {
+        SharedMemoryComm sideA, sideB;
+        TEST_CHECK(connectPair(sideA, sideB, 1024));
+
+        const size_t FramesAmount = 3000;
+        size_t maxFrameSize = sideA.getMaxFrameSize();
+        size_t sent = 0;
+        size_t received = 0;
+        size_t fullRing = 0;
+        DataBuffer batch[8];
+
+        while (received < FramesAmount)
+        {
+            while (sent < FramesAmount)
+            {
+                std::vector<uint8_t> frame = Bench::makePayload(1 + sent * 53 % maxFrameSize, sent);
+                if (!sideA.send(frame.data(), frame.size()))
+                {
+                    fullRing++;
+                    break;
+                }
+                sent++;
+            }
+
+            size_t count = 0;
+            if (received % 2 == 0)
+                count = sideB.receiveBatch(batch, 8);
+            else if (sideB.receive())
+            {
+                batch[0] = sideB.getReceived();
+                count = 1;
+            }
+            TEST_CHECK(count > 0 || received == sent); // received frames take space until the next call
+
+            for (size_t i = 0; i < count; ++i, ++received)
+                TEST_CHECK(isFrame(batch[i], Bench::makePayload(1 + received * 53 % maxFrameSize, received)));
+        }
+
+        TEST_CHECK(sent == FramesAmount);
+        TEST_CHECK(fullRing > 100);
+        TEST_CHECK(!sideB.receive());
+        TEST_CHECK(sideB.getInvalidRecordsAmount() == 0);
+        return true;
+    }
+}
+
+
+void Test::registerSharedMemoryTests(Suite& suite)
+{
+    suite.add("shm/padding_at_ring_end", paddingAtRingEnd);
+    suite.add("shm/ring_wrap", ringWrap);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Test.h
+ * @author Jan Wielgus
+ * @brief Tiny test harness for the host build (run by ctest).
+ * Each case returns false at the first failed TEST_CHECK(),
+ * which prints the file, line and the failed condition.
+ * @date 2026-10-19
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+#define TEST_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            return false; \
+        } \
+    } while (0)
+
+
+namespace Test
+{
+    struct Case
+    {
+        std::string name;
+        std::function<bool()> body; // returns false if any check failed
+    };
+
+
+    class Suite
+    {
+        std::vector<Case> cases;
+
+    public:
+        /**
+         * @brief Add new test case.
+         * @param name Unique name (used also for filtering, eg. "codec/cobs_round_trip").
+         * @param body Test function (use TEST_CHECK() inside).
+         */
+        void add(std::string name, std::function<bool()> body)
+        {
+            cases.push_back(Case{ std::move(name), std::move(body) });
+        }
+
+        /**
+         * @brief Run all cases whose name contains filter and print their results.
+         * @param filter Substring of the case name (empty - all cases).
+         * @return Amount of failed cases (-1 if no case matches the filter).
+         */
+        int run(const std::string& filter) const;
+    };
+
+
+    void registerCodecTests(Suite& suite);
+    void registerDecodeTests(Suite& suite);
+    void registerBondingTests(Suite& suite);
+    void registerSharedMemoryTests(Suite& suite);
+    void registerSerialTests(Suite& suite);
+}
+
+
+#endif
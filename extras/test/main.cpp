@@ -0,0 +1,55 @@
+/**
+ * @file main.cpp
+ * @author Jan Wielgus
+ * @brief Host tests of the library.
+ * Usage: packetcomm_test [name filter]
+ * @date 2026-10-19
+ */
+
+#include "Test.h"
+
+using namespace Test;
+
+
+int Suite::run(const std::string& filter) const
+{
+    int executed = 0;
+    int failed = 0;
+
+    for (const Case& c : cases)
+    {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos)
+            continue;
+
+        bool passed = c.body();
+        printf("%-48s %s\n", c.name.c_str(), passed ? "passed" : "FAILED");
+        fflush(stdout);
+
+        executed++;
+        if (!passed)
+            failed++;
+    }
+
+    return executed > 0 ? failed : -1;
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    Suite suite;
+    registerCodecTests(suite);
+    registerDecodeTests(suite);
+    registerBondingTests(suite);
+    registerSharedMemoryTests(suite);
+    registerSerialTests(suite);
+
+    int failed = suite.run(filter);
+    if (failed < 0)
+        printf("no test matches \"%s\"\n", filter.c_str());
+    else
+        printf("%d failed\n", failed);
+    return failed == 0 ? 0 : 1;
+}